@@ -46,6 +46,7 @@
 //////////////////////////////////////////////////////////////////////////////////
 
 #include <assert.h>
+#include <string.h>
 #include "memory_map.h"
 #include "xil_printf.h"
 
@@ -56,9 +57,15 @@ P_VIRTUAL_DIE_MAP virtualDieMapPtr;
 P_PHY_BLOCK_MAP phyBlockMapPtr;
 P_BAD_BLOCK_TABLE_INFO_MAP bbtInfoMapPtr;
 
-unsigned char sliceAllocationTargetDie;
+NAMESPACE_DIE_MAP namespaceDieMap;
+GROWN_BAD_BLOCK_QUEUE grownBadBlockQ;
+LAZY_ERASE_MAP lazyEraseMap;
 unsigned int mbPerbadBlockSpace;
 
+//next spare block of each LUN, kept after boot for remapping grown bad blocks
+unsigned int reservedBlockOfLun0[USER_DIES];
+unsigned int reservedBlockOfLun1[USER_DIES];
+
 
 void InitAddressMap()
 {
@@ -81,27 +88,109 @@ void InitAddressMap()
 		bbtInfoMapPtr->bbtInfo[dieNo].grownBadUpdate = BBT_INFO_GROWN_BAD_UPDATE_NONE;
 	}
 
-	sliceAllocationTargetDie = FindDieForFreeSliceAllocation();
-
+	InitNamespaceDieMap();
 	InitSliceMap();
+	EndInitStep("physical block and slice map");
 	InitBlockDieMap();
 }
 
-void InitSliceMap()
+void InitNamespaceDieMap()
 {
-	int sliceAddr;
-	for(sliceAddr=0; sliceAddr<SLICES_PER_SSD ; sliceAddr++)
+	unsigned int nsIdx;
+
+	//every namespace shares all dies by default
+	for(nsIdx = 0; nsIdx < USER_NAMESPACES; nsIdx++)
 	{
-		logicalSliceMapPtr->logicalSlice[sliceAddr].virtualSliceAddr = VSA_NONE;
-		virtualSliceMapPtr->virtualSlice[sliceAddr].logicalSliceAddr = LSA_NONE;
+		namespaceDieMap.ns[nsIdx].chMask = (1 << USER_CHANNELS) - 1;
+		namespaceDieMap.ns[nsIdx].wayMask = (1 << USER_WAYS) - 1;
+		namespaceDieMap.ns[nsIdx].targetCh = 0;
+		namespaceDieMap.ns[nsIdx].targetWay = 0;
 	}
 }
 
+unsigned int CountNamespaceDies(unsigned int chMask, unsigned int wayMask)
+{
+	unsigned int chNo, wayNo, chCnt, wayCnt;
+
+	chCnt = 0;
+	for(chNo = 0; chNo < USER_CHANNELS; chNo++)
+		if(chMask & (1 << chNo))
+			chCnt++;
+
+	wayCnt = 0;
+	for(wayNo = 0; wayNo < USER_WAYS; wayNo++)
+		if(wayMask & (1 << wayNo))
+			wayCnt++;
+
+	return chCnt * wayCnt;
+}
+
+unsigned int SetNamespaceDieMap(unsigned int nsIdx, unsigned int chMask, unsigned int wayMask)
+{
+	unsigned int nsChMask[USER_NAMESPACES], nsWayMask[USER_NAMESPACES];
+	unsigned int nsSet, idx, dieNo, nsCnt, dieCnt;
+
+	if((nsIdx >= USER_NAMESPACES) || (chMask & ~((1 << USER_CHANNELS) - 1)) || (wayMask & ~((1 << USER_WAYS) - 1)))
+		return 0;
+	if(CountNamespaceDies(chMask, wayMask) == 0)
+		return 0;
+
+	for(idx = 0; idx < USER_NAMESPACES; idx++)
+	{
+		nsChMask[idx] = namespaceDieMap.ns[idx].chMask;
+		nsWayMask[idx] = namespaceDieMap.ns[idx].wayMask;
+	}
+	nsChMask[nsIdx] = chMask;
+	nsWayMask[nsIdx] = wayMask;
+
+	//a namespace holds an equal share of the capacity, namespaces sharing dies place their data around each other,
+	//so the map is admitted when every set of namespaces fits in the dies the set can use together
+	for(nsSet = 1; nsSet < (1 << USER_NAMESPACES); nsSet++)
+	{
+		nsCnt = 0;
+		for(idx = 0; idx < USER_NAMESPACES; idx++)
+			if(nsSet & (1 << idx))
+				nsCnt++;
+
+		dieCnt = 0;
+		for(dieNo = 0; dieNo < USER_DIES; dieNo++)
+			for(idx = 0; idx < USER_NAMESPACES; idx++)
+				if((nsSet & (1 << idx)) && (nsChMask[idx] & (1 << Vdie2PchTranslation(dieNo))) && (nsWayMask[idx] & (1 << Vdie2PwayTranslation(dieNo))))
+				{
+					dieCnt++;
+					break;
+				}
+
+		if(nsCnt * USER_DIES > dieCnt * USER_NAMESPACES)
+			return 0;
+	}
+
+	namespaceDieMap.ns[nsIdx].chMask = chMask;
+	namespaceDieMap.ns[nsIdx].wayMask = wayMask;
+
+	xil_printf("namespace %d die map: channel 0x%x, way 0x%x\r\n", nsIdx + 1, chMask, wayMask);
+
+	return 1;
+}
+
+void InitSliceMap()
+{
+	//the virtual slices of a block are reset when the block leaves the free block list,
+	//a logical slice is only trusted when its virtual slice maps back to it
+	memset(logicalSliceMapPtr, 0xFF, sizeof(LOGICAL_SLICE_MAP));	//VSA_NONE
+}
+
+void ResetVirtualSliceMapOfBlock(unsigned int dieNo, unsigned int blockNo)
+{
+	unsigned int pageNo;
+
+	for(pageNo=0; pageNo<USER_PAGES_PER_BLOCK; pageNo++)
+		virtualSliceMapPtr->virtualSlice[Vorg2VsaTranslation(dieNo, blockNo, pageNo)].logicalSliceAddr = LSA_NONE;
+}
+
 void RemapBadBlock()
 {
 	unsigned int blockNo, dieNo, remapFlag, maxBadBlockCount;
-	unsigned int reservedBlockOfLun0[USER_DIES];
-	unsigned int reservedBlockOfLun1[USER_DIES];
 	unsigned int badBlockCount[USER_DIES];
 
 	xil_printf("Bad block remapping start...\r\n");
@@ -229,11 +318,14 @@ void InitBlockMap()
 			virtualBlockMapPtr->block[dieNo][virtualBlockNo].bad = phyBlockMapPtr->phyBlock[dieNo][remappedPhyBlock].bad;
 
 			virtualBlockMapPtr->block[dieNo][virtualBlockNo].free = 1;
+			virtualBlockMapPtr->block[dieNo][virtualBlockNo].dirty = 0;
+			virtualBlockMapPtr->block[dieNo][virtualBlockNo].zone = 0;
 			virtualBlockMapPtr->block[dieNo][virtualBlockNo].invalidSliceCnt = 0;
 			virtualBlockMapPtr->block[dieNo][virtualBlockNo].currentPage = 0;
 			virtualBlockMapPtr->block[dieNo][virtualBlockNo].eraseCnt = 0;
 
-			if(virtualBlockMapPtr->block[dieNo][virtualBlockNo].bad)
+			//blocks of physical address I/O never enter the free block list
+			if(virtualBlockMapPtr->block[dieNo][virtualBlockNo].bad || (virtualBlockNo >= FTL_BLOCKS_PER_DIE))
 			{
 				virtualBlockMapPtr->block[dieNo][virtualBlockNo].prevBlock = BLOCK_NONE;
 				virtualBlockMapPtr->block[dieNo][virtualBlockNo].nextBlock = BLOCK_NONE;
@@ -298,102 +390,131 @@ void ReadBadBlockTable(unsigned int tempBbtBufAddr[], unsigned int tempBbtBufEnt
 	SyncAllLowLevelReqDone();
 }
 
+void IssueBadBlockMarkRead(unsigned int dieNo, unsigned int phyBlockNo, unsigned int phyPageNo, unsigned int bufAddr)
+{
+	unsigned int reqSlotTag;
+
+	reqSlotTag = GetFromFreeReqQ();
+
+	reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
+	reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_ADDR;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_PHY_ORG;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_OFF;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_NONE;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_TOTAL;
+
+	reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.addr = bufAddr;
+
+	reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalCh = Vdie2PchTranslation(dieNo);
+	reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalWay = Vdie2PwayTranslation(dieNo);
+	reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalBlock = phyBlockNo;
+	reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalPage = phyPageNo;
+
+	SelectLowLevelReqQ(reqSlotTag);
+}
+
 void FindBadBlock(unsigned char dieState[], unsigned int tempBbtBufAddr[], unsigned int tempBbtBufEntrySize, unsigned int tempReadBufAddr[], unsigned int tempReadBufEntrySize)
 {
-	unsigned int phyBlockNo, dieNo, reqSlotTag;
-	unsigned char blockChecker[USER_DIES];
+	unsigned int phyBlockNo, dieNo, chNo, wayNo, slotNo, doneCnt, scanningDieCnt;
+	unsigned char blockChecker;
 	unsigned char* markPointer0;
 	unsigned char* markPointer1;
 	unsigned char* bbtUpdater;
+	BAD_BLOCK_SCAN_DIE scanDie[USER_DIES];
 
-	//check bad block mark of each block
-	for(phyBlockNo = 0; phyBlockNo < TOTAL_BLOCKS_PER_DIE; phyBlockNo++)
+	scanningDieCnt = 0;
+	for(dieNo=0; dieNo < USER_DIES; dieNo++)
 	{
-		for(dieNo=0; dieNo < USER_DIES; dieNo++)
-			if(!dieState[dieNo])
-			{
-				blockChecker[dieNo] = BLOCK_STATE_NORMAL;
-
-				reqSlotTag = GetFromFreeReqQ();
+		for(slotNo=0; slotNo < BOOT_SCAN_REQ_DEPTH_PER_DIE; slotNo++)
+			scanDie[dieNo].freeSlot[slotNo] = slotNo;
 
-				reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
-				reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
-				reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_ADDR;
-				reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_PHY_ORG;
-				reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_OFF;
-				reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
-				reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_NONE;
-				reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_TOTAL;
+		scanDie[dieNo].issuedHead = 0;
+		scanDie[dieNo].issuedCnt = 0;
+		scanDie[dieNo].freeCnt = BOOT_SCAN_REQ_DEPTH_PER_DIE;
+		scanDie[dieNo].nextPhyBlock = 0;
 
-				reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.addr = tempReadBufAddr[dieNo];
-
-				reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalCh = Vdie2PchTranslation(dieNo);
-				reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalWay = Vdie2PwayTranslation(dieNo);
-				reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalBlock = phyBlockNo;
-				reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalPage = BAD_BLOCK_MARK_PAGE0;
+		if(!dieState[dieNo])
+			scanningDieCnt++;
+	}
 
-				SelectLowLevelReqQ(reqSlotTag);
-			}
+	//each die walks its own blocks, a new mark page read is issued as soon as a buffer slot of the die is released
+	while(scanningDieCnt)
+	{
+		for(dieNo=0; dieNo < USER_DIES; dieNo++)
+		{
+			if(dieState[dieNo] || (scanDie[dieNo].nextPhyBlock > TOTAL_BLOCKS_PER_DIE))
+				continue;
 
-		SyncAllLowLevelReqDone();
+			chNo = Vdie2PchTranslation(dieNo);
+			wayNo = Vdie2PwayTranslation(dieNo);
 
-		for(dieNo=0; dieNo < USER_DIES; dieNo++)
-			if(!dieState[dieNo])
+			//requests of a die complete in order, so the ones no longer in the nand request queue are done
+			doneCnt = scanDie[dieNo].issuedCnt - nandReqQ[chNo][wayNo].reqCnt;
+			while(doneCnt)
 			{
-				markPointer0 = (unsigned char*)(tempReadBufAddr[dieNo] + BAD_BLOCK_MARK_BYTE0);
-				markPointer1 = (unsigned char*)(tempReadBufAddr[dieNo] + BAD_BLOCK_MARK_BYTE1);
+				slotNo = scanDie[dieNo].issuedSlot[scanDie[dieNo].issuedHead];
+				scanDie[dieNo].issuedHead = (scanDie[dieNo].issuedHead + 1) % BOOT_SCAN_REQ_DEPTH_PER_DIE;
+				scanDie[dieNo].issuedCnt--;
+				doneCnt--;
+
+				phyBlockNo = scanDie[dieNo].phyBlock[slotNo];
+				markPointer0 = (unsigned char*)(tempReadBufAddr[dieNo] + slotNo * tempReadBufEntrySize + BAD_BLOCK_MARK_BYTE0);
+				markPointer1 = (unsigned char*)(tempReadBufAddr[dieNo] + slotNo * tempReadBufEntrySize + BAD_BLOCK_MARK_BYTE1);
 
 				if((*markPointer0 == CLEAN_DATA_IN_BYTE) && (*markPointer1 == CLEAN_DATA_IN_BYTE))
 				{
-					reqSlotTag = GetFromFreeReqQ();
-
-					reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
-					reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_ADDR;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_PHY_ORG;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_OFF;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_NONE;
-					reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_TOTAL;
-
-					reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.addr = tempReadBufAddr[dieNo];
-
-					reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalCh = Vdie2PchTranslation(dieNo);
-					reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalWay = Vdie2PwayTranslation(dieNo);
-					reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalBlock = phyBlockNo;
-					reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalPage = BAD_BLOCK_MARK_PAGE1;
+					if(scanDie[dieNo].markPage[slotNo] == BAD_BLOCK_MARK_PAGE0)
+					{
+						//the second mark page is read into the same slot
+						scanDie[dieNo].markPage[slotNo] = BAD_BLOCK_MARK_PAGE1;
+						scanDie[dieNo].issuedSlot[(scanDie[dieNo].issuedHead + scanDie[dieNo].issuedCnt) % BOOT_SCAN_REQ_DEPTH_PER_DIE] = slotNo;
+						scanDie[dieNo].issuedCnt++;
+						IssueBadBlockMarkRead(dieNo, phyBlockNo, BAD_BLOCK_MARK_PAGE1, tempReadBufAddr[dieNo] + slotNo * tempReadBufEntrySize);
+						continue;
+					}
 
-					SelectLowLevelReqQ(reqSlotTag);
+					blockChecker = BLOCK_STATE_NORMAL;
 				}
 				else
 				{
-					xil_printf("	bad block is detected: Ch %d Way %d phyBlock %d \r\n",Vdie2PchTranslation(dieNo), Vdie2PwayTranslation(dieNo), phyBlockNo);
+					xil_printf("	bad block is detected: Ch %d Way %d phyBlock %d \r\n", chNo, wayNo, phyBlockNo);
 
-					blockChecker[dieNo] = BLOCK_STATE_BAD;
+					blockChecker = BLOCK_STATE_BAD;
 				}
-			}
 
-		SyncAllLowLevelReqDone();
+				bbtUpdater= (unsigned char*)(tempBbtBufAddr[dieNo] + phyBlockNo);
+				*bbtUpdater = blockChecker;
+				phyBlockMapPtr->phyBlock[dieNo][phyBlockNo].bad = blockChecker;
 
-		for(dieNo=0; dieNo < USER_DIES; dieNo++)
-			if(!dieState[dieNo])
-			{
-				markPointer0 = (unsigned char*)(tempReadBufAddr[dieNo] + BAD_BLOCK_MARK_BYTE0);
-				markPointer1 = (unsigned char*)(tempReadBufAddr[dieNo] + BAD_BLOCK_MARK_BYTE1);
+				scanDie[dieNo].freeSlot[scanDie[dieNo].freeCnt] = slotNo;
+				scanDie[dieNo].freeCnt++;
+			}
 
-				if(!((*markPointer0 == CLEAN_DATA_IN_BYTE) && (*markPointer1 == CLEAN_DATA_IN_BYTE)))
-					if(blockChecker[dieNo] == BLOCK_STATE_NORMAL)
-					{
-						xil_printf("	bad block is detected: Ch %d Way %d phyBlock %d \r\n",Vdie2PchTranslation(dieNo), Vdie2PwayTranslation(dieNo), phyBlockNo);
+			while(scanDie[dieNo].freeCnt && (scanDie[dieNo].nextPhyBlock < TOTAL_BLOCKS_PER_DIE))
+			{
+				scanDie[dieNo].freeCnt--;
+				slotNo = scanDie[dieNo].freeSlot[scanDie[dieNo].freeCnt];
 
-						blockChecker[dieNo] = BLOCK_STATE_BAD;
+				scanDie[dieNo].phyBlock[slotNo] = scanDie[dieNo].nextPhyBlock;
+				scanDie[dieNo].markPage[slotNo] = BAD_BLOCK_MARK_PAGE0;
+				scanDie[dieNo].issuedSlot[(scanDie[dieNo].issuedHead + scanDie[dieNo].issuedCnt) % BOOT_SCAN_REQ_DEPTH_PER_DIE] = slotNo;
+				scanDie[dieNo].issuedCnt++;
+				IssueBadBlockMarkRead(dieNo, scanDie[dieNo].nextPhyBlock, BAD_BLOCK_MARK_PAGE0, tempReadBufAddr[dieNo] + slotNo * tempReadBufEntrySize);
 
-					}
+				scanDie[dieNo].nextPhyBlock++;
+			}
 
-				bbtUpdater= (unsigned char*)(tempBbtBufAddr[dieNo] + phyBlockNo);
-				*bbtUpdater = blockChecker[dieNo];
-				phyBlockMapPtr->phyBlock[dieNo][phyBlockNo].bad = blockChecker[dieNo];
+			//the cursor steps past the last block once every block of the die is checked
+			if((scanDie[dieNo].nextPhyBlock == TOTAL_BLOCKS_PER_DIE) && !scanDie[dieNo].issuedCnt)
+			{
+				scanDie[dieNo].nextPhyBlock++;
+				scanningDieCnt--;
 			}
+		}
+
+		SchedulingNandReq();
 	}
 }
 
@@ -482,7 +603,7 @@ void RecoverBadBlockTable(unsigned int tempBufAddr)
 	for(dieNo = 0; dieNo < USER_DIES; dieNo++)
 	{
 		tempBbtBufAddr[dieNo] = tempBbtBufBaseAddr + dieNo * USED_PAGES_FOR_BAD_BLOCK_TABLE_PER_DIE * tempBbtBufEntrySize;
-		tempReadBufAddr[dieNo] = tempReadBufBaseAddr + dieNo * tempReadBufEntrySize;
+		tempReadBufAddr[dieNo] = tempReadBufBaseAddr + dieNo * BOOT_SCAN_REQ_DEPTH_PER_DIE * tempReadBufEntrySize;
 	}
 
 	//read bad block tables
@@ -534,30 +655,51 @@ void RecoverBadBlockTable(unsigned int tempBufAddr)
 
 void EraseTotalBlockSpace()
 {
-	unsigned int blockNo, dieNo, reqSlotTag;
+	unsigned int blockNo, dieNo, reqSlotTag, erasingDieCnt;
+	unsigned int nextBlock[USER_DIES];
 
 	xil_printf("Erase total block space...wait for a minute...\r\n");
 
-	for(blockNo=0 ; blockNo<TOTAL_BLOCKS_PER_DIE ; blockNo++)
+	for(dieNo=0 ; dieNo<USER_DIES ; dieNo++)
+		nextBlock[dieNo] = 0;
+
+	//each die keeps a few erases queued on its own cursor, a die does not wait for request slots held by slower dies
+	erasingDieCnt = USER_DIES;
+	while(erasingDieCnt)
+	{
 		for(dieNo=0 ; dieNo<USER_DIES ; dieNo++)
 		{
-			reqSlotTag = GetFromFreeReqQ();
+			if(nextBlock[dieNo] == TOTAL_BLOCKS_PER_DIE)
+				continue;
 
-			reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
-			reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_ERASE;
-			reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_PHY_ORG;
-			reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_NONE;
-			reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_NONE;
-			reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_TOTAL;
+			while((nandReqQ[Vdie2PchTranslation(dieNo)][Vdie2PwayTranslation(dieNo)].reqCnt < BOOT_SCAN_REQ_DEPTH_PER_DIE) && (nextBlock[dieNo] < TOTAL_BLOCKS_PER_DIE))
+			{
+				blockNo = nextBlock[dieNo];
+				reqSlotTag = GetFromFreeReqQ();
 
-			reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalCh = Vdie2PchTranslation(dieNo);
-			reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalWay = Vdie2PwayTranslation(dieNo);
-			reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalBlock = blockNo;
-			reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalPage = 0;
+				reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
+				reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_ERASE;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_PHY_ORG;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_NONE;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_NONE;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_TOTAL;
 
-			SelectLowLevelReqQ(reqSlotTag);
+				reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalCh = Vdie2PchTranslation(dieNo);
+				reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalWay = Vdie2PwayTranslation(dieNo);
+				reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalBlock = blockNo;
+				reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalPage = 0;
+
+				SelectLowLevelReqQ(reqSlotTag);
+
+				nextBlock[dieNo]++;
+			}
+
+			if(nextBlock[dieNo] == TOTAL_BLOCKS_PER_DIE)
+				erasingDieCnt--;
 		}
 
+		SchedulingNandReq();
+	}
 
 	SyncAllLowLevelReqDone();
 	xil_printf("Done.\r\n");
@@ -566,14 +708,30 @@ void EraseTotalBlockSpace()
 
 void EraseUserBlockSpace()
 {
-	unsigned int blockNo, dieNo, reqSlotTag;
+	unsigned int blockNo, dieNo, reqSlotTag, erasingDieCnt;
+	unsigned int nextBlock[USER_DIES];
 
 	xil_printf("Erase User block space...wait for a minute...\r\n");
 
-	for(blockNo=0 ; blockNo<USER_BLOCKS_PER_DIE ; blockNo++)
+	for(dieNo=0 ; dieNo<USER_DIES ; dieNo++)
+		nextBlock[dieNo] = 0;
+
+	erasingDieCnt = USER_DIES;
+	while(erasingDieCnt)
+	{
 		for(dieNo=0 ; dieNo<USER_DIES ; dieNo++)
-			if(!virtualBlockMapPtr->block[dieNo][blockNo].bad)
+		{
+			if(nextBlock[dieNo] == USER_BLOCKS_PER_DIE)
+				continue;
+
+			while((nandReqQ[Vdie2PchTranslation(dieNo)][Vdie2PwayTranslation(dieNo)].reqCnt < BOOT_SCAN_REQ_DEPTH_PER_DIE) && (nextBlock[dieNo] < USER_BLOCKS_PER_DIE))
 			{
+				blockNo = nextBlock[dieNo];
+				nextBlock[dieNo]++;
+
+				if(virtualBlockMapPtr->block[dieNo][blockNo].bad)
+					continue;
+
 				reqSlotTag = GetFromFreeReqQ();
 
 				reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
@@ -588,6 +746,13 @@ void EraseUserBlockSpace()
 				SelectLowLevelReqQ(reqSlotTag);
 			}
 
+			if(nextBlock[dieNo] == USER_BLOCKS_PER_DIE)
+				erasingDieCnt--;
+		}
+
+		SchedulingNandReq();
+	}
+
 	SyncAllLowLevelReqDone();
 	xil_printf("Done.\r\n");
 }
@@ -597,9 +762,14 @@ void InitBlockDieMap()
 {
 	unsigned int dieNo;
 	unsigned char eraseFlag = 1;
+	char keyInput;
 
 	xil_printf("Press 'X' to re-make the bad block table.\r\n");
-	if (inbyte() == 'X')
+	keyInput = inbyte();
+
+	//the boot time breakdown does not count the wait for the key
+	StartInitStep();
+	if (keyInput == 'X')
 	{
 		EraseTotalBlockSpace();
 		eraseFlag = 0;
@@ -609,6 +779,7 @@ void InitBlockDieMap()
 
 	//make bad block table
 	RecoverBadBlockTable(RESERVED_DATA_BUFFER_BASE_ADDR);
+	EndInitStep("bad block table");
 
 	//to prevent accessing bbtBlock by host
 	for(dieNo=0 ; dieNo<USER_DIES ; dieNo++)
@@ -618,8 +789,17 @@ void InitBlockDieMap()
 
 	InitBlockMap();
 
+	grownBadBlockQ.head = 0;
+	grownBadBlockQ.cnt = 0;
+
+	lazyEraseMap.dirtyBlockCnt = 0;
+	lazyEraseMap.eraseDie = 0;
+	for(dieNo=0 ; dieNo<USER_DIES ; dieNo++)
+		lazyEraseMap.cursor[dieNo] = 0;
+
+	//user blocks are erased on demand instead of before the device gets ready
 	if(eraseFlag)
-		EraseUserBlockSpace();
+		MarkFreeBlocksDirty();
 
 	InitCurrentBlockOfDieMap();
 }
@@ -630,6 +810,9 @@ unsigned int AddrTransRead(unsigned int logicalSliceAddr)
 
 	if(logicalSliceAddr < SLICES_PER_SSD)
 	{
+		if(IsZoneSlice(logicalSliceAddr))
+			return ZoneAddrTransRead(logicalSliceAddr);
+
 		virtualSliceAddr = logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr;
 
 		if(virtualSliceAddr != VSA_NONE)
@@ -647,9 +830,12 @@ unsigned int AddrTransWrite(unsigned int logicalSliceAddr)
 
 	if(logicalSliceAddr < SLICES_PER_SSD)
 	{
+		if(IsZoneSlice(logicalSliceAddr))
+			return ZoneAddrTransWrite(logicalSliceAddr);
+
 		InvalidateOldVsa(logicalSliceAddr);
 
-		virtualSliceAddr = FindFreeVirtualSlice();
+		virtualSliceAddr = FindFreeVirtualSlice(Lsa2NamespaceTranslation(logicalSliceAddr));
 
 		logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr = virtualSliceAddr;
 		virtualSliceMapPtr->virtualSlice[virtualSliceAddr].logicalSliceAddr = logicalSliceAddr;
@@ -660,12 +846,24 @@ unsigned int AddrTransWrite(unsigned int logicalSliceAddr)
 		assert(!"[WARNING] Logical address is larger than maximum logical address served by SSD [WARNING]");
 }
 
+void AddrTransZero(unsigned int logicalSliceAddr)
+{
+	if(logicalSliceAddr < SLICES_PER_SSD)
+	{
+		InvalidateOldVsa(logicalSliceAddr);
+
+		logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr = VSA_ZERO;
+	}
+	else
+		assert(!"[WARNING] Logical address is larger than maximum logical address served by SSD [WARNING]");
+}
+
 
-unsigned int FindFreeVirtualSlice()
+unsigned int FindFreeVirtualSlice(unsigned int nsIdx)
 {
 	unsigned int currentBlock, virtualSliceAddr, dieNo;
 
-	dieNo = sliceAllocationTargetDie;
+	dieNo = FindDieForFreeSliceAllocation(nsIdx);
 	currentBlock = virtualDieMapPtr->die[dieNo].currentBlock;
 
 	if(virtualBlockMapPtr->block[dieNo][currentBlock].currentPage == USER_PAGES_PER_BLOCK)
@@ -697,8 +895,6 @@ unsigned int FindFreeVirtualSlice()
 
 	virtualSliceAddr = Vorg2VsaTranslation(dieNo, currentBlock, virtualBlockMapPtr->block[dieNo][currentBlock].currentPage);
 	virtualBlockMapPtr->block[dieNo][currentBlock].currentPage++;
-	sliceAllocationTargetDie = FindDieForFreeSliceAllocation();
-	dieNo = sliceAllocationTargetDie;
 	return virtualSliceAddr;
 }
 
@@ -736,20 +932,98 @@ unsigned int FindFreeVirtualSliceForGc(unsigned int copyTargetDieNo, unsigned in
 }
 
 
-unsigned int FindDieForFreeSliceAllocation()
+unsigned int IsDieWritable(unsigned int dieNo)
 {
-	static unsigned char targetCh = 0;
-	static unsigned char targetWay = 0;
-	unsigned int targetDie;
+	unsigned int currentBlock, invalidSliceCnt;
+
+	currentBlock = virtualDieMapPtr->die[dieNo].currentBlock;
+	if(virtualBlockMapPtr->block[dieNo][currentBlock].currentPage < USER_PAGES_PER_BLOCK)
+		return 1;
+	if(virtualDieMapPtr->die[dieNo].freeBlockCnt > RESERVED_FREE_BLOCK_COUNT)
+		return 1;
 
-	targetDie = Pcw2VdieTranslation(targetCh, targetWay);
+	//a block holding invalid slices gives free slices back through garbage collection
+	for(invalidSliceCnt = SLICES_PER_BLOCK; invalidSliceCnt > 0; invalidSliceCnt--)
+		if(gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].headBlock != BLOCK_NONE)
+			return 1;
 
-	if(targetCh != (USER_CHANNELS - 1))
-		targetCh = targetCh + 1;
+	return 0;
+}
+
+unsigned int FindDieForFreeSliceAllocation(unsigned int nsIdx)
+{
+	P_NAMESPACE_DIE_ENTRY nsDie;
+	unsigned int chLoad[USER_CHANNELS];
+	unsigned int chNo, wayNo, dieLoad, bestDieLoad, bestChLoad, cnt, dieNo, targetDie, fullDie;
+
+	nsDie = &namespaceDieMap.ns[nsIdx];
+
+	// load of a channel = requests waiting on all ways of the channel
+	for(chNo = 0; chNo < USER_CHANNELS; chNo++)
+	{
+		chLoad[chNo] = 0;
+		for(wayNo = 0; wayNo < USER_WAYS; wayNo++)
+			chLoad[chNo] += nandReqQ[chNo][wayNo].reqCnt + blockedByRowAddrDepReqQ[chNo][wayNo].reqCnt;
+	}
+
+	// scan the dies of the namespace in round-robin order starting from the cursor
+	// the die with the shallowest queue wins, a less busy channel breaks the tie, and the earlier die in round-robin order breaks the rest
+	// a die with neither free nor reclaimable slices left is passed over while another die of the namespace still has room
+	targetDie = DIE_NONE;
+	fullDie = DIE_NONE;
+	bestDieLoad = 0xffffffff;
+	bestChLoad = 0xffffffff;
+	chNo = nsDie->targetCh;
+	wayNo = nsDie->targetWay;
+	for(cnt = 0; cnt < USER_DIES; cnt++)
+	{
+		if((nsDie->chMask & (1 << chNo)) && (nsDie->wayMask & (1 << wayNo)))
+		{
+			dieNo = Pcw2VdieTranslation(chNo, wayNo);
+			dieLoad = nandReqQ[chNo][wayNo].reqCnt + blockedByRowAddrDepReqQ[chNo][wayNo].reqCnt;
+			if(dieStateTablePtr->dieState[chNo][wayNo].dieState == DIE_STATE_EXE)
+				dieLoad++;
+
+			if(!IsDieWritable(dieNo))
+				fullDie = dieNo;
+			else if((dieLoad < bestDieLoad) || ((dieLoad == bestDieLoad) && (chLoad[chNo] < bestChLoad)))
+			{
+				bestDieLoad = dieLoad;
+				bestChLoad = chLoad[chNo];
+				targetDie = dieNo;
+
+				if((bestDieLoad == 0) && (bestChLoad == 0))
+					break;
+			}
+		}
+
+		if(chNo != (USER_CHANNELS - 1))
+			chNo = chNo + 1;
+		else
+		{
+			chNo = 0;
+			wayNo = (wayNo + 1) % USER_WAYS;
+		}
+	}
+
+	//every die of the namespace is full, the allocation on it reports the exhausted space
+	if(targetDie == DIE_NONE)
+		targetDie = fullDie;
+	if(targetDie == DIE_NONE)
+		assert(!"[WARNING] There is no die mapped to the namespace [WARNING]");
+
+	// move the cursor just past the selected die to keep striping when every die is equally loaded
+	chNo = Vdie2PchTranslation(targetDie);
+	wayNo = Vdie2PwayTranslation(targetDie);
+	if(chNo != (USER_CHANNELS - 1))
+	{
+		nsDie->targetCh = chNo + 1;
+		nsDie->targetWay = wayNo;
+	}
 	else
 	{
-		targetCh = 0;
-		targetWay = (targetWay + 1) % USER_WAYS;
+		nsDie->targetCh = 0;
+		nsDie->targetWay = (wayNo + 1) % USER_WAYS;
 	}
 
 	return targetDie;
@@ -761,7 +1035,9 @@ void InvalidateOldVsa(unsigned int logicalSliceAddr)
 
 	virtualSliceAddr = logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr;
 
-	if(virtualSliceAddr != VSA_NONE)
+	if(virtualSliceAddr == VSA_ZERO)
+		logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr = VSA_NONE;
+	else if(virtualSliceAddr != VSA_NONE)
 	{
 		if(virtualSliceMapPtr->virtualSlice[virtualSliceAddr].logicalSliceAddr != logicalSliceAddr)
 			return;
@@ -780,9 +1056,39 @@ void InvalidateOldVsa(unsigned int logicalSliceAddr)
 }
 
 
+void CountBlockErase(unsigned int dieNo, unsigned int blockNo)
+{
+	virtualBlockMapPtr->block[dieNo][blockNo].eraseCnt++;
+	ftlStatistics.totalEraseCnt++;
+	if(virtualBlockMapPtr->block[dieNo][blockNo].eraseCnt > ftlStatistics.maxEraseCnt)
+		ftlStatistics.maxEraseCnt = virtualBlockMapPtr->block[dieNo][blockNo].eraseCnt;
+	if((ftlStatistics.totalEraseCnt % WEAR_EVENT_ERASE_CNT) == 0)
+		raise_async_event(ASYNC_EVENT_WEAR_LEVEL);
+}
+
 void EraseBlock(unsigned int dieNo, unsigned int blockNo)
 {
-	unsigned int pageNo, virtualSliceAddr, reqSlotTag;
+	unsigned int reqSlotTag;
+
+	if(virtualBlockMapPtr->block[dieNo][blockNo].bad)
+	{
+		//valid slices are read out of the failing physical block before it is swapped with a spare
+		SyncAllLowLevelReqDone();
+
+		if(RemapGrownBadBlock(dieNo, blockNo))
+			virtualBlockMapPtr->block[dieNo][blockNo].bad = 0;
+		else
+		{
+			//no spare is left, the virtual block is retired
+			virtualBlockMapPtr->block[dieNo][blockNo].invalidSliceCnt = 0;
+			virtualBlockMapPtr->block[dieNo][blockNo].prevBlock = BLOCK_NONE;
+			virtualBlockMapPtr->block[dieNo][blockNo].nextBlock = BLOCK_NONE;
+			ResetVirtualSliceMapOfBlock(dieNo, blockNo);
+
+			xil_printf("No reserved block - Ch %d Way %d virtualBlock %d is retired \r\n", Vdie2PchTranslation(dieNo), Vdie2PwayTranslation(dieNo), blockNo);
+			return;
+		}
+	}
 
 	reqSlotTag = GetFromFreeReqQ();
 
@@ -799,16 +1105,73 @@ void EraseBlock(unsigned int dieNo, unsigned int blockNo)
 
 	// block map indicated blockNo initialization
 	virtualBlockMapPtr->block[dieNo][blockNo].free = 1;
-	virtualBlockMapPtr->block[dieNo][blockNo].eraseCnt++;
+	CountBlockErase(dieNo, blockNo);
 	virtualBlockMapPtr->block[dieNo][blockNo].invalidSliceCnt = 0;
 	virtualBlockMapPtr->block[dieNo][blockNo].currentPage = 0;
+	ResetBlockReadHealth(dieNo, blockNo);
 
+	//the virtual slices are reset when the block is allocated again
 	PutToFbList(dieNo, blockNo);
+}
 
-	for(pageNo=0; pageNo<USER_PAGES_PER_BLOCK; pageNo++)
+void MarkFreeBlocksDirty()
+{
+	unsigned int dieNo, blockNo;
+
+	for(dieNo=0 ; dieNo<USER_DIES ; dieNo++)
+		for(blockNo=0 ; blockNo<FTL_BLOCKS_PER_DIE ; blockNo++)
+			if(!virtualBlockMapPtr->block[dieNo][blockNo].bad)
+			{
+				virtualBlockMapPtr->block[dieNo][blockNo].dirty = 1;
+				lazyEraseMap.dirtyBlockCnt++;
+			}
+
+	xil_printf("%d user blocks will be erased on demand.\r\n", lazyEraseMap.dirtyBlockCnt);
+}
+
+void EraseDirtyBlock(unsigned int dieNo, unsigned int blockNo)
+{
+	unsigned int reqSlotTag;
+
+	reqSlotTag = GetFromFreeReqQ();
+
+	//no slice of a dirty block is mapped, so the erase needs no row address dependency check
+	reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
+	reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_ERASE;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_NONE;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_NONE;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_MAIN;
+	reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = Vorg2VsaTranslation(dieNo, blockNo, 0);
+
+	SelectLowLevelReqQ(reqSlotTag);
+
+	CountBlockErase(dieNo, blockNo);
+	virtualBlockMapPtr->block[dieNo][blockNo].dirty = 0;
+	lazyEraseMap.dirtyBlockCnt--;
+}
+
+void EraseDirtyBlockOnIdle()
+{
+	unsigned int dieNo, loop;
+
+	//one erase per call on the next die having dirty free blocks
+	for(loop=0 ; loop<USER_DIES ; loop++)
 	{
-		virtualSliceAddr = Vorg2VsaTranslation(dieNo, blockNo, pageNo);
-		virtualSliceMapPtr->virtualSlice[virtualSliceAddr].logicalSliceAddr = LSA_NONE;
+		dieNo = lazyEraseMap.eraseDie;
+		lazyEraseMap.eraseDie = (lazyEraseMap.eraseDie + 1) % USER_DIES;
+
+		while(lazyEraseMap.cursor[dieNo] < FTL_BLOCKS_PER_DIE)
+		{
+			if(virtualBlockMapPtr->block[dieNo][lazyEraseMap.cursor[dieNo]].dirty)
+			{
+				EraseDirtyBlock(dieNo, lazyEraseMap.cursor[dieNo]);
+				lazyEraseMap.cursor[dieNo]++;
+				return;
+			}
+
+			lazyEraseMap.cursor[dieNo]++;
+		}
 	}
 }
 
@@ -864,9 +1227,16 @@ unsigned int GetFromFbList(unsigned int dieNo, unsigned int getFreeBlockOption)
 
 	virtualBlockMapPtr->block[dieNo][evictedBlockNo].free = 0;
 	virtualDieMapPtr->die[dieNo].freeBlockCnt--;
+	if(virtualDieMapPtr->die[dieNo].freeBlockCnt == FREE_BLOCK_CRITICAL_WATERMARK)
+		raise_async_event(ASYNC_EVENT_FREE_BLOCK_LOW);
 
 	virtualBlockMapPtr->block[dieNo][evictedBlockNo].nextBlock = BLOCK_NONE;
 	virtualBlockMapPtr->block[dieNo][evictedBlockNo].prevBlock = BLOCK_NONE;
+	ResetVirtualSliceMapOfBlock(dieNo, evictedBlockNo);
+
+	//the erase is queued on the die ahead of any program to the block
+	if(virtualBlockMapPtr->block[dieNo][evictedBlockNo].dirty)
+		EraseDirtyBlock(dieNo, evictedBlockNo);
 
 	return evictedBlockNo;
 }
@@ -880,6 +1250,104 @@ void UpdatePhyBlockMapForGrownBadBlock(unsigned int dieNo, unsigned int phyBlock
 }
 
 
+void RetireGrownBadBlock(unsigned int dieNo, unsigned int blockNo)
+{
+	unsigned int currentBlock;
+
+	if(virtualBlockMapPtr->block[dieNo][blockNo].bad)
+		return;
+
+	virtualBlockMapPtr->block[dieNo][blockNo].bad = 1;
+	ftlStatistics.grownBadBlockCnt[dieNo]++;
+	if(ftlStatistics.grownBadBlockCnt[dieNo] == SPARE_THRESHOLD_GROWN_BAD_BLOCKS)
+		raise_async_event(ASYNC_EVENT_SPARE_BELOW_THRESHOLD);
+
+	//zone data is never moved by GC, the host reads it out of the read only zone instead
+	if(virtualBlockMapPtr->block[dieNo][blockNo].zone)
+	{
+		RetireZoneBlock(dieNo, blockNo);
+		return;
+	}
+
+	//no more slices are allocated to the failing block
+	if(virtualDieMapPtr->die[dieNo].currentBlock == blockNo)
+	{
+		currentBlock = GetFromFbList(dieNo, GET_FREE_BLOCK_GC);
+		if(currentBlock == BLOCK_FAIL)
+			assert(!"[WARNING] There is no available block [WARNING]");
+
+		virtualDieMapPtr->die[dieNo].currentBlock = currentBlock;
+	}
+
+	//a full queue leaves the block to GC, which moves its slices and remaps it the same way
+	if(grownBadBlockQ.cnt < GROWN_BAD_BLOCK_QUEUE_DEPTH)
+	{
+		grownBadBlockQ.dieNo[(grownBadBlockQ.head + grownBadBlockQ.cnt) % GROWN_BAD_BLOCK_QUEUE_DEPTH] = dieNo;
+		grownBadBlockQ.blockNo[(grownBadBlockQ.head + grownBadBlockQ.cnt) % GROWN_BAD_BLOCK_QUEUE_DEPTH] = blockNo;
+		grownBadBlockQ.cnt++;
+	}
+}
+
+unsigned int RemapGrownBadBlock(unsigned int dieNo, unsigned int blockNo)
+{
+	unsigned int phyBlockNo, endBlockNo;
+	unsigned int* reservedBlock;
+
+	phyBlockNo = Vblock2PblockOfTbsTranslation(blockNo);
+	if(phyBlockNo < TOTAL_BLOCKS_PER_LUN)
+	{
+		reservedBlock = &reservedBlockOfLun0[dieNo];
+		endBlockNo = TOTAL_BLOCKS_PER_LUN;
+	}
+	else
+	{
+		reservedBlock = &reservedBlockOfLun1[dieNo];
+		endBlockNo = TOTAL_BLOCKS_PER_DIE;
+	}
+
+	while((*reservedBlock < endBlockNo) && phyBlockMapPtr->phyBlock[dieNo][*reservedBlock].bad)
+		(*reservedBlock)++;
+
+	if(*reservedBlock >= endBlockNo)
+		return 0;
+
+	xil_printf("Grown bad block remap - Ch %d Way %d virtualBlock %d: phyBlock %d -> %d \r\n", Vdie2PchTranslation(dieNo), Vdie2PwayTranslation(dieNo), blockNo,
+			phyBlockMapPtr->phyBlock[dieNo][phyBlockNo].remappedPhyBlock, *reservedBlock);
+
+	phyBlockMapPtr->phyBlock[dieNo][phyBlockNo].remappedPhyBlock = *reservedBlock;
+	(*reservedBlock)++;
+
+	return 1;
+}
+
+void HandleGrownBadBlock()
+{
+	unsigned int dieNo, blockNo;
+
+	//programs still in flight to the failing blocks are finished or re-issued first
+	SyncAllLowLevelReqDone();
+
+	while(grownBadBlockQ.cnt)
+	{
+		dieNo = grownBadBlockQ.dieNo[grownBadBlockQ.head];
+		blockNo = grownBadBlockQ.blockNo[grownBadBlockQ.head];
+		grownBadBlockQ.head = (grownBadBlockQ.head + 1) % GROWN_BAD_BLOCK_QUEUE_DEPTH;
+		grownBadBlockQ.cnt--;
+
+		//GC or refresh may have remapped the block in the meantime
+		if(virtualBlockMapPtr->block[dieNo][blockNo].bad && !virtualBlockMapPtr->block[dieNo][blockNo].free)
+		{
+			if(virtualBlockMapPtr->block[dieNo][blockNo].invalidSliceCnt)
+				SelectiveGetFromGcVictimList(dieNo, blockNo);
+
+			MigrateValidSlices(dieNo, blockNo);
+		}
+	}
+
+	//persist the bad block table of the dies having new grown bad blocks
+	UpdateBadBlockTableForGrownBadBlock(RESERVED_DATA_BUFFER_BASE_ADDR);
+}
+
 void UpdateBadBlockTableForGrownBadBlock(unsigned int tempBufAddr)
 {
 	unsigned int dieNo, phyBlockNo, tempBbtBufBaseAddr, tempBbtBufEntrySize;
@@ -916,5 +1384,9 @@ void UpdateBadBlockTableForGrownBadBlock(unsigned int tempBufAddr)
 
 	//update bad block tables in flash
 	SaveBadBlockTable(dieState, tempBbtBufAddr, tempBbtBufEntrySize);
+
+	for(dieNo = 0; dieNo < USER_DIES; dieNo++)
+		if(dieState[dieNo] == DIE_STATE_BAD_BLOCK_TABLE_UPDATE)
+			bbtInfoMapPtr->bbtInfo[dieNo].grownBadUpdate = BBT_INFO_GROWN_BAD_UPDATE_NONE;
 }
 
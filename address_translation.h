@@ -55,6 +55,7 @@
 
 #define VSA_NONE	0xffffffff
 #define VSA_FAIL	0xffffffff
+#define VSA_ZERO	0xfffffffe		//slice written with zeroes, it owns no NAND space
 
 #define PAGE_NONE		0xffff
 
@@ -65,6 +66,7 @@
 #define DIE_FAIL	0xff
 
 #define RESERVED_FREE_BLOCK_COUNT	0x1
+#define FREE_BLOCK_CRITICAL_WATERMARK	(RESERVED_FREE_BLOCK_COUNT + USER_BLOCKS_PER_DIE / 128)	//the host is notified before writes stall in GC
 
 #define GET_FREE_BLOCK_NORMAL	0x0
 #define GET_FREE_BLOCK_GC		0x1
@@ -89,6 +91,10 @@
 #define BBT_INFO_GROWN_BAD_UPDATE_NONE			0
 #define BBT_INFO_GROWN_BAD_UPDATE_BOOKED		1
 
+#define GROWN_BAD_BLOCK_QUEUE_DEPTH				16
+
+#define BOOT_SCAN_REQ_DEPTH_PER_DIE				8		//requests kept in flight on each die while scanning or erasing blocks at boot
+
 // virtual slice address to virtual organization translation
 #define Vsa2VdieTranslation(virtualSliceAddr) ((virtualSliceAddr) % (USER_DIES))
 #define Vsa2VblockTranslation(virtualSliceAddr) (((virtualSliceAddr) / (USER_DIES)) / (SLICES_PER_BLOCK))
@@ -108,6 +114,10 @@
 #define Pcw2VdieTranslation(chNo, wayNo) ((chNo) + (wayNo) * (USER_CHANNELS))
 #define PlsbPage2VpageTranslation(pageNo) ((pageNo) > (0) ? ( ((pageNo) + 1) / 2): (0))
 
+// logical slice address to namespace translation
+#define SLICES_PER_NAMESPACE ((storageCapacity_L / (USER_NAMESPACES)) / (NVME_BLOCKS_PER_SLICE))
+#define Lsa2NamespaceTranslation(logicalSliceAddr) ((((logicalSliceAddr) / (SLICES_PER_NAMESPACE)) < (USER_NAMESPACES)) ? ((logicalSliceAddr) / (SLICES_PER_NAMESPACE)) : ((USER_NAMESPACES) - 1))
+
 //for logical to virtual translation
 typedef struct _LOGICAL_SLICE_ENTRY {
 	unsigned int virtualSliceAddr;
@@ -131,7 +141,9 @@ typedef struct _VIRTUAL_BLOCK_ENTRY {
 	unsigned int bad : 1;
 	unsigned int free : 1;
 	unsigned int invalidSliceCnt : 16;
-	unsigned int reserved0 :10;
+	unsigned int dirty : 1;		//free but not erased yet, erased lazily before allocation or on idle
+	unsigned int zone : 1;		//backs a zone of the zoned namespace, its slices are not in the logical slice map
+	unsigned int reserved0 :8;
 	unsigned int currentPage : 16;
 	unsigned int eraseCnt : 16;
 	unsigned int prevBlock : 16;
@@ -183,25 +195,78 @@ typedef struct _PHY_BLOCK_MAP {
 	PHY_BLOCK_ENTRY phyBlock[USER_DIES][TOTAL_BLOCKS_PER_DIE];
 } PHY_BLOCK_MAP, *P_PHY_BLOCK_MAP;
 
+//free blocks left unerased at boot
+typedef struct _LAZY_ERASE_MAP {
+	unsigned int cursor[USER_DIES];
+	unsigned int dirtyBlockCnt;
+	unsigned int eraseDie;
+} LAZY_ERASE_MAP, *P_LAZY_ERASE_MAP;
+
+//mark page reads in flight on a die, they complete in issue order
+typedef struct _BAD_BLOCK_SCAN_DIE {
+	unsigned short phyBlock[BOOT_SCAN_REQ_DEPTH_PER_DIE];	//indexed by buffer slot
+	unsigned short markPage[BOOT_SCAN_REQ_DEPTH_PER_DIE];
+	unsigned char issuedSlot[BOOT_SCAN_REQ_DEPTH_PER_DIE];
+	unsigned char freeSlot[BOOT_SCAN_REQ_DEPTH_PER_DIE];
+	unsigned char issuedHead;
+	unsigned char issuedCnt;
+	unsigned char freeCnt;
+	unsigned int nextPhyBlock;
+} BAD_BLOCK_SCAN_DIE;
+
+//virtual blocks waiting for their valid slices to be moved out after a program failure
+typedef struct _GROWN_BAD_BLOCK_QUEUE {
+	unsigned short dieNo[GROWN_BAD_BLOCK_QUEUE_DEPTH];
+	unsigned short blockNo[GROWN_BAD_BLOCK_QUEUE_DEPTH];
+	unsigned int head;
+	unsigned int cnt;
+} GROWN_BAD_BLOCK_QUEUE, *P_GROWN_BAD_BLOCK_QUEUE;
+
+//dies where the slices of a namespace are allocated
+typedef struct _NAMESPACE_DIE_ENTRY {
+	unsigned int chMask : 8;
+	unsigned int wayMask : 8;
+	unsigned int targetCh : 4;		//round-robin cursor of slice allocation
+	unsigned int targetWay : 4;
+	unsigned int reserved0 : 8;
+} NAMESPACE_DIE_ENTRY, *P_NAMESPACE_DIE_ENTRY;
+
+typedef struct _NAMESPACE_DIE_MAP {
+	NAMESPACE_DIE_ENTRY ns[USER_NAMESPACES];
+} NAMESPACE_DIE_MAP, *P_NAMESPACE_DIE_MAP;
+
 
 void InitAddressMap();
 void InitSliceMap();
+void ResetVirtualSliceMapOfBlock(unsigned int dieNo, unsigned int blockNo);
 void InitBlockDieMap();
+void InitNamespaceDieMap();
+unsigned int CountNamespaceDies(unsigned int chMask, unsigned int wayMask);
+unsigned int SetNamespaceDieMap(unsigned int nsIdx, unsigned int chMask, unsigned int wayMask);
 
 unsigned int AddrTransRead(unsigned int logicalSliceAddr);
 unsigned int AddrTransWrite(unsigned int logicalSliceAddr);
-unsigned int FindFreeVirtualSlice();
+void AddrTransZero(unsigned int logicalSliceAddr);
+unsigned int FindFreeVirtualSlice(unsigned int nsIdx);
 unsigned int FindFreeVirtualSliceForGc(unsigned int copyTargetDieNo, unsigned int victimBlockNo);
-unsigned int FindDieForFreeSliceAllocation();
+unsigned int IsDieWritable(unsigned int dieNo);
+unsigned int FindDieForFreeSliceAllocation(unsigned int nsIdx);
 
 void InvalidateOldVsa(unsigned int logicalSliceAddr);
+void CountBlockErase(unsigned int dieNo, unsigned int blockNo);
 void EraseBlock(unsigned int dieNo, unsigned int blockNo);
+void MarkFreeBlocksDirty();
+void EraseDirtyBlock(unsigned int dieNo, unsigned int blockNo);
+void EraseDirtyBlockOnIdle();
 
 void PutToFbList(unsigned int dieNo, unsigned int blockNo);
 unsigned int GetFromFbList(unsigned int dieNo, unsigned int getFreeBlockOption);
 
 void UpdatePhyBlockMapForGrownBadBlock(unsigned int dieNo, unsigned int phyBlockNo);
 void UpdateBadBlockTableForGrownBadBlock(unsigned int tempBufAddr);
+void RetireGrownBadBlock(unsigned int dieNo, unsigned int blockNo);
+unsigned int RemapGrownBadBlock(unsigned int dieNo, unsigned int blockNo);
+void HandleGrownBadBlock();
 
 
 extern P_LOGICAL_SLICE_MAP logicalSliceMapPtr;
@@ -211,7 +276,9 @@ extern P_VIRTUAL_DIE_MAP virtualDieMapPtr;
 extern P_PHY_BLOCK_MAP phyBlockMapPtr;
 extern P_BAD_BLOCK_TABLE_INFO_MAP bbtInfoMapPtr;
 
-extern unsigned char sliceAllocationTargetDie;
+extern NAMESPACE_DIE_MAP namespaceDieMap;
+extern GROWN_BAD_BLOCK_QUEUE grownBadBlockQ;
+extern LAZY_ERASE_MAP lazyEraseMap;
 extern unsigned int mbPerbadBlockSpace;
 
 #endif /* ADDRESS_TRANSLATION_H_ */
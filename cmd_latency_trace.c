@@ -0,0 +1,208 @@
+//////////////////////////////////////////////////////////////////////////////////
+// cmd_latency_trace.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Command Latency Tracer
+// File Name: cmd_latency_trace.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - measure the latency of NVMe IO commands from fetch to completion with the global timer
+//   - keep log2 latency histograms per command class
+//   - record where the slowest commands waited (buffer and row address dependency, GC, NAND)
+//   - compiled in by CMD_LATENCY_TRACE
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "xil_printf.h"
+#include <string.h>
+#include "xtime_l.h"
+#include "memory_map.h"
+#include "nvme/nvme.h"
+
+CMD_LATENCY_TRACER cmdLatencyTrace;
+P_CMD_LATENCY_TABLE cmdLatencyTablePtr = (P_CMD_LATENCY_TABLE) CMD_LATENCY_TABLE_ADDR;
+
+unsigned int ReadGlobalTimer()
+{
+	//the lower word wraps every 12.9s at 333MHz, it only serves for intervals shorter than that
+	return *((volatile unsigned int*)(GLOBAL_TMR_BASEADDR + GTIMER_COUNTER_LOWER_OFFSET));
+}
+
+unsigned int GetCmdLatencyClass(unsigned int opc, unsigned int nsid)
+{
+	//the key value command set reuses opcodes of the NVM command set
+	if(KV_NAMESPACE_ID && (nsid == KV_NAMESPACE_ID))
+		return CMD_LATENCY_CLASS_KV;
+
+	switch(opc)
+	{
+		case IO_NVM_FLUSH:
+			return CMD_LATENCY_CLASS_FLUSH;
+		case IO_NVM_WRITE:
+			return CMD_LATENCY_CLASS_WRITE;
+		case IO_NVM_READ:
+			return CMD_LATENCY_CLASS_READ;
+		case IO_NVM_COMPARE:
+			return CMD_LATENCY_CLASS_COMPARE;
+		case IO_NVM_WRITE_ZEROES:
+			return CMD_LATENCY_CLASS_WRITE_ZEROES;
+		case IO_ZNS_ZONE_APPEND:
+			return CMD_LATENCY_CLASS_ZONE_APPEND;
+		default:
+			return CMD_LATENCY_CLASS_OTHER;
+	}
+}
+
+void InitCmdLatencyTrace()
+{
+	memset(&cmdLatencyTrace, 0, sizeof(CMD_LATENCY_TRACER));
+	cmdLatencyTrace.curCmdSlotTag = NVME_CMD_SLOT_TAG_NONE;
+
+	memset(cmdLatencyTablePtr, 0, sizeof(CMD_LATENCY_TABLE));
+	cmdLatencyTablePtr->enabled = CMD_LATENCY_TRACE;
+	cmdLatencyTablePtr->timerFreq = COUNTS_PER_SECOND;
+	cmdLatencyTablePtr->classCnt = CMD_LATENCY_CLASSES;
+	cmdLatencyTablePtr->bucketCnt = CMD_LATENCY_BUCKETS;
+	cmdLatencyTablePtr->waitCnt = CMD_LATENCY_WAITS;
+	cmdLatencyTablePtr->slowCmdCnt = CMD_LATENCY_SLOW_CMDS;
+}
+
+void StartCmdLatencyTrace(unsigned int cmdSlotTag, unsigned int latencyClass, unsigned int fetchTime)
+{
+	P_CMD_LATENCY_SLOT slot;
+
+	slot = &cmdLatencyTrace.slot[cmdSlotTag];
+
+	slot->startTime = fetchTime;
+	slot->remainingNvmeBlock = 0;
+	slot->latencyClass = latencyClass;
+	slot->pending = 1;
+	slot->waitTime[CMD_LATENCY_WAIT_BUF_DEP] = 0;
+	slot->waitTime[CMD_LATENCY_WAIT_ROW_ADDR_DEP] = 0;
+	slot->waitTime[CMD_LATENCY_WAIT_GC] = 0;
+	slot->waitTime[CMD_LATENCY_WAIT_NAND] = 0;
+}
+
+void EndHandledCmdLatencyTrace(unsigned int cmdSlotTag)
+{
+	//a command without pending host DMA was completed while it was handled
+	if(cmdLatencyTrace.slot[cmdSlotTag].pending && !cmdLatencyTrace.slot[cmdSlotTag].remainingNvmeBlock)
+		CompleteCmdLatencyTrace(cmdSlotTag);
+}
+
+void UpdateCmdLatencyTraceDma(unsigned int cmdSlotTag, unsigned int numOfNvmeBlock)
+{
+	P_CMD_LATENCY_SLOT slot;
+
+	slot = &cmdLatencyTrace.slot[cmdSlotTag];
+	if(!slot->pending || !slot->remainingNvmeBlock)
+		return;
+
+	//auto completion is posted by the DMA engine along with the last DMA of the command
+	slot->remainingNvmeBlock -= numOfNvmeBlock;
+	if(!slot->remainingNvmeBlock)
+		CompleteCmdLatencyTrace(cmdSlotTag);
+}
+
+void CompleteCmdLatencyTrace(unsigned int cmdSlotTag)
+{
+	P_CMD_LATENCY_SLOT slot;
+	P_CMD_LATENCY_CLASS_STAT classStat;
+	P_SLOW_CMD_RECORD slowCmd;
+	unsigned int latency, entry, fastest;
+
+	slot = &cmdLatencyTrace.slot[cmdSlotTag];
+	slot->pending = 0;
+	latency = ReadGlobalTimer() - slot->startTime;
+
+	classStat = &cmdLatencyTrace.classStat[slot->latencyClass];
+	classStat->cmdCnt++;
+	classStat->totalLatency += latency;
+	if(latency > classStat->maxLatency)
+		classStat->maxLatency = latency;
+
+	//bucket n counts the commands taking 2^n to 2^(n+1)-1 ticks
+	classStat->histogram[31 - __builtin_clz(latency | 1)]++;
+
+	//a command slower than the fastest recorded one takes its entry
+	slowCmd = &cmdLatencyTrace.slowCmd[cmdLatencyTrace.fastestSlowCmd];
+	if(latency <= slowCmd->latency)
+		return;
+
+	slowCmd->latencyClass = slot->latencyClass;
+	slowCmd->cmdSlotTag = cmdSlotTag;
+	slowCmd->startTime = slot->startTime;
+	slowCmd->latency = latency;
+	memcpy(slowCmd->waitTime, slot->waitTime, sizeof(slot->waitTime));
+
+	fastest = 0;
+	for(entry = 1; entry < CMD_LATENCY_SLOW_CMDS; entry++)
+		if(cmdLatencyTrace.slowCmd[entry].latency < cmdLatencyTrace.slowCmd[fastest].latency)
+			fastest = entry;
+	cmdLatencyTrace.fastestSlowCmd = fastest;
+}
+
+void AddCmdLatencyWait(unsigned int reqSlotTag, unsigned int wait)
+{
+	unsigned int cmdSlotTag, reqCode;
+
+	cmdSlotTag = reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag;
+	if((cmdSlotTag == NVME_CMD_SLOT_TAG_NONE) || !cmdLatencyTrace.slot[cmdSlotTag].pending)
+		return;
+
+	//programs of evicted slices and erases run behind the command, it does not wait for them
+	reqCode = reqPoolPtr->reqPool[reqSlotTag].reqCode;
+	if((reqPoolPtr->reqPool[reqSlotTag].reqType == REQ_TYPE_NAND) && ((reqCode == REQ_CODE_WRITE) || (reqCode == REQ_CODE_ERASE)))
+		return;
+
+	cmdLatencyTrace.slot[cmdSlotTag].waitTime[wait] += ReadGlobalTimer() - reqPoolPtr->reqColdPool[reqSlotTag].traceTime;
+}
+
+void AddCmdLatencyGcStall(unsigned int time)
+{
+	unsigned int cmdSlotTag;
+
+	cmdSlotTag = cmdLatencyTrace.curCmdSlotTag;
+	if((cmdSlotTag != NVME_CMD_SLOT_TAG_NONE) && cmdLatencyTrace.slot[cmdSlotTag].pending)
+		cmdLatencyTrace.slot[cmdSlotTag].waitTime[CMD_LATENCY_WAIT_GC] += time;
+}
+
+void PublishCmdLatencyTrace()
+{
+	memcpy(cmdLatencyTablePtr->classStat, cmdLatencyTrace.classStat, sizeof(cmdLatencyTrace.classStat));
+	memcpy(cmdLatencyTablePtr->slowCmd, cmdLatencyTrace.slowCmd, sizeof(cmdLatencyTrace.slowCmd));
+}
+
+unsigned int MakeCmdLatencyLog(unsigned int bufAddr)
+{
+	memcpy((void*)bufAddr, cmdLatencyTablePtr, sizeof(CMD_LATENCY_TABLE));
+
+	return sizeof(CMD_LATENCY_TABLE);
+}
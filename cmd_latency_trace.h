@@ -0,0 +1,153 @@
+//////////////////////////////////////////////////////////////////////////////////
+// cmd_latency_trace.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Command Latency Tracer
+// File Name: cmd_latency_trace.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - define latency histograms of NVMe IO commands and records of the slowest commands
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CMD_LATENCY_TRACE_H_
+#define CMD_LATENCY_TRACE_H_
+
+#include "ftl_config.h"
+#include "nvme/host_lld.h"
+
+#define CMD_LATENCY_CLASS_FLUSH				0
+#define CMD_LATENCY_CLASS_WRITE				1
+#define CMD_LATENCY_CLASS_READ				2
+#define CMD_LATENCY_CLASS_COMPARE			3
+#define CMD_LATENCY_CLASS_WRITE_ZEROES		4
+#define CMD_LATENCY_CLASS_ZONE_APPEND		5
+#define CMD_LATENCY_CLASS_KV				6		//every command of the key value namespace
+#define CMD_LATENCY_CLASS_OTHER				7
+#define CMD_LATENCY_CLASSES					8
+
+#define CMD_LATENCY_WAIT_BUF_DEP			0		//blocked by a data buffer dependency
+#define CMD_LATENCY_WAIT_ROW_ADDR_DEP		1		//blocked by a row address dependency
+#define CMD_LATENCY_WAIT_GC					2		//GC run while a slice of the command is transformed
+#define CMD_LATENCY_WAIT_NAND				3		//NAND reads of the command, queueing at the die included
+#define CMD_LATENCY_WAITS					4
+
+#define CMD_LATENCY_BUCKETS					32
+#define CMD_LATENCY_SLOW_CMDS				64
+#define CMD_LATENCY_CMD_SLOTS				(1 << P_SLOT_TAG_WIDTH)
+
+// latencies are measured with the global timer shared by both cores
+#if (CMD_LATENCY_TRACE == 1)
+#define CmdLatencyTraceStart(cmdSlotTag, latencyClass, fetchTime) StartCmdLatencyTrace((cmdSlotTag), (latencyClass), (fetchTime))
+#define CmdLatencyTraceHandled(cmdSlotTag) EndHandledCmdLatencyTrace((cmdSlotTag))
+#define CmdLatencyTraceAddNvmeBlock(cmdSlotTag, numOfNvmeBlock) (cmdLatencyTrace.slot[(cmdSlotTag)].remainingNvmeBlock += (numOfNvmeBlock))
+#define CmdLatencyTraceDmaDone(cmdSlotTag, numOfNvmeBlock) UpdateCmdLatencyTraceDma((cmdSlotTag), (numOfNvmeBlock))
+#define CmdLatencyTraceWaitBegin(reqSlotTag) (reqPoolPtr->reqColdPool[(reqSlotTag)].traceTime = ReadGlobalTimer())
+#define CmdLatencyTraceWaitEnd(reqSlotTag, wait) AddCmdLatencyWait((reqSlotTag), (wait))
+#define CmdLatencyTraceSetCurrent(cmdSlotTag) (cmdLatencyTrace.curCmdSlotTag = (cmdSlotTag))
+#define CmdLatencyTraceGcBegin() (cmdLatencyTrace.gcStartTime = ReadGlobalTimer())
+#define CmdLatencyTraceGcEnd() AddCmdLatencyGcStall(ReadGlobalTimer() - cmdLatencyTrace.gcStartTime)
+#else
+#define CmdLatencyTraceStart(cmdSlotTag, latencyClass, fetchTime)
+#define CmdLatencyTraceHandled(cmdSlotTag)
+#define CmdLatencyTraceAddNvmeBlock(cmdSlotTag, numOfNvmeBlock)
+#define CmdLatencyTraceDmaDone(cmdSlotTag, numOfNvmeBlock)
+#define CmdLatencyTraceWaitBegin(reqSlotTag)
+#define CmdLatencyTraceWaitEnd(reqSlotTag, wait)
+#define CmdLatencyTraceSetCurrent(cmdSlotTag)
+#define CmdLatencyTraceGcBegin()
+#define CmdLatencyTraceGcEnd()
+#endif
+
+typedef struct _CMD_LATENCY_SLOT {
+	unsigned int startTime;
+	unsigned int remainingNvmeBlock;
+	unsigned char latencyClass;
+	unsigned char pending;
+	unsigned short reserved0;
+	unsigned int waitTime[CMD_LATENCY_WAITS];
+} CMD_LATENCY_SLOT, *P_CMD_LATENCY_SLOT;
+
+typedef struct _CMD_LATENCY_CLASS_STAT {
+	unsigned int cmdCnt;
+	unsigned int maxLatency;
+	unsigned long long totalLatency;
+	unsigned int histogram[CMD_LATENCY_BUCKETS];
+} CMD_LATENCY_CLASS_STAT, *P_CMD_LATENCY_CLASS_STAT;
+
+typedef struct _SLOW_CMD_RECORD {
+	unsigned char latencyClass;
+	unsigned char reserved0;
+	unsigned short cmdSlotTag;
+	unsigned int startTime;
+	unsigned int latency;
+	unsigned int waitTime[CMD_LATENCY_WAITS];
+} SLOW_CMD_RECORD, *P_SLOW_CMD_RECORD;
+
+// state of the tracer, kept in cached memory of the FTL
+typedef struct _CMD_LATENCY_TRACER {
+	CMD_LATENCY_SLOT slot[CMD_LATENCY_CMD_SLOTS];
+	CMD_LATENCY_CLASS_STAT classStat[CMD_LATENCY_CLASSES];
+	SLOW_CMD_RECORD slowCmd[CMD_LATENCY_SLOW_CMDS];
+	unsigned int fastestSlowCmd;		//entry replaced by the next slower command
+	unsigned int curCmdSlotTag;			//command whose slice is transformed, charged for GC
+	unsigned int gcStartTime;
+} CMD_LATENCY_TRACER, *P_CMD_LATENCY_TRACER;
+
+// layout of the command latency log page, published to memory shared with the host interface core
+typedef struct _CMD_LATENCY_TABLE {
+	unsigned int enabled;
+	unsigned int timerFreq;				//ticks per second of latencies and wait times
+	unsigned int classCnt;
+	unsigned int bucketCnt;
+	unsigned int waitCnt;
+	unsigned int slowCmdCnt;
+	unsigned int reserved0[2];
+	CMD_LATENCY_CLASS_STAT classStat[CMD_LATENCY_CLASSES];
+	SLOW_CMD_RECORD slowCmd[CMD_LATENCY_SLOW_CMDS];
+} CMD_LATENCY_TABLE, *P_CMD_LATENCY_TABLE;
+
+unsigned int ReadGlobalTimer();
+unsigned int GetCmdLatencyClass(unsigned int opc, unsigned int nsid);
+
+void InitCmdLatencyTrace();
+void StartCmdLatencyTrace(unsigned int cmdSlotTag, unsigned int latencyClass, unsigned int fetchTime);
+void EndHandledCmdLatencyTrace(unsigned int cmdSlotTag);
+void UpdateCmdLatencyTraceDma(unsigned int cmdSlotTag, unsigned int numOfNvmeBlock);
+void CompleteCmdLatencyTrace(unsigned int cmdSlotTag);
+void AddCmdLatencyWait(unsigned int reqSlotTag, unsigned int wait);
+void AddCmdLatencyGcStall(unsigned int time);
+void PublishCmdLatencyTrace();
+unsigned int MakeCmdLatencyLog(unsigned int bufAddr);
+
+extern CMD_LATENCY_TRACER cmdLatencyTrace;
+extern P_CMD_LATENCY_TABLE cmdLatencyTablePtr;
+
+#endif /* CMD_LATENCY_TRACE_H_ */
@@ -46,6 +46,7 @@
 
 #include "xil_printf.h"
 #include <assert.h>
+#include <string.h>
 #include "memory_map.h"
 
 
@@ -69,13 +70,12 @@ void InitDataBuf()
 		dataBufMapPtr->dataBuf[bufEntry].nextEntry = bufEntry+1;
 		dataBufMapPtr->dataBuf[bufEntry].dirty = DATA_BUF_CLEAN;
 		dataBufMapPtr->dataBuf[bufEntry].blockingReqTail =  REQ_SLOT_TAG_NONE;
-
-		dataBufHashTablePtr->dataBufHash[bufEntry].headEntry = DATA_BUF_NONE;
-		dataBufHashTablePtr->dataBufHash[bufEntry].tailEntry = DATA_BUF_NONE;
 		dataBufMapPtr->dataBuf[bufEntry].hashPrevEntry = DATA_BUF_NONE;
 		dataBufMapPtr->dataBuf[bufEntry].hashNextEntry = DATA_BUF_NONE;
 	}
 
+	memset(dataBufHashTablePtr, 0xFF, sizeof(DATA_BUF_HASH_TABLE));	//DATA_BUF_NONE
+
 	dataBufMapPtr->dataBuf[0].prevEntry = DATA_BUF_NONE;
 	dataBufMapPtr->dataBuf[AVAILABLE_DATA_BUFFER_ENTRY_COUNT - 1].nextEntry = DATA_BUF_NONE;
 	dataBufLruList.headEntry = 0 ;
@@ -89,7 +89,7 @@ unsigned int CheckDataBufHit(unsigned int reqSlotTag)
 {
 	unsigned int bufEntry, logicalSliceAddr;
 
-	logicalSliceAddr = reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr;
+	logicalSliceAddr = reqPoolPtr->reqColdPool[reqSlotTag].logicalSliceAddr;
 	bufEntry = dataBufHashTablePtr->dataBufHash[FindDataBufHashTableEntry(logicalSliceAddr)].headEntry;
 
 	while(bufEntry != DATA_BUF_NONE)
@@ -132,41 +132,72 @@ unsigned int CheckDataBufHit(unsigned int reqSlotTag)
 				dataBufLruList.tailEntry = bufEntry;
 			}
 
+			ftlStatistics.dataBufHitCnt++;
 			return bufEntry;
 		}
 		else
 			bufEntry = dataBufMapPtr->dataBuf[bufEntry].hashNextEntry;
 	}
 
+	ftlStatistics.dataBufMissCnt++;
 	return DATA_BUF_FAIL;
 }
 
-unsigned int AllocateDataBuf()
+unsigned int FindDataBufEntry(unsigned int logicalSliceAddr)
 {
-	unsigned int evictedEntry = dataBufLruList.tailEntry;
-
-	if(evictedEntry == DATA_BUF_NONE)
-		assert(!"[WARNING] There is no valid buffer entry [WARNING]");
+	unsigned int bufEntry;
 
-	if(dataBufMapPtr->dataBuf[evictedEntry].prevEntry != DATA_BUF_NONE)
+	//lookup without touching the LRU order
+	bufEntry = dataBufHashTablePtr->dataBufHash[FindDataBufHashTableEntry(logicalSliceAddr)].headEntry;
+	while(bufEntry != DATA_BUF_NONE)
 	{
-		dataBufMapPtr->dataBuf[dataBufMapPtr->dataBuf[evictedEntry].prevEntry].nextEntry = DATA_BUF_NONE;
-		dataBufLruList.tailEntry = dataBufMapPtr->dataBuf[evictedEntry].prevEntry;
-
-		dataBufMapPtr->dataBuf[evictedEntry].prevEntry = DATA_BUF_NONE;
-		dataBufMapPtr->dataBuf[evictedEntry].nextEntry = dataBufLruList.headEntry;
-		dataBufMapPtr->dataBuf[dataBufLruList.headEntry].prevEntry = evictedEntry;
-		dataBufLruList.headEntry = evictedEntry;
+		if(dataBufMapPtr->dataBuf[bufEntry].logicalSliceAddr == logicalSliceAddr)
+			return bufEntry;
 
+		bufEntry = dataBufMapPtr->dataBuf[bufEntry].hashNextEntry;
 	}
-	else
+
+	return DATA_BUF_NONE;
+}
+
+unsigned int AllocateDataBuf()
+{
+	unsigned int evictedEntry, tryCnt;
+
+	for(tryCnt = 0; tryCnt < AVAILABLE_DATA_BUFFER_ENTRY_COUNT; tryCnt++)
 	{
-		dataBufMapPtr->dataBuf[evictedEntry].prevEntry = DATA_BUF_NONE;
-		dataBufMapPtr->dataBuf[evictedEntry].nextEntry = DATA_BUF_NONE;
-		dataBufLruList.headEntry = evictedEntry;
-		dataBufLruList.tailEntry = evictedEntry;
+		evictedEntry = dataBufLruList.tailEntry;
+
+		if(evictedEntry == DATA_BUF_NONE)
+			assert(!"[WARNING] There is no valid buffer entry [WARNING]");
+
+		if(dataBufMapPtr->dataBuf[evictedEntry].prevEntry != DATA_BUF_NONE)
+		{
+			dataBufMapPtr->dataBuf[dataBufMapPtr->dataBuf[evictedEntry].prevEntry].nextEntry = DATA_BUF_NONE;
+			dataBufLruList.tailEntry = dataBufMapPtr->dataBuf[evictedEntry].prevEntry;
+
+			dataBufMapPtr->dataBuf[evictedEntry].prevEntry = DATA_BUF_NONE;
+			dataBufMapPtr->dataBuf[evictedEntry].nextEntry = dataBufLruList.headEntry;
+			dataBufMapPtr->dataBuf[dataBufLruList.headEntry].prevEntry = evictedEntry;
+			dataBufLruList.headEntry = evictedEntry;
+
+		}
+		else
+		{
+			dataBufMapPtr->dataBuf[evictedEntry].prevEntry = DATA_BUF_NONE;
+			dataBufMapPtr->dataBuf[evictedEntry].nextEntry = DATA_BUF_NONE;
+			dataBufLruList.headEntry = evictedEntry;
+			dataBufLruList.tailEntry = evictedEntry;
+		}
+
+		//a partially written slice at a zone write pointer stays in the buffer until the host fills it
+		if((dataBufMapPtr->dataBuf[evictedEntry].dirty != DATA_BUF_DIRTY) || !IsZoneWritePointerSlice(dataBufMapPtr->dataBuf[evictedEntry].logicalSliceAddr))
+			break;
 	}
 
+	if(tryCnt == AVAILABLE_DATA_BUFFER_ENTRY_COUNT)
+		assert(!"[WARNING] All buffer entries are pinned by zone write pointers [WARNING]");
+
 	SelectiveGetFromDataBufHashList(evictedEntry);
 
 	return evictedEntry;
@@ -47,6 +47,7 @@
 #ifndef DATA_BUFFER_H_
 #define DATA_BUFFER_H_
 
+#include "xil_cache.h"
 #include "ftl_config.h"
 
 #define AVAILABLE_DATA_BUFFER_ENTRY_COUNT				(16 * USER_DIES)
@@ -59,6 +60,15 @@
 
 #define FindDataBufHashTableEntry(logicalSliceAddr) ((logicalSliceAddr) % AVAILABLE_DATA_BUFFER_ENTRY_COUNT)
 
+//a buffer read by a DMA engine is flushed before the DMA, a buffer written by a DMA engine is invalidated before the DMA and once more at its completion
+#if (CACHED_DATA_BUFFER == 1)
+#define FlushDataBuf(addr, size)		Xil_DCacheFlushRange((unsigned int)(addr), (size))
+#define InvalidateDataBuf(addr, size)	Xil_DCacheInvalidateRange((unsigned int)(addr), (size))
+#else
+#define FlushDataBuf(addr, size)		do { } while(0)
+#define InvalidateDataBuf(addr, size)	do { } while(0)
+#endif
+
 
 typedef struct _DATA_BUF_ENTRY {
 	unsigned int logicalSliceAddr;
@@ -102,6 +112,7 @@ typedef struct _TEMPORARY_DATA_BUF_MAP{
 
 void InitDataBuf();
 unsigned int CheckDataBufHit(unsigned int reqSlotTag);
+unsigned int FindDataBufEntry(unsigned int logicalSliceAddr);
 unsigned int AllocateDataBuf();
 void UpdateDataBufEntryInfoBlockingReq(unsigned int bufEntry, unsigned int reqSlotTag);
 
@@ -0,0 +1,259 @@
+//////////////////////////////////////////////////////////////////////////////////
+// ftl_benchmark.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: FTL Benchmark
+// File Name: ftl_benchmark.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - measure hot paths of the FTL with the global timer once the FTL is initialized
+//   - enabled by FTL_BENCHMARK
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "xil_printf.h"
+#include "xtime_l.h"
+#include "memory_map.h"
+#include "ftl_benchmark.h"
+#include "hot_path_profile.h"
+
+//queue of the previous implementation, threaded through prevReq and nextReq of the request pool
+static void PutToListReqQ(P_BENCHMARK_LIST_REQUEST_QUEUE listReqQ, unsigned int reqSlotTag)
+{
+	if(listReqQ->tailReq != REQ_SLOT_TAG_NONE)
+	{
+		reqPoolPtr->reqPool[reqSlotTag].prevReq = listReqQ->tailReq;
+		reqPoolPtr->reqPool[reqSlotTag].nextReq = REQ_SLOT_TAG_NONE;
+		reqPoolPtr->reqPool[listReqQ->tailReq].nextReq = reqSlotTag;
+		listReqQ->tailReq = reqSlotTag;
+	}
+	else
+	{
+		reqPoolPtr->reqPool[reqSlotTag].prevReq = REQ_SLOT_TAG_NONE;
+		reqPoolPtr->reqPool[reqSlotTag].nextReq = REQ_SLOT_TAG_NONE;
+		listReqQ->headReq = reqSlotTag;
+		listReqQ->tailReq = reqSlotTag;
+	}
+
+	reqPoolPtr->reqPool[reqSlotTag].reqQueueType =  REQ_QUEUE_TYPE_SLICE;
+	listReqQ->reqCnt++;
+}
+
+static unsigned int GetFromListReqQ(P_BENCHMARK_LIST_REQUEST_QUEUE listReqQ)
+{
+	unsigned int reqSlotTag;
+
+	reqSlotTag = listReqQ->headReq;
+
+	if(reqSlotTag == REQ_SLOT_TAG_NONE)
+		return REQ_SLOT_TAG_FAIL;
+
+	if(reqPoolPtr->reqPool[reqSlotTag].nextReq != REQ_SLOT_TAG_NONE)
+	{
+		listReqQ->headReq = reqPoolPtr->reqPool[reqSlotTag].nextReq;
+		reqPoolPtr->reqPool[reqPoolPtr->reqPool[reqSlotTag].nextReq].prevReq = REQ_SLOT_TAG_NONE;
+	}
+	else
+	{
+		listReqQ->headReq = REQ_SLOT_TAG_NONE;
+		listReqQ->tailReq = REQ_SLOT_TAG_NONE;
+	}
+
+	reqPoolPtr->reqPool[reqSlotTag].reqQueueType =  REQ_QUEUE_TYPE_NONE;
+	listReqQ->reqCnt--;
+
+	return reqSlotTag;
+}
+
+static unsigned int TicksPerKiloOps(XTime startTime, XTime endTime, unsigned int opCnt)
+{
+	return (unsigned int)(((endTime - startTime) * 1000) / opCnt);
+}
+
+static unsigned int MbPerSecond(XTime startTime, XTime endTime, unsigned int byteCnt)
+{
+	return (unsigned int)(((XTime)byteCnt * COUNTS_PER_SECOND) / ((endTime - startTime) * 1024 * 1024));
+}
+
+void RunFtlBenchmark()
+{
+	xil_printf("[ FTL benchmark (global timer ticks, %d ticks per second) ]\r\n", COUNTS_PER_SECOND);
+
+	SyncAllLowLevelReqDone();
+	BenchmarkReqQueue();
+	BenchmarkNandReqPath();
+	BenchmarkDataBufProcessing();
+}
+
+void BenchmarkReqQueue()
+{
+	BENCHMARK_LIST_REQUEST_QUEUE listFreeReqQ, listSliceReqQ;
+	XTime startTime, endTime;
+	unsigned int round, reqCnt, freeReqCnt, opCnt, ringTicks, listTicks;
+
+	//requests move from the free queue to the slice queue and back as in the request path
+	freeReqCnt = ReqRingCnt(freeReqQ);
+	opCnt = BENCHMARK_REQ_QUEUE_ROUNDS * freeReqCnt * 4;
+
+	XTime_GetTime(&startTime);
+	for(round = 0; round < BENCHMARK_REQ_QUEUE_ROUNDS; round++)
+	{
+		for(reqCnt = 0; reqCnt < freeReqCnt; reqCnt++)
+			PutToSliceReqQ(GetFromFreeReqQ());
+		for(reqCnt = 0; reqCnt < freeReqCnt; reqCnt++)
+			PutToFreeReqQ(GetFromSliceReqQ());
+	}
+	XTime_GetTime(&endTime);
+	ringTicks = TicksPerKiloOps(startTime, endTime, opCnt);
+
+	listFreeReqQ.headReq = REQ_SLOT_TAG_NONE;
+	listFreeReqQ.tailReq = REQ_SLOT_TAG_NONE;
+	listFreeReqQ.reqCnt = 0;
+	listSliceReqQ.headReq = REQ_SLOT_TAG_NONE;
+	listSliceReqQ.tailReq = REQ_SLOT_TAG_NONE;
+	listSliceReqQ.reqCnt = 0;
+	for(reqCnt = 0; reqCnt < freeReqCnt; reqCnt++)
+		PutToListReqQ(&listFreeReqQ, GetFromFreeReqQ());
+
+	XTime_GetTime(&startTime);
+	for(round = 0; round < BENCHMARK_REQ_QUEUE_ROUNDS; round++)
+	{
+		for(reqCnt = 0; reqCnt < freeReqCnt; reqCnt++)
+			PutToListReqQ(&listSliceReqQ, GetFromListReqQ(&listFreeReqQ));
+		for(reqCnt = 0; reqCnt < freeReqCnt; reqCnt++)
+			PutToListReqQ(&listFreeReqQ, GetFromListReqQ(&listSliceReqQ));
+	}
+	XTime_GetTime(&endTime);
+	listTicks = TicksPerKiloOps(startTime, endTime, opCnt);
+
+	for(reqCnt = 0; reqCnt < freeReqCnt; reqCnt++)
+		PutToFreeReqQ(GetFromListReqQ(&listFreeReqQ));
+
+	xil_printf("  request queue ring        : %d ticks per 1000 operations\r\n", ringTicks);
+	xil_printf("  request queue linked list : %d ticks per 1000 operations\r\n", listTicks);
+}
+
+void BenchmarkNandReqPath()
+{
+	unsigned int round, chNo, wayNo, reqSlotTag, reqStatus, startCycle;
+	unsigned int selectCycles, selectCnt, executeCycles, executeCnt;
+
+	//page 0 of physical block 0 of every die is read with ECC off, the scheduler path is driven by hand so each call is timed alone
+	selectCycles = 0;
+	selectCnt = 0;
+	executeCycles = 0;
+	executeCnt = 0;
+	for(round = 0; round < BENCHMARK_NAND_REQ_ROUNDS; round++)
+	{
+		for(chNo = 0; chNo < USER_CHANNELS; chNo++)
+			for(wayNo = 0; wayNo < USER_WAYS; wayNo++)
+			{
+				reqSlotTag = GetFromFreeReqQ();
+
+				reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
+				reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_PHY_ORG;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_ADDR;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_OFF;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_OFF;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_NONE;
+				reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_TOTAL;
+				reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.addr = RESERVED_DATA_BUFFER_BASE_ADDR;
+				reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalCh = chNo;
+				reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalWay = wayNo;
+				reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalBlock = 0;
+				reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalPage = 0;
+				reqPoolPtr->reqPool[reqSlotTag].prevBlockingReq = REQ_SLOT_TAG_NONE;
+
+				startCycle = ReadCycleCounter();
+				SelectLowLevelReqQ(reqSlotTag);
+				selectCycles += ReadCycleCounter() - startCycle;
+				selectCnt++;
+			}
+
+		for(chNo = 0; chNo < USER_CHANNELS; chNo++)
+			for(wayNo = 0; wayNo < USER_WAYS; wayNo++)
+				while(nandReqQ[chNo][wayNo].headReq != REQ_SLOT_TAG_NONE)
+				{
+					reqStatus = REQ_STATUS_RUNNING;
+					if(dieStateTablePtr->dieState[chNo][wayNo].dieState == DIE_STATE_EXE)
+					{
+						while(!V2FWayReady(V2FReadyBusyAsync(&chCtlReg[chNo]), wayNo))
+							;
+						reqStatus = CheckReqStatus(chNo, wayNo);
+					}
+
+					startCycle = ReadCycleCounter();
+					ExecuteNandReq(chNo, wayNo, reqStatus);
+					executeCycles += ReadCycleCounter() - startCycle;
+					executeCnt++;
+				}
+	}
+
+	xil_printf("  SelectLowLevelReqQ        : %d cycles per call (%d calls)\r\n", selectCycles / selectCnt, selectCnt);
+	xil_printf("  ExecuteNandReq            : %d cycles per call (%d calls)\r\n", executeCycles / executeCnt, executeCnt);
+}
+
+void BenchmarkDataBufProcessing()
+{
+	XTime startTime, endTime;
+	unsigned int round, bufEntry, wordNo, checksum, byteCnt, scanMbps, fillMbps;
+	unsigned int* buf;
+
+	//entries are checksummed as after a NAND read and filled as before a NAND program, the cache maintenance of the DMA path is included
+	byteCnt = BENCHMARK_DATA_BUF_ROUNDS * AVAILABLE_DATA_BUFFER_ENTRY_COUNT * BYTES_PER_DATA_REGION_OF_SLICE;
+	checksum = 0;
+
+	XTime_GetTime(&startTime);
+	for(round = 0; round < BENCHMARK_DATA_BUF_ROUNDS; round++)
+		for(bufEntry = 0; bufEntry < AVAILABLE_DATA_BUFFER_ENTRY_COUNT; bufEntry++)
+		{
+			buf = (unsigned int*)(DATA_BUFFER_BASE_ADDR + bufEntry * BYTES_PER_DATA_REGION_OF_SLICE);
+			InvalidateDataBuf(buf, BYTES_PER_DATA_REGION_OF_SLICE);
+			for(wordNo = 0; wordNo < BYTES_PER_DATA_REGION_OF_SLICE / sizeof(unsigned int); wordNo++)
+				checksum += buf[wordNo];
+		}
+	XTime_GetTime(&endTime);
+	scanMbps = MbPerSecond(startTime, endTime, byteCnt);
+
+	XTime_GetTime(&startTime);
+	for(round = 0; round < BENCHMARK_DATA_BUF_ROUNDS; round++)
+		for(bufEntry = 0; bufEntry < AVAILABLE_DATA_BUFFER_ENTRY_COUNT; bufEntry++)
+		{
+			buf = (unsigned int*)(DATA_BUFFER_BASE_ADDR + bufEntry * BYTES_PER_DATA_REGION_OF_SLICE);
+			for(wordNo = 0; wordNo < BYTES_PER_DATA_REGION_OF_SLICE / sizeof(unsigned int); wordNo++)
+				buf[wordNo] = wordNo ^ checksum;
+			FlushDataBuf(buf, BYTES_PER_DATA_REGION_OF_SLICE);
+		}
+	XTime_GetTime(&endTime);
+	fillMbps = MbPerSecond(startTime, endTime, byteCnt);
+
+	xil_printf("  data buffer (%s)    : checksum %d MB/s, fill %d MB/s (checksum 0x%X)\r\n", (CACHED_DATA_BUFFER == 1) ? "cached  " : "uncached", scanMbps, fillMbps, checksum);
+}
@@ -0,0 +1,63 @@
+//////////////////////////////////////////////////////////////////////////////////
+// ftl_benchmark.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: FTL Benchmark
+// File Name: ftl_benchmark.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - define parameters, data structure and functions of FTL benchmark
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef FTL_BENCHMARK_H_
+#define FTL_BENCHMARK_H_
+
+#include "ftl_config.h"
+
+#define BENCHMARK_REQ_QUEUE_ROUNDS		16
+#define BENCHMARK_NAND_REQ_ROUNDS		64
+#define BENCHMARK_DATA_BUF_ROUNDS		8
+
+typedef struct _BENCHMARK_LIST_REQUEST_QUEUE
+{
+	unsigned int headReq : 16;
+	unsigned int tailReq : 16;
+	unsigned int reqCnt : 16;
+	unsigned int reserved0 : 16;
+} BENCHMARK_LIST_REQUEST_QUEUE, *P_BENCHMARK_LIST_REQUEST_QUEUE;
+
+void RunFtlBenchmark();
+void BenchmarkReqQueue();
+void BenchmarkNandReqPath();
+void BenchmarkDataBufProcessing();
+
+#endif /* FTL_BENCHMARK_H_ */
@@ -49,30 +49,77 @@
 
 #include <assert.h>
 #include "xil_printf.h"
+#include "xtime_l.h"
 #include "memory_map.h"
+#include "ftl_benchmark.h"
 #include "t4nsc_ucode.h"
 #include "nsc_driver.h"
 
 unsigned int storageCapacity_L;
 T4REGS chCtlReg[USER_CHANNELS];
 
+static XTime initStepStartTime;
+static unsigned int initTimeUs;
+
+void StartInitStep()
+{
+	XTime_GetTime(&initStepStartTime);
+}
+
+void EndInitStep(char* stepName)
+{
+	XTime currentTime;
+	unsigned int stepTimeUs;
+
+	XTime_GetTime(&currentTime);
+	stepTimeUs = (unsigned int)((currentTime - initStepStartTime) / (COUNTS_PER_SECOND / 1000000));
+	initTimeUs += stepTimeUs;
+	initStepStartTime = currentTime;
+
+	xil_printf("[ init %s: %d us ]\r\n", stepName, stepTimeUs);
+}
+
 void InitFTL()
 {
+	initTimeUs = 0;
+	StartInitStep();
+
 	CheckConfigRestriction();
+	InitHotPathProfile();
+	InitFtlStatistics();
+	InitCmdLatencyTrace();
+	InitNandUtilization();
+	EndInitStep("telemetry");
 
 	InitChCtlReg();
+	EndInitStep("channel controller");
 	InitReqPool();
 	InitDependencyTable();
+	InitDeferredNvmeCpl();
 	InitReqScheduler();
+	EndInitStep("request pool and scheduler");
 	InitNandArray();
+	EndInitStep("NAND reset");
 	InitAddressMap();
+	EndInitStep("block map");
 	InitDataBuf();
+	EndInitStep("data buffer");
 	InitGcVictimMap();
+	InitBlockRefreshMap();
+	EndInitStep("GC victim and refresh map");
 
-	storageCapacity_L = (MB_PER_SSD - (MB_PER_MIN_FREE_BLOCK_SPACE + mbPerbadBlockSpace + MB_PER_OVER_PROVISION_BLOCK_SPACE)) * ((1024*1024) / BYTES_PER_NVME_BLOCK);
+	storageCapacity_L = (MB_PER_SSD - (MB_PER_MIN_FREE_BLOCK_SPACE + mbPerbadBlockSpace + MB_PER_OVER_PROVISION_BLOCK_SPACE + MB_PER_PHY_IO_BLOCK_SPACE)) * ((1024*1024) / BYTES_PER_NVME_BLOCK);
 
 	xil_printf("[ storage capacity %d MB ]\r\n", storageCapacity_L / ((1024*1024) / BYTES_PER_NVME_BLOCK));
-	xil_printf("[ ftl configuration complete. ]\r\n");
+
+	InitZoneMap();
+	InitKvStore();
+	EndInitStep("zone map and key value index");
+	xil_printf("[ ftl configuration complete in %d ms (key input excluded). ]\r\n", initTimeUs / 1000);
+
+#if (FTL_BENCHMARK == 1)
+	RunFtlBenchmark();
+#endif
 }
 
 static void nfc_install_ucode(unsigned int* bram0)
@@ -195,13 +242,41 @@ void CheckConfigRestriction()
 		assert(!"[WARNING] Configuration Error: WAY [WARNING]");
 	if(USER_BLOCKS_PER_LUN > MAIN_BLOCKS_PER_LUN)
 		assert(!"[WARNING] Configuration Error: BLOCK [WARNING]");
+	if(PHY_IO_BLOCKS_PER_DIE >= USER_BLOCKS_PER_DIE)
+		assert(!"[WARNING] Configuration Error: physical I/O blocks leave no block to the FTL [WARNING]");
 	if((BITS_PER_FLASH_CELL != SLC_MODE))
 		assert(!"[WARNING] Configuration Error: BIT_PER_FLASH_CELL [WARNING]");
 
-	if(RESERVED_DATA_BUFFER_BASE_ADDR + 0x00200000 > COMPLETE_FLAG_TABLE_ADDR)
+	if(PHY_IO_DATA_BUFFER_END_ADDR > COMPLETE_FLAG_TABLE_ADDR)
 		assert(!"[WARNING] Configuration Error: Data buffer size is too large to be allocated to predefined range [WARNING]");
 	if(TEMPORARY_PAY_LOAD_ADDR + 0x00001000 > DATA_BUFFER_MAP_ADDR)
 		assert(!"[WARNING] Configuration Error: Metadata for NAND request completion process is too large to be allocated to predefined range [WARNING]");
+	if((READ_RETRY_PAY_LOAD_TABLE_ADDR + sizeof(READ_RETRY_PAY_LOAD_TABLE) > ZONE_REPORT_BUFFER_ADDR) || (PHY_ADDR_LIST_ADDR + MAX_PHY_ADDRS_PER_CMD * sizeof(IO_PHY_ADDR) > DATA_BUFFER_MAP_ADDR))
+		assert(!"[WARNING] Configuration Error: Zone report buffer or physical address list is not allocated to predefined range [WARNING]");
+	if(KV_LIST_BUFFER_ADDR + KV_LIST_BUFFER_SIZE > DATA_BUFFER_MAP_ADDR)
+		assert(!"[WARNING] Configuration Error: Key list buffer is not allocated to predefined range [WARNING]");
+	if(SCAN_RESULT_BUFFER_ADDR + SCAN_RESULT_BUFFER_SIZE > DATA_BUFFER_MAP_ADDR)
+		assert(!"[WARNING] Configuration Error: Scan result buffer is not allocated to predefined range [WARNING]");
+	if(COMPARE_BUFFER_ADDR + COMPARE_BUFFER_SIZE > DATA_BUFFER_MAP_ADDR)
+		assert(!"[WARNING] Configuration Error: Compare buffer is not allocated to predefined range [WARNING]");
+	if(ZONED_NAMESPACE_ID > USER_NAMESPACES)
+		assert(!"[WARNING] Configuration Error: ZONED_NAMESPACE_ID [WARNING]");
+	if((KV_NAMESPACE_ID > USER_NAMESPACES) || (KV_NAMESPACE_ID && (KV_NAMESPACE_ID == ZONED_NAMESPACE_ID)))
+		assert(!"[WARNING] Configuration Error: KV_NAMESPACE_ID [WARNING]");
+	if(sizeof(SSD_REQ_FORMAT) != BYTES_PER_REQ_POOL_ENTRY)
+		assert(!"[WARNING] Configuration Error: SSD_REQ_FORMAT [WARNING]");
+	if((REQ_RING_ENTRY_COUNT < AVAILABLE_OUNTSTANDING_REQ_COUNT) || (REQ_RING_ENTRY_COUNT & (REQ_RING_ENTRY_COUNT - 1)))
+		assert(!"[WARNING] Configuration Error: REQ_RING_ENTRY_COUNT [WARNING]");
+	if((HOST_IPC_ADDR + sizeof(HOST_IPC) - 1) > NVME_MANAGEMENT_END_ADDR)
+		assert(!"[WARNING] Configuration Error: Host interface to FTL core channel is not allocated to predefined range [WARNING]");
+	if((HOT_PATH_PROFILE_TABLE_ADDR + sizeof(HOT_PATH_PROFILE_TABLE) - 1) > NVME_MANAGEMENT_END_ADDR)
+		assert(!"[WARNING] Configuration Error: Hot path profile table is not allocated to predefined range [WARNING]");
+	if((FTL_STATISTICS_TABLE_ADDR + sizeof(FTL_STATISTICS_TABLE) - 1) > NVME_MANAGEMENT_END_ADDR)
+		assert(!"[WARNING] Configuration Error: FTL statistics table is not allocated to predefined range [WARNING]");
+	if((CMD_LATENCY_TABLE_ADDR + sizeof(CMD_LATENCY_TABLE) - 1) > NVME_MANAGEMENT_END_ADDR)
+		assert(!"[WARNING] Configuration Error: Command latency table is not allocated to predefined range [WARNING]");
+	if((NAND_UTILIZATION_TABLE_ADDR + sizeof(NAND_UTILIZATION_TABLE) - 1) > NVME_MANAGEMENT_END_ADDR)
+		assert(!"[WARNING] Configuration Error: NAND utilization table is not allocated to predefined range [WARNING]");
 	if(FTL_MANAGEMENT_END_ADDR > DRAM_END_ADDR)
 		assert(!"[WARNING] Configuration Error: Metadata of FTL is too large to be allocated to DRAM [WARNING]");
 }
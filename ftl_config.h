@@ -213,6 +213,14 @@
 #define NVME_BLOCKS_PER_SLICE		(BYTES_PER_DATA_REGION_OF_SLICE / BYTES_PER_NVME_BLOCK)
 
 #define	USER_DIES					(USER_CHANNELS * USER_WAYS)
+#define	USER_NAMESPACES				(USER_CHANNELS)		//namespaces equally divide the storage capacity
+#define	ZONED_NAMESPACE_ID			0					//namespace exposed with the zoned namespace command set, 0 means none
+#define	KV_NAMESPACE_ID				0					//namespace exposed with the key value command set, 0 means none
+#define	FTL_BENCHMARK				0					//1: microbenchmarks run once the FTL is initialized
+#define	HOT_PATH_PROFILE			0					//1: cycles of IO path stages are counted, read by the host with a vendor log page
+#define	CMD_LATENCY_TRACE			0					//1: latencies of IO commands and waits of the slowest ones are traced, read by the host with a vendor log page
+#define	NAND_UTILIZATION_MONITOR	0					//1: busy time and queue depth of dies and channels are counted, read by the host with a vendor log page
+#define	CACHED_DATA_BUFFER			0					//1: data buffers are cached, the FTL core cleans and invalidates them around NAND and host DMA
 
 #define	USER_PAGES_PER_BLOCK		(PAGES_PER_SLC_BLOCK * BITS_PER_FLASH_CELL)
 #define	USER_PAGES_PER_LUN			(USER_PAGES_PER_BLOCK * USER_BLOCKS_PER_LUN)
@@ -230,14 +238,20 @@
 #define	USER_BLOCKS_PER_CHANNEL		(USER_BLOCKS_PER_DIE * USER_WAYS)
 #define	USER_BLOCKS_PER_SSD			(USER_BLOCKS_PER_CHANNEL * USER_CHANNELS)
 
+#define	PHY_IO_BLOCKS_PER_DIE		0			//the last user blocks of a die are left to physical address I/O, the FTL never allocates them, 0 means none
+#define	FTL_BLOCKS_PER_DIE			(USER_BLOCKS_PER_DIE - PHY_IO_BLOCKS_PER_DIE)
+
 #define	MB_PER_BLOCK						((BYTES_PER_DATA_REGION_OF_SLICE * SLICES_PER_BLOCK) / (1024 * 1024))
 #define MB_PER_SSD							(USER_BLOCKS_PER_SSD * MB_PER_BLOCK)
 #define MB_PER_MIN_FREE_BLOCK_SPACE			(USER_DIES * MB_PER_BLOCK)
 #define MB_PER_METADATA_BLOCK_SPACE			(USER_DIES * MB_PER_BLOCK)
 #define MB_PER_OVER_PROVISION_BLOCK_SPACE	((USER_BLOCKS_PER_SSD / 10) * MB_PER_BLOCK)
+#define MB_PER_PHY_IO_BLOCK_SPACE			(USER_DIES * PHY_IO_BLOCKS_PER_DIE * MB_PER_BLOCK)
 
 
 void InitFTL();
+void StartInitStep();
+void EndInitStep(char* stepName);
 void InitChCtlReg();
 void InitNandArray();
 void CheckConfigRestriction();
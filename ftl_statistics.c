@@ -0,0 +1,149 @@
+//////////////////////////////////////////////////////////////////////////////////
+// ftl_statistics.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: FTL Statistics
+// File Name: ftl_statistics.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - count host IO and FTL internals (GC, data buffer, read retry, erase) on the hot path
+//   - publish the counters to memory shared with the host interface core on request
+//   - make the SMART / health information log and a vendor specific FTL statistics log
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "xil_printf.h"
+#include <string.h>
+#include "xtime_l.h"
+#include "memory_map.h"
+#include "nvme/nvme.h"
+
+FTL_STATISTICS ftlStatistics;
+P_FTL_STATISTICS_TABLE ftlStatisticsTablePtr = (P_FTL_STATISTICS_TABLE) FTL_STATISTICS_TABLE_ADDR;
+
+void InitFtlStatistics()
+{
+	memset(&ftlStatistics, 0, sizeof(FTL_STATISTICS));
+
+	memset(ftlStatisticsTablePtr, 0, sizeof(FTL_STATISTICS_TABLE));
+	ftlStatisticsTablePtr->dieCnt = USER_DIES;
+	ftlStatisticsTablePtr->availableSpare = 100;
+}
+
+void PublishFtlStatistics()
+{
+	unsigned int dieNo, worstGrownBadBlockCnt;
+	XTime currentTime;
+
+	XTime_GetTime(&currentTime);
+	ftlStatisticsTablePtr->upTimeSec = currentTime / COUNTS_PER_SECOND;
+
+	//host writes are counted in NVMe blocks and NAND programs in slices
+	if(ftlStatistics.hostWriteNvmeBlockCnt)
+		ftlStatisticsTablePtr->writeAmplification = (ftlStatistics.nandWriteSliceCnt * NVME_BLOCKS_PER_SLICE * 1000) / ftlStatistics.hostWriteNvmeBlockCnt;
+	if(ftlStatistics.dataBufHitCnt + ftlStatistics.dataBufMissCnt)
+		ftlStatisticsTablePtr->dataBufHitRate = (ftlStatistics.dataBufHitCnt * 1000) / (ftlStatistics.dataBufHitCnt + ftlStatistics.dataBufMissCnt);
+
+	ftlStatisticsTablePtr->avgEraseCnt = ftlStatistics.totalEraseCnt / USER_BLOCKS_PER_SSD;
+	ftlStatisticsTablePtr->percentageUsed = (ftlStatisticsTablePtr->avgEraseCnt * 100) / NAND_ENDURANCE_PE_CYCLES;
+
+	//the die with the most grown bad blocks runs out of spare blocks first
+	worstGrownBadBlockCnt = 0;
+	for(dieNo = 0; dieNo < USER_DIES; dieNo++)
+	{
+		if(ftlStatistics.grownBadBlockCnt[dieNo] > worstGrownBadBlockCnt)
+			worstGrownBadBlockCnt = ftlStatistics.grownBadBlockCnt[dieNo];
+
+		ftlStatisticsTablePtr->freeBlockCnt[dieNo] = virtualDieMapPtr->die[dieNo].freeBlockCnt;
+	}
+
+	if(worstGrownBadBlockCnt < SPARE_BLOCKS_PER_DIE)
+		ftlStatisticsTablePtr->availableSpare = 100 - (worstGrownBadBlockCnt * 100) / SPARE_BLOCKS_PER_DIE;
+	else
+		ftlStatisticsTablePtr->availableSpare = 0;
+
+	memcpy(&ftlStatisticsTablePtr->counters, &ftlStatistics, sizeof(FTL_STATISTICS));
+
+	PublishCmdLatencyTrace();
+	PublishNandUtilization();
+}
+
+static void SetSmartCounter(unsigned int* counter, unsigned long long value)
+{
+	counter[0] = (unsigned int)value;
+	counter[1] = (unsigned int)(value >> 32);
+	counter[2] = 0;
+	counter[3] = 0;
+}
+
+static unsigned long long NvmeBlocksToDataUnits(unsigned long long nvmeBlockCnt)
+{
+	//a data unit is 1000 512 byte units, rounded up
+	return (nvmeBlockCnt * (BYTES_PER_NVME_BLOCK / 512) + 999) / 1000;
+}
+
+unsigned int MakeSmartHealthLog(unsigned int bufAddr)
+{
+	NVME_SMART_HEALTH_LOG* smartLog;
+	P_FTL_STATISTICS counters;
+
+	smartLog = (NVME_SMART_HEALTH_LOG*)bufAddr;
+	counters = &ftlStatisticsTablePtr->counters;
+
+	smartLog->availableSpare = ftlStatisticsTablePtr->availableSpare;
+	smartLog->availableSpareThreshold = AVAILABLE_SPARE_THRESHOLD;
+	if(ftlStatisticsTablePtr->percentageUsed > 255)
+		smartLog->percentageUsed = 255;
+	else
+		smartLog->percentageUsed = ftlStatisticsTablePtr->percentageUsed;
+
+	smartLog->criticalWarning = 0;
+	if(smartLog->availableSpare < smartLog->availableSpareThreshold)
+		smartLog->criticalWarning |= SMART_CRITICAL_WARNING_AVAILABLE_SPARE;
+
+	//no temperature sensor is read, a fixed nominal temperature keeps hosts from seeing 0 Kelvin
+	smartLog->compositeTemperature = NOMINAL_COMPOSITE_TEMPERATURE;
+
+	SetSmartCounter(smartLog->dataUnitsRead, NvmeBlocksToDataUnits(counters->hostReadNvmeBlockCnt));
+	SetSmartCounter(smartLog->dataUnitsWritten, NvmeBlocksToDataUnits(counters->hostWriteNvmeBlockCnt));
+	SetSmartCounter(smartLog->hostReadCommands, counters->hostReadCmdCnt);
+	SetSmartCounter(smartLog->hostWriteCommands, counters->hostWriteCmdCnt);
+	SetSmartCounter(smartLog->powerOnHours, ftlStatisticsTablePtr->upTimeSec / 3600);
+	SetSmartCounter(smartLog->mediaErrors, counters->mediaErrorCnt);
+
+	return sizeof(NVME_SMART_HEALTH_LOG);
+}
+
+unsigned int MakeFtlStatisticsLog(unsigned int bufAddr)
+{
+	memcpy((void*)bufAddr, ftlStatisticsTablePtr, sizeof(FTL_STATISTICS_TABLE));
+
+	return sizeof(FTL_STATISTICS_TABLE);
+}
@@ -0,0 +1,93 @@
+//////////////////////////////////////////////////////////////////////////////////
+// ftl_statistics.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: FTL Statistics
+// File Name: ftl_statistics.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - define counters of host IO and FTL internals and their log page layouts
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef FTL_STATISTICS_H_
+#define FTL_STATISTICS_H_
+
+#include "ftl_config.h"
+
+#define NAND_ENDURANCE_PE_CYCLES			((BITS_PER_FLASH_CELL == SLC_MODE) ? 30000 : 3000)	//nominal program/erase cycles of a block
+#define SPARE_BLOCKS_PER_DIE				(USER_BLOCKS_PER_DIE / 10)		//over-provisioned blocks absorbing grown bad blocks
+#define AVAILABLE_SPARE_THRESHOLD			10								//percent
+#define SPARE_THRESHOLD_GROWN_BAD_BLOCKS	(((100 - AVAILABLE_SPARE_THRESHOLD + 1) * SPARE_BLOCKS_PER_DIE + 99) / 100)	//available spare falls below the threshold
+#define NOMINAL_COMPOSITE_TEMPERATURE		(273 + 40)						//Kelvin, reported without a sensor
+#define WEAR_EVENT_STEP						10								//percent used between wear level events
+#define WEAR_EVENT_ERASE_CNT				((unsigned long long)USER_BLOCKS_PER_SSD * NAND_ENDURANCE_PE_CYCLES * WEAR_EVENT_STEP / 100)
+
+// counters are updated by the FTL on the hot path, they stay in cached memory of the FTL
+typedef struct _FTL_STATISTICS {
+	unsigned long long hostReadCmdCnt;
+	unsigned long long hostWriteCmdCnt;
+	unsigned long long hostReadNvmeBlockCnt;
+	unsigned long long hostWriteNvmeBlockCnt;
+	unsigned long long nandWriteSliceCnt;		//programs of host data, GC copies and metadata
+	unsigned long long gcCopySliceCnt;			//slices moved by GC and block refresh
+	unsigned long long dataBufHitCnt;
+	unsigned long long dataBufMissCnt;
+	unsigned long long totalEraseCnt;
+	unsigned int gcCnt;
+	unsigned int readRetryCnt;
+	unsigned int mediaErrorCnt;					//reads failing ECC at every read retry level
+	unsigned int maxEraseCnt;
+	unsigned int grownBadBlockCnt[USER_DIES];
+} FTL_STATISTICS, *P_FTL_STATISTICS;
+
+// layout of the FTL statistics log page, published to memory shared with the host interface core
+typedef struct _FTL_STATISTICS_TABLE {
+	unsigned int dieCnt;
+	unsigned int upTimeSec;
+	unsigned int writeAmplification;			//x1000
+	unsigned int dataBufHitRate;				//x1000
+	unsigned int avgEraseCnt;
+	unsigned int availableSpare;				//percent
+	unsigned int percentageUsed;
+	unsigned int reserved0;
+	FTL_STATISTICS counters;
+	unsigned int freeBlockCnt[USER_DIES];
+} FTL_STATISTICS_TABLE, *P_FTL_STATISTICS_TABLE;
+
+void InitFtlStatistics();
+void PublishFtlStatistics();
+unsigned int MakeSmartHealthLog(unsigned int bufAddr);
+unsigned int MakeFtlStatisticsLog(unsigned int bufAddr);
+
+extern FTL_STATISTICS ftlStatistics;
+extern P_FTL_STATISTICS_TABLE ftlStatisticsTablePtr;
+
+#endif /* FTL_STATISTICS_H_ */
@@ -50,6 +50,7 @@
 #include "memory_map.h"
 
 P_GC_VICTIM_MAP gcVictimMapPtr;
+P_BLOCK_REFRESH_MAP blockRefreshMapPtr;
 
 void InitGcVictimMap()
 {
@@ -70,9 +71,23 @@ void InitGcVictimMap()
 
 void GarbageCollection(unsigned int dieNo)
 {
-	unsigned int victimBlockNo, pageNo, virtualSliceAddr, logicalSliceAddr, dieNoForGcCopy, reqSlotTag;
+	unsigned int victimBlockNo;
+
+	CmdLatencyTraceGcBegin();
 
 	victimBlockNo = GetFromGcVictimList(dieNo);
+	ftlStatistics.gcCnt++;
+
+	MigrateValidSlices(dieNo, victimBlockNo);
+
+	CmdLatencyTraceGcEnd();
+}
+
+
+void MigrateValidSlices(unsigned int dieNo, unsigned int victimBlockNo)
+{
+	unsigned int pageNo, virtualSliceAddr, logicalSliceAddr, dieNoForGcCopy, reqSlotTag;
+
 	dieNoForGcCopy = dieNo;
 
 	if(virtualBlockMapPtr->block[dieNo][victimBlockNo].invalidSliceCnt != SLICES_PER_BLOCK)
@@ -90,7 +105,7 @@ void GarbageCollection(unsigned int dieNo)
 
 					reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
 					reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
-					reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = logicalSliceAddr;
+					reqPoolPtr->reqColdPool[reqSlotTag].logicalSliceAddr = logicalSliceAddr;
 					reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_TEMP_ENTRY;
 					reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
 					reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
@@ -108,7 +123,7 @@ void GarbageCollection(unsigned int dieNo)
 
 					reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
 					reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_WRITE;
-					reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = logicalSliceAddr;
+					reqPoolPtr->reqColdPool[reqSlotTag].logicalSliceAddr = logicalSliceAddr;
 					reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_TEMP_ENTRY;
 					reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
 					reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
@@ -123,6 +138,7 @@ void GarbageCollection(unsigned int dieNo)
 					virtualSliceMapPtr->virtualSlice[reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr].logicalSliceAddr = logicalSliceAddr;
 
 					SelectLowLevelReqQ(reqSlotTag);
+					ftlStatistics.gcCopySliceCnt++;
 				}
 		}
 	}
@@ -131,6 +147,103 @@ void GarbageCollection(unsigned int dieNo)
 }
 
 
+void InitBlockRefreshMap()
+{
+	int dieNo, blockNo;
+
+	blockRefreshMapPtr = (P_BLOCK_REFRESH_MAP) BLOCK_REFRESH_MAP_ADDR;
+
+	for(dieNo=0 ; dieNo<USER_DIES; dieNo++)
+	{
+		for(blockNo=0 ; blockNo<USER_BLOCKS_PER_DIE; blockNo++)
+			ResetBlockReadHealth(dieNo, blockNo);
+
+		blockRefreshMapPtr->refreshQ[dieNo].head = 0;
+		blockRefreshMapPtr->refreshQ[dieNo].cnt = 0;
+	}
+
+	blockRefreshMapPtr->refreshDie = 0;
+	blockRefreshMapPtr->refreshedBlockCnt = 0;
+}
+
+
+void UpdateBlockReadHealth(unsigned int dieNo, unsigned int blockNo, unsigned int bitErrorCnt, unsigned int retryCnt)
+{
+	P_BLOCK_REFRESH_ENTRY refreshEntry;
+	P_REFRESH_QUEUE refreshQ;
+
+	refreshEntry = &blockRefreshMapPtr->block[dieNo][blockNo];
+
+	if(refreshEntry->readCnt < READ_CNT_MAX)
+		refreshEntry->readCnt++;
+	if(bitErrorCnt > refreshEntry->worstBitErrorCnt)
+		refreshEntry->worstBitErrorCnt = bitErrorCnt;
+
+	//zone slices stay at their offset in the zone block, the host rewrites the zone instead
+	if(refreshEntry->refreshBooked || virtualBlockMapPtr->block[dieNo][blockNo].zone)
+		return;
+
+	//a block is refreshed when it is read too often, its bit errors approach the ECC limit, or it needed a read retry
+	if((refreshEntry->readCnt >= READ_DISTURB_THRESHOLD) || (refreshEntry->worstBitErrorCnt >= REFRESH_BIT_ERROR_THRESHOLD) || retryCnt)
+	{
+		refreshQ = &blockRefreshMapPtr->refreshQ[dieNo];
+
+		//a full queue drops the booking, the next read of the block books it again
+		if(refreshQ->cnt == REFRESH_QUEUE_DEPTH)
+			return;
+
+		refreshQ->block[(refreshQ->head + refreshQ->cnt) % REFRESH_QUEUE_DEPTH] = blockNo;
+		refreshQ->cnt++;
+		refreshEntry->refreshBooked = 1;
+	}
+}
+
+
+void ResetBlockReadHealth(unsigned int dieNo, unsigned int blockNo)
+{
+	blockRefreshMapPtr->block[dieNo][blockNo].readCnt = 0;
+	blockRefreshMapPtr->block[dieNo][blockNo].worstBitErrorCnt = 0;
+	blockRefreshMapPtr->block[dieNo][blockNo].refreshBooked = 0;
+}
+
+
+void RefreshBlockOnIdle()
+{
+	P_REFRESH_QUEUE refreshQ;
+	unsigned int dieNo, blockNo, cnt;
+
+	dieNo = blockRefreshMapPtr->refreshDie;
+
+	for(cnt = 0; cnt < USER_DIES; cnt++)
+	{
+		refreshQ = &blockRefreshMapPtr->refreshQ[dieNo];
+
+		//data of a block is moved only when a free block is available besides the reserved one for GC
+		if(refreshQ->cnt && (virtualDieMapPtr->die[dieNo].freeBlockCnt > RESERVED_FREE_BLOCK_COUNT))
+		{
+			blockNo = refreshQ->block[refreshQ->head];
+			refreshQ->head = (refreshQ->head + 1) % REFRESH_QUEUE_DEPTH;
+			refreshQ->cnt--;
+			blockRefreshMapPtr->refreshDie = (dieNo + 1) % USER_DIES;
+
+			//the booking is cleared when the block has been erased by GC in the meantime
+			if(blockRefreshMapPtr->block[dieNo][blockNo].refreshBooked && !virtualBlockMapPtr->block[dieNo][blockNo].free)
+			{
+				if(virtualBlockMapPtr->block[dieNo][blockNo].invalidSliceCnt)
+					SelectiveGetFromGcVictimList(dieNo, blockNo);
+
+				MigrateValidSlices(dieNo, blockNo);
+				blockRefreshMapPtr->refreshedBlockCnt++;
+			}
+
+			return;
+		}
+
+		dieNo = (dieNo + 1) % USER_DIES;
+	}
+}
+
+
 void PutToGcVictimList(unsigned int dieNo, unsigned int blockNo, unsigned int invalidSliceCnt)
 {
 	if(gcVictimMapPtr->gcVictimList[dieNo][invalidSliceCnt].tailBlock != BLOCK_NONE)
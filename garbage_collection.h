@@ -49,6 +49,11 @@
 
 #include "ftl_config.h"
 
+#define READ_DISTURB_THRESHOLD			100000	//reads of a block until its data is refreshed
+#define REFRESH_BIT_ERROR_THRESHOLD		((BIT_ERROR_THRESHOLD_PER_CHUNK * 3) / 4)	//refresh a block before its bit errors reach the ECC warning
+#define REFRESH_QUEUE_DEPTH				16
+#define READ_CNT_MAX					0xFFFFF
+
 typedef struct _GC_VICTIM_LIST_ENTRY {
 	unsigned int headBlock : 16;
 	unsigned int tailBlock : 16;
@@ -58,14 +63,42 @@ typedef struct _GC_VICTIM_MAP {
 	GC_VICTIM_LIST_ENTRY gcVictimList[USER_DIES][SLICES_PER_BLOCK + 1];
 } GC_VICTIM_MAP, *P_GC_VICTIM_MAP;
 
+typedef struct _BLOCK_REFRESH_ENTRY {
+	unsigned int readCnt : 20;
+	unsigned int worstBitErrorCnt : 8;		//worst chunk bit error count since the last erase
+	unsigned int refreshBooked : 1;
+	unsigned int reserved0 : 3;
+} BLOCK_REFRESH_ENTRY, *P_BLOCK_REFRESH_ENTRY;
+
+typedef struct _REFRESH_QUEUE {
+	unsigned short block[REFRESH_QUEUE_DEPTH];
+	unsigned char head;
+	unsigned char cnt;
+	unsigned short reserved0;
+} REFRESH_QUEUE, *P_REFRESH_QUEUE;
+
+typedef struct _BLOCK_REFRESH_MAP {
+	BLOCK_REFRESH_ENTRY block[USER_DIES][USER_BLOCKS_PER_DIE];
+	REFRESH_QUEUE refreshQ[USER_DIES];
+	unsigned int refreshDie;				//die checked first by the next idle refresh
+	unsigned int refreshedBlockCnt;
+} BLOCK_REFRESH_MAP, *P_BLOCK_REFRESH_MAP;
+
 void InitGcVictimMap();
 void GarbageCollection(unsigned int dieNo);
+void MigrateValidSlices(unsigned int dieNo, unsigned int victimBlockNo);
+
+void InitBlockRefreshMap();
+void UpdateBlockReadHealth(unsigned int dieNo, unsigned int blockNo, unsigned int bitErrorCnt, unsigned int retryCnt);
+void ResetBlockReadHealth(unsigned int dieNo, unsigned int blockNo);
+void RefreshBlockOnIdle();
 
 void PutToGcVictimList(unsigned int dieNo, unsigned int blockNo, unsigned int invalidSliceCnt);
 unsigned int GetFromGcVictimList(unsigned int dieNo);
 void SelectiveGetFromGcVictimList(unsigned int dieNo, unsigned int blockNo);
 
 extern P_GC_VICTIM_MAP gcVictimMapPtr;
+extern P_BLOCK_REFRESH_MAP blockRefreshMapPtr;
 extern unsigned int gcTriggered;
 extern unsigned int copyCnt;
 
@@ -0,0 +1,99 @@
+//////////////////////////////////////////////////////////////////////////////////
+// hot_path_profile.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Hot Path Profiler
+// File Name: hot_path_profile.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - count cycles spent in the stages of the IO path with the PMU cycle counter
+//   - keep log2 histograms per stage, read by the host with a vendor specific log page
+//   - compiled in by HOT_PATH_PROFILE
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "xil_printf.h"
+#include <string.h>
+#include "xpseudo_asm.h"
+#include "memory_map.h"
+
+P_HOT_PATH_PROFILE_TABLE hotPathProfileTablePtr = (P_HOT_PATH_PROFILE_TABLE) HOT_PATH_PROFILE_TABLE_ADDR;
+unsigned int hotPathProfileStartCycle[HOT_PATH_PROFILE_STAGES];
+
+void InitCycleCounter()
+{
+	//enable and reset the cycle counter of the performance monitor unit
+	mtcp(XREG_CP15_PERF_MONITOR_CTRL, mfcp(XREG_CP15_PERF_MONITOR_CTRL) | PMU_CTRL_ENABLE | PMU_CTRL_CYCLE_COUNTER_RESET);
+	mtcp(XREG_CP15_COUNT_ENABLE_SET, PMU_CYCLE_COUNTER_ENABLE);
+}
+
+unsigned int ReadCycleCounter()
+{
+	return mfcp(XREG_CP15_PERF_CYCLE_COUNTER);
+}
+
+void InitHotPathProfile()
+{
+	unsigned int stage;
+
+	InitCycleCounter();
+
+	memset(hotPathProfileTablePtr, 0, sizeof(HOT_PATH_PROFILE_TABLE));
+	hotPathProfileTablePtr->enabled = HOT_PATH_PROFILE;
+	hotPathProfileTablePtr->stageCnt = HOT_PATH_PROFILE_STAGES;
+	hotPathProfileTablePtr->bucketCnt = HOT_PATH_PROFILE_BUCKETS;
+	for(stage = 0; stage < HOT_PATH_PROFILE_STAGES; stage++)
+		hotPathProfileTablePtr->stage[stage].minCycles = 0xffffffff;
+}
+
+void AddHotPathProfileSample(unsigned int stage, unsigned int cycles)
+{
+	P_HOT_PATH_PROFILE_STAGE stageProfile;
+
+	stageProfile = &hotPathProfileTablePtr->stage[stage];
+
+	stageProfile->callCnt++;
+	stageProfile->totalCycles += cycles;
+	if(cycles < stageProfile->minCycles)
+		stageProfile->minCycles = cycles;
+	if(cycles > stageProfile->maxCycles)
+		stageProfile->maxCycles = cycles;
+
+	//bucket n counts the calls taking 2^n to 2^(n+1)-1 cycles
+	stageProfile->histogram[31 - __builtin_clz(cycles | 1)]++;
+}
+
+unsigned int MakeHotPathProfileLog(unsigned int bufAddr)
+{
+	//a snapshot, the FTL core may update the table while it is copied
+	memcpy((void*)bufAddr, hotPathProfileTablePtr, sizeof(HOT_PATH_PROFILE_TABLE));
+
+	return sizeof(HOT_PATH_PROFILE_TABLE);
+}
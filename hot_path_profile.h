@@ -0,0 +1,97 @@
+//////////////////////////////////////////////////////////////////////////////////
+// hot_path_profile.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Hot Path Profiler
+// File Name: hot_path_profile.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - define parameters, data structure and functions of hot path profiler
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef HOT_PATH_PROFILE_H_
+#define HOT_PATH_PROFILE_H_
+
+#include "ftl_config.h"
+
+#define PMU_CTRL_ENABLE					0x1
+#define PMU_CTRL_CYCLE_COUNTER_RESET	0x4
+#define PMU_CYCLE_COUNTER_ENABLE		0x80000000
+
+#define HOT_PATH_PROFILE_STAGE_CMD_FETCH			0		//get_nvme_cmd() returning a command, host interface core
+#define HOT_PATH_PROFILE_STAGE_REQ_TRANS			1		//ReqTransNvmeToSlice()
+#define HOT_PATH_PROFILE_STAGE_BUF_LOOKUP			2		//CheckDataBufHit()
+#define HOT_PATH_PROFILE_STAGE_ADDR_TRANS_WRITE		3		//AddrTransWrite()
+#define HOT_PATH_PROFILE_STAGE_NAND_ISSUE			4		//IssueNandReq()
+#define HOT_PATH_PROFILE_STAGE_DMA_COMPLETION		5		//CheckDoneNvmeDmaReq()
+#define HOT_PATH_PROFILE_STAGES						6
+
+#define HOT_PATH_PROFILE_BUCKETS		32
+
+// stage timestamps are kept per stage, a stage is not entered again before it ends
+#if (HOT_PATH_PROFILE == 1)
+#define HotPathProfileBegin(stage) (hotPathProfileStartCycle[(stage)] = ReadCycleCounter())
+#define HotPathProfileEnd(stage) AddHotPathProfileSample((stage), ReadCycleCounter() - hotPathProfileStartCycle[(stage)])
+#else
+#define HotPathProfileBegin(stage)
+#define HotPathProfileEnd(stage)
+#endif
+
+typedef struct _HOT_PATH_PROFILE_STAGE {
+	unsigned int callCnt;
+	unsigned int minCycles;
+	unsigned int maxCycles;
+	unsigned int reserved0;
+	unsigned long long totalCycles;
+	unsigned int histogram[HOT_PATH_PROFILE_BUCKETS];
+} HOT_PATH_PROFILE_STAGE, *P_HOT_PATH_PROFILE_STAGE;
+
+// layout of the hot path profile log page
+typedef struct _HOT_PATH_PROFILE_TABLE {
+	unsigned int enabled;
+	unsigned int stageCnt;
+	unsigned int bucketCnt;
+	unsigned int reserved0;
+	HOT_PATH_PROFILE_STAGE stage[HOT_PATH_PROFILE_STAGES];
+} HOT_PATH_PROFILE_TABLE, *P_HOT_PATH_PROFILE_TABLE;
+
+void InitCycleCounter();
+unsigned int ReadCycleCounter();
+
+void InitHotPathProfile();
+void AddHotPathProfileSample(unsigned int stage, unsigned int cycles);
+unsigned int MakeHotPathProfileLog(unsigned int bufAddr);
+
+extern P_HOT_PATH_PROFILE_TABLE hotPathProfileTablePtr;
+extern unsigned int hotPathProfileStartCycle[HOT_PATH_PROFILE_STAGES];
+
+#endif /* HOT_PATH_PROFILE_H_ */
@@ -0,0 +1,351 @@
+//////////////////////////////////////////////////////////////////////////////////
+// key_value_store.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Key Value Store
+// File Name: key_value_store.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - serve a namespace with the key value command set
+//   - keep a hash index of keys in DRAM and pack values into the logical slices of the namespace
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "xil_printf.h"
+#include <assert.h>
+#include <string.h>
+#include "memory_map.h"
+
+P_KV_INDEX kvIndexPtr;
+P_KV_SLICE_MAP kvSliceMapPtr;
+
+void InitKvStore()
+{
+	kvIndexPtr = (P_KV_INDEX) KV_INDEX_ADDR;
+	kvSliceMapPtr = (P_KV_SLICE_MAP) KV_SLICE_MAP_ADDR;
+
+	//index entries are taken in order until the first delete, the free list holds deleted ones only
+	kvIndexPtr->freeEntry = KV_ENTRY_NONE;
+	kvIndexPtr->unusedEntry = 0;
+	kvIndexPtr->keyCnt = 0;
+
+	memset(kvIndexPtr->bucket, 0xFF, sizeof(kvIndexPtr->bucket));	//KV_ENTRY_NONE
+
+	if(KV_NAMESPACE_ID)
+		kvSliceMapPtr->sliceCnt = SLICES_PER_NAMESPACE;
+	else
+		kvSliceMapPtr->sliceCnt = 0;
+	kvSliceMapPtr->allocLba = 0;
+
+	memset(kvSliceMapPtr->liveBlockCnt, 0, sizeof(kvSliceMapPtr->liveBlockCnt));
+
+	if(kvSliceMapPtr->sliceCnt)
+		xil_printf("[ namespace %d is a key value store: %d keys ]\r\n", KV_NAMESPACE_ID, KV_INDEX_ENTRY_COUNT);
+}
+
+unsigned int KvStore(unsigned int cmdSlotTag, unsigned int* key, unsigned int keySize, unsigned int valueSize, unsigned int option)
+{
+	P_KV_INDEX_ENTRY entry;
+	unsigned int entryNo, numOfNvmeBlock, valueLba, bucketNo;
+
+	if(!keySize || (keySize > KV_MAX_KEY_SIZE))
+		return SC_KV_INVALID_KEY_SIZE;
+	if(!valueSize || (valueSize > KV_MAX_VALUE_SIZE))
+		return SC_KV_INVALID_VALUE_SIZE;
+
+	entryNo = FindKvIndexEntry(key, keySize);
+	if((entryNo != KV_ENTRY_NONE) && (option & KV_STORE_OPTION_MUST_NOT_EXIST))
+		return SC_KV_KEY_EXISTS;
+	if((entryNo == KV_ENTRY_NONE) && (option & KV_STORE_OPTION_MUST_EXIST))
+		return SC_KV_KEY_DOES_NOT_EXIST;
+	if((entryNo == KV_ENTRY_NONE) && (kvIndexPtr->freeEntry == KV_ENTRY_NONE) && (kvIndexPtr->unusedEntry == KV_INDEX_ENTRY_COUNT))
+		return SC_CAPACITY_EXCEEDED;
+
+	numOfNvmeBlock = (valueSize + BYTES_PER_NVME_BLOCK - 1) / BYTES_PER_NVME_BLOCK;
+	valueLba = AllocateKvValueSpace(numOfNvmeBlock);
+	if(valueLba == KV_LBA_FAIL)
+		return SC_CAPACITY_EXCEEDED;
+
+	if(entryNo != KV_ENTRY_NONE)
+	{
+		//values are written out of place, the old one is released as a whole
+		entry = &kvIndexPtr->entry[entryNo];
+		ReleaseKvValueSpace(entry->valueLba, (entry->valueSize + BYTES_PER_NVME_BLOCK - 1) / BYTES_PER_NVME_BLOCK);
+	}
+	else
+	{
+		if(kvIndexPtr->freeEntry != KV_ENTRY_NONE)
+		{
+			entryNo = kvIndexPtr->freeEntry;
+			kvIndexPtr->freeEntry = kvIndexPtr->entry[entryNo].nextEntry;
+		}
+		else
+			entryNo = kvIndexPtr->unusedEntry++;
+		entry = &kvIndexPtr->entry[entryNo];
+
+		memcpy(entry->key, key, KV_MAX_KEY_SIZE);
+		entry->keySize = keySize;
+
+		bucketNo = HashKey(key, keySize);
+		entry->nextEntry = kvIndexPtr->bucket[bucketNo];
+		kvIndexPtr->bucket[bucketNo] = entryNo;
+		kvIndexPtr->keyCnt++;
+	}
+
+	entry->valueSize = valueSize;
+	entry->valueLba = valueLba;
+
+	//the value is staged in the data buffer and reaches NAND like block writes
+	SetDeferredNvmeCpl(cmdSlotTag, 0, numOfNvmeBlock);
+	ReqTransNvmeToSlice(cmdSlotTag, KV_NAMESPACE_START_LBA + valueLba, numOfNvmeBlock - 1, IO_NVM_WRITE);
+
+	return SC_SUCCESSFUL_COMPLETION;
+}
+
+unsigned int KvRetrieve(unsigned int cmdSlotTag, unsigned int* key, unsigned int keySize, unsigned int bufSize)
+{
+	P_KV_INDEX_ENTRY entry;
+	unsigned int entryNo, numOfNvmeBlock;
+
+	if(!keySize || (keySize > KV_MAX_KEY_SIZE))
+		return SC_KV_INVALID_KEY_SIZE;
+
+	entryNo = FindKvIndexEntry(key, keySize);
+	if(entryNo == KV_ENTRY_NONE)
+		return SC_KV_KEY_DOES_NOT_EXIST;
+
+	//values are transferred in NVMe blocks, a shorter host buffer gets the head of the value
+	entry = &kvIndexPtr->entry[entryNo];
+	numOfNvmeBlock = (entry->valueSize + BYTES_PER_NVME_BLOCK - 1) / BYTES_PER_NVME_BLOCK;
+	if(numOfNvmeBlock > bufSize / BYTES_PER_NVME_BLOCK)
+		numOfNvmeBlock = bufSize / BYTES_PER_NVME_BLOCK;
+	if(!numOfNvmeBlock)
+		return SC_INVALID_FIELD_IN_COMMAND;
+
+	//the completion returns the value size
+	SetDeferredNvmeCpl(cmdSlotTag, entry->valueSize, numOfNvmeBlock);
+	ReqTransNvmeToSlice(cmdSlotTag, KV_NAMESPACE_START_LBA + entry->valueLba, numOfNvmeBlock - 1, IO_NVM_READ);
+
+	return SC_SUCCESSFUL_COMPLETION;
+}
+
+unsigned int KvDelete(unsigned int* key, unsigned int keySize)
+{
+	P_KV_INDEX_ENTRY entry;
+	unsigned int entryNo, prevEntryNo, bucketNo;
+
+	if(!keySize || (keySize > KV_MAX_KEY_SIZE))
+		return SC_KV_INVALID_KEY_SIZE;
+
+	bucketNo = HashKey(key, keySize);
+	prevEntryNo = KV_ENTRY_NONE;
+	entryNo = kvIndexPtr->bucket[bucketNo];
+	while(entryNo != KV_ENTRY_NONE)
+	{
+		entry = &kvIndexPtr->entry[entryNo];
+		if((entry->keySize == keySize) && !memcmp(entry->key, key, KV_MAX_KEY_SIZE))
+		{
+			if(prevEntryNo == KV_ENTRY_NONE)
+				kvIndexPtr->bucket[bucketNo] = entry->nextEntry;
+			else
+				kvIndexPtr->entry[prevEntryNo].nextEntry = entry->nextEntry;
+
+			ReleaseKvValueSpace(entry->valueLba, (entry->valueSize + BYTES_PER_NVME_BLOCK - 1) / BYTES_PER_NVME_BLOCK);
+
+			entry->nextEntry = kvIndexPtr->freeEntry;
+			kvIndexPtr->freeEntry = entryNo;
+			kvIndexPtr->keyCnt--;
+
+			return SC_SUCCESSFUL_COMPLETION;
+		}
+
+		prevEntryNo = entryNo;
+		entryNo = entry->nextEntry;
+	}
+
+	return SC_KV_KEY_DOES_NOT_EXIST;
+}
+
+unsigned int KvExist(unsigned int* key, unsigned int keySize)
+{
+	if(!keySize || (keySize > KV_MAX_KEY_SIZE))
+		return SC_KV_INVALID_KEY_SIZE;
+
+	if(FindKvIndexEntry(key, keySize) == KV_ENTRY_NONE)
+		return SC_KV_KEY_DOES_NOT_EXIST;
+
+	return SC_SUCCESSFUL_COMPLETION;
+}
+
+unsigned int KvList(unsigned int* key, unsigned int keySize, unsigned int bufAddr, unsigned int bufSize)
+{
+	P_KV_INDEX_ENTRY entry;
+	unsigned int bucketNo, entryNo, listedKeyCnt, offset, keyFieldSize;
+
+	memset((void*)bufAddr, 0, bufSize);
+
+	//keys are listed in index order, starting from the given key when it exists
+	bucketNo = 0;
+	entryNo = KV_ENTRY_NONE;
+	if(keySize && (keySize <= KV_MAX_KEY_SIZE))
+	{
+		entryNo = FindKvIndexEntry(key, keySize);
+		if(entryNo != KV_ENTRY_NONE)
+			bucketNo = HashKey(key, keySize);
+	}
+	if(entryNo == KV_ENTRY_NONE)
+		entryNo = kvIndexPtr->bucket[0];
+
+	//the list starts with the number of keys, each key is its size in 2 bytes followed by the key padded to 4 bytes
+	listedKeyCnt = 0;
+	offset = sizeof(unsigned int);
+	while(bucketNo < KV_HASH_BUCKET_COUNT)
+	{
+		while(entryNo != KV_ENTRY_NONE)
+		{
+			entry = &kvIndexPtr->entry[entryNo];
+			keyFieldSize = (sizeof(unsigned short) + entry->keySize + 3) & ~0x3;
+			if(offset + keyFieldSize > bufSize)
+			{
+				*(unsigned int*)bufAddr = listedKeyCnt;
+				return SC_SUCCESSFUL_COMPLETION;
+			}
+
+			*(unsigned short*)(bufAddr + offset) = entry->keySize;
+			memcpy((void*)(bufAddr + offset + sizeof(unsigned short)), entry->key, entry->keySize);
+			offset += keyFieldSize;
+			listedKeyCnt++;
+
+			entryNo = entry->nextEntry;
+		}
+
+		bucketNo++;
+		if(bucketNo < KV_HASH_BUCKET_COUNT)
+			entryNo = kvIndexPtr->bucket[bucketNo];
+	}
+
+	*(unsigned int*)bufAddr = listedKeyCnt;
+	return SC_SUCCESSFUL_COMPLETION;
+}
+
+unsigned int FindKvIndexEntry(unsigned int* key, unsigned int keySize)
+{
+	P_KV_INDEX_ENTRY entry;
+	unsigned int entryNo;
+
+	entryNo = kvIndexPtr->bucket[HashKey(key, keySize)];
+	while(entryNo != KV_ENTRY_NONE)
+	{
+		entry = &kvIndexPtr->entry[entryNo];
+		if((entry->keySize == keySize) && !memcmp(entry->key, key, KV_MAX_KEY_SIZE))
+			return entryNo;
+
+		entryNo = entry->nextEntry;
+	}
+
+	return KV_ENTRY_NONE;
+}
+
+unsigned int HashKey(unsigned int* key, unsigned int keySize)
+{
+	unsigned char* keyByte;
+	unsigned int hash, byteNo;
+
+	//FNV-1a
+	keyByte = (unsigned char*)key;
+	hash = 2166136261u;
+	for(byteNo = 0; byteNo < keySize; byteNo++)
+	{
+		hash ^= keyByte[byteNo];
+		hash *= 16777619u;
+	}
+
+	return hash % KV_HASH_BUCKET_COUNT;
+}
+
+unsigned int AllocateKvValueSpace(unsigned int numOfNvmeBlock)
+{
+	unsigned int valueLba, sliceNo, startSliceNo, runSliceCnt, neededSliceCnt, scanCnt, lba;
+
+	valueLba = kvSliceMapPtr->allocLba;
+
+	//a small value is packed behind the previous one in the open slice
+	if((valueLba % NVME_BLOCKS_PER_SLICE) && ((valueLba % NVME_BLOCKS_PER_SLICE) + numOfNvmeBlock <= NVME_BLOCKS_PER_SLICE))
+	{
+		kvSliceMapPtr->liveBlockCnt[valueLba / NVME_BLOCKS_PER_SLICE] += numOfNvmeBlock;
+		kvSliceMapPtr->allocLba = (valueLba + numOfNvmeBlock) % (kvSliceMapPtr->sliceCnt * NVME_BLOCKS_PER_SLICE);
+		return valueLba;
+	}
+
+	//otherwise the value takes a run of slices without live blocks, searched from the open slice on
+	neededSliceCnt = (numOfNvmeBlock + NVME_BLOCKS_PER_SLICE - 1) / NVME_BLOCKS_PER_SLICE;
+	startSliceNo = ((valueLba + NVME_BLOCKS_PER_SLICE - 1) / NVME_BLOCKS_PER_SLICE) % kvSliceMapPtr->sliceCnt;
+	runSliceCnt = 0;
+	for(scanCnt = 0; scanCnt < kvSliceMapPtr->sliceCnt + neededSliceCnt; scanCnt++)
+	{
+		sliceNo = (startSliceNo + scanCnt) % kvSliceMapPtr->sliceCnt;
+
+		//a run does not wrap around the end of the namespace
+		if(sliceNo == 0)
+			runSliceCnt = 0;
+
+		if(kvSliceMapPtr->liveBlockCnt[sliceNo])
+			runSliceCnt = 0;
+		else
+			runSliceCnt++;
+
+		if(runSliceCnt == neededSliceCnt)
+		{
+			valueLba = (sliceNo + 1 - neededSliceCnt) * NVME_BLOCKS_PER_SLICE;
+			for(lba = valueLba; lba < valueLba + numOfNvmeBlock; lba++)
+				kvSliceMapPtr->liveBlockCnt[lba / NVME_BLOCKS_PER_SLICE]++;
+
+			kvSliceMapPtr->allocLba = (valueLba + numOfNvmeBlock) % (kvSliceMapPtr->sliceCnt * NVME_BLOCKS_PER_SLICE);
+			return valueLba;
+		}
+	}
+
+	return KV_LBA_FAIL;
+}
+
+void ReleaseKvValueSpace(unsigned int valueLba, unsigned int numOfNvmeBlock)
+{
+	unsigned int lba, sliceNo;
+
+	for(lba = valueLba; lba < valueLba + numOfNvmeBlock; lba++)
+	{
+		sliceNo = lba / NVME_BLOCKS_PER_SLICE;
+		kvSliceMapPtr->liveBlockCnt[sliceNo]--;
+
+		//the slice is trimmed, GC reclaims its NAND space without copying it
+		if(!kvSliceMapPtr->liveBlockCnt[sliceNo])
+			InvalidateOldVsa(KV_NAMESPACE_START_LSA + sliceNo);
+	}
+}
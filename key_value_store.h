@@ -0,0 +1,103 @@
+//////////////////////////////////////////////////////////////////////////////////
+// key_value_store.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Key Value Store
+// File Name: key_value_store.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - define parameters, data structure and functions of key value store
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef KEY_VALUE_STORE_H_
+#define KEY_VALUE_STORE_H_
+
+#include "ftl_config.h"
+#include "nvme/nvme.h"
+
+#define KV_MAX_KEY_SIZE					16
+#define KV_MAX_VALUE_SIZE				(MAX_NUM_OF_NLB * BYTES_PER_NVME_BLOCK)
+
+#define KV_INDEX_ENTRY_COUNT			(1 << 20)		//number of keys the index holds
+#define KV_HASH_BUCKET_COUNT			(KV_INDEX_ENTRY_COUNT)
+#define KV_ENTRY_NONE					0xffffffff
+#define KV_LBA_FAIL						0xffffffff
+
+#define KV_STORE_OPTION_MUST_NOT_EXIST	0x1
+#define KV_STORE_OPTION_MUST_EXIST		0x2
+
+#define KV_LIST_BUFFER_SIZE				(MAX_NUM_OF_NLB * BYTES_PER_NVME_BLOCK)
+
+#define MAX_SLICES_PER_KV_NAMESPACE		(SLICES_PER_SSD / USER_NAMESPACES)
+#define KV_NAMESPACE_START_LSA			((KV_NAMESPACE_ID - 1) * (SLICES_PER_NAMESPACE))
+#define KV_NAMESPACE_START_LBA			((KV_NAMESPACE_ID - 1) * (storageCapacity_L / USER_NAMESPACES))
+
+typedef struct _KV_INDEX_ENTRY {
+	unsigned int key[KV_MAX_KEY_SIZE / 4];
+	unsigned int keySize : 8;
+	unsigned int reserved0 : 24;
+	unsigned int valueSize;			//bytes
+	unsigned int valueLba;			//NVMe block offset in the key value namespace
+	unsigned int nextEntry;			//hash chain of a bucket, or free entry list
+} KV_INDEX_ENTRY, *P_KV_INDEX_ENTRY;
+
+typedef struct _KV_INDEX {
+	KV_INDEX_ENTRY entry[KV_INDEX_ENTRY_COUNT];
+	unsigned int bucket[KV_HASH_BUCKET_COUNT];
+	unsigned int freeEntry;
+	unsigned int unusedEntry;		//entries from here on were never used, they are not linked at boot
+	unsigned int keyCnt;
+} KV_INDEX, *P_KV_INDEX;
+
+//values are packed into slices in NVMe block units, a slice without live blocks is trimmed and compacted by GC
+typedef struct _KV_SLICE_MAP {
+	unsigned char liveBlockCnt[MAX_SLICES_PER_KV_NAMESPACE];
+	unsigned int sliceCnt;
+	unsigned int allocLba;			//next NVMe block of the open slice
+} KV_SLICE_MAP, *P_KV_SLICE_MAP;
+
+void InitKvStore();
+unsigned int KvStore(unsigned int cmdSlotTag, unsigned int* key, unsigned int keySize, unsigned int valueSize, unsigned int option);
+unsigned int KvRetrieve(unsigned int cmdSlotTag, unsigned int* key, unsigned int keySize, unsigned int bufSize);
+unsigned int KvDelete(unsigned int* key, unsigned int keySize);
+unsigned int KvExist(unsigned int* key, unsigned int keySize);
+unsigned int KvList(unsigned int* key, unsigned int keySize, unsigned int bufAddr, unsigned int bufSize);
+
+unsigned int FindKvIndexEntry(unsigned int* key, unsigned int keySize);
+unsigned int HashKey(unsigned int* key, unsigned int keySize);
+unsigned int AllocateKvValueSpace(unsigned int numOfNvmeBlock);
+void ReleaseKvValueSpace(unsigned int valueLba, unsigned int numOfNvmeBlock);
+
+extern P_KV_INDEX kvIndexPtr;
+extern P_KV_SLICE_MAP kvSliceMapPtr;
+
+#endif /* KEY_VALUE_STORE_H_ */
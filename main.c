@@ -72,6 +72,9 @@
 #include "nvme/nvme.h"
 #include "nvme/nvme_main.h"
 #include "nvme/host_lld.h"
+#include "nvme/host_ipc.h"
+
+#include "memory_map.h"
 
 
 XScuGic GicInstance;
@@ -92,6 +95,14 @@ int main()
 	{
 		if (u < 0x2)
 			Xil_SetTlbAttributes(u * MB, 0xC1E); // cached & buffered
+#if FTL_CORE
+		else if (u == (FTL_CORE_IMAGE_ADDR / MB))
+			Xil_SetTlbAttributes(u * MB, 0xC1E); // cached & buffered, code and data of the FTL core
+#endif
+#if (CACHED_DATA_BUFFER == 1)
+		else if ((u >= (CACHED_DATA_BUFFER_START_ADDR / MB)) && (u <= (CACHED_DATA_BUFFER_END_ADDR / MB)))
+			Xil_SetTlbAttributes(u * MB, 0xC1E); // cached & buffered, data buffers maintained around DMA
+#endif
 		else if (u < 0x180)
 			Xil_SetTlbAttributes(u * MB, 0xC12); // uncached & nonbuffered
 		else if (u < 0x400)
@@ -105,6 +116,13 @@ int main()
 	Xil_DCacheEnable();
 	xil_printf("[!] MMU has been enabled.\r\n");
 
+#if FTL_CORE
+	//the FTL core takes no interrupt, host interface registers are accessed by core 0 only
+	xil_printf("\r\n FTL core started \r\n");
+	nvme_ftl_main();
+
+	return 0;
+#endif
 
 	xil_printf("\r\n Hello COSMOS+ OpenSSD !!! \r\n");
 
@@ -129,6 +147,12 @@ int main()
 
 	dev_irq_init();
 
+	//the IPC block also carries asynchronous events raised by the FTL in a single core build
+	init_host_ipc();
+#if HOST_CORE
+	start_ftl_core();
+#endif
+
 	nvme_main();
 
 	xil_printf("done\r\n");
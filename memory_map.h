@@ -53,6 +53,14 @@
 #include "request_schedule.h"
 #include "request_transform.h"
 #include "garbage_collection.h"
+#include "zone_management.h"
+#include "key_value_store.h"
+#include "scan_filter.h"
+#include "hot_path_profile.h"
+#include "ftl_statistics.h"
+#include "cmd_latency_trace.h"
+#include "nand_utilization.h"
+#include "nvme/host_ipc.h"
 
 #define DRAM_START_ADDR					0x00100000
 
@@ -62,6 +70,14 @@
 #define NVME_MANAGEMENT_START_ADDR		0x00200000
 #define NVME_MANAGEMENT_END_ADDR		0x002FFFFF
 
+// Uncached & Unbuffered, shared by the host interface core and the FTL core
+// the first 64KB are left to the admin command data buffer (ADMIN_CMD_DRAM_DATA_BUFFER)
+#define HOST_IPC_ADDR					(NVME_MANAGEMENT_START_ADDR + 0x00010000)
+#define HOT_PATH_PROFILE_TABLE_ADDR		(HOST_IPC_ADDR + sizeof(HOST_IPC))
+#define FTL_STATISTICS_TABLE_ADDR		(HOT_PATH_PROFILE_TABLE_ADDR + sizeof(HOT_PATH_PROFILE_TABLE))
+#define CMD_LATENCY_TABLE_ADDR			(FTL_STATISTICS_TABLE_ADDR + sizeof(FTL_STATISTICS_TABLE))
+#define NAND_UTILIZATION_TABLE_ADDR		(CMD_LATENCY_TABLE_ADDR + sizeof(CMD_LATENCY_TABLE))
+
 #define RESERVED0_START_ADDR			0x00300000
 #define RESERVED0_END_ADDR				0x0FFFFFFF
 
@@ -73,11 +89,28 @@
 #define SPARE_DATA_BUFFER_BASE_ADDR				(TEMPORARY_DATA_BUFFER_BASE_ADDR + AVAILABLE_TEMPORARY_DATA_BUFFER_ENTRY_COUNT * BYTES_PER_DATA_REGION_OF_SLICE)
 #define TEMPORARY_SPARE_DATA_BUFFER_BASE_ADDR	(SPARE_DATA_BUFFER_BASE_ADDR + AVAILABLE_DATA_BUFFER_ENTRY_COUNT * BYTES_PER_SPARE_REGION_OF_SLICE)
 #define RESERVED_DATA_BUFFER_BASE_ADDR 			(TEMPORARY_SPARE_DATA_BUFFER_BASE_ADDR + AVAILABLE_TEMPORARY_DATA_BUFFER_ENTRY_COUNT * BYTES_PER_SPARE_REGION_OF_SLICE)
+#define PHY_IO_DATA_BUFFER_BASE_ADDR			(RESERVED_DATA_BUFFER_BASE_ADDR + 0x00200000)
+#define PHY_IO_DATA_BUFFER_END_ADDR				(PHY_IO_DATA_BUFFER_BASE_ADDR + MAX_PHY_ADDRS_PER_CMD * BYTES_PER_PHY_IO_DATA_BUFFER_ENTRY)
+
+//data buffers are mapped with the cache attribute of CACHED_DATA_BUFFER, the tables from COMPLETE_FLAG_TABLE_ADDR stay uncached
+#define CACHED_DATA_BUFFER_START_ADDR			DATA_BUFFER_BASE_ADDR
+#define CACHED_DATA_BUFFER_END_ADDR				(COMPLETE_FLAG_TABLE_ADDR - 1)
 //for nand request completion
 #define COMPLETE_FLAG_TABLE_ADDR			0x17000000
 #define STATUS_REPORT_TABLE_ADDR			(COMPLETE_FLAG_TABLE_ADDR + sizeof(COMPLETE_FLAG_TABLE))
 #define ERROR_INFO_TABLE_ADDR				(STATUS_REPORT_TABLE_ADDR + sizeof(STATUS_REPORT_TABLE))
 #define TEMPORARY_PAY_LOAD_ADDR				(ERROR_INFO_TABLE_ADDR+ sizeof(ERROR_INFO_TABLE))
+#define READ_RETRY_PAY_LOAD_TABLE_ADDR		(TEMPORARY_PAY_LOAD_ADDR + 2 * sizeof(unsigned int))
+//for zone report
+#define ZONE_REPORT_BUFFER_ADDR				(COMPLETE_FLAG_TABLE_ADDR + 0x00100000)
+//for physical address list
+#define PHY_ADDR_LIST_ADDR					(ZONE_REPORT_BUFFER_ADDR + ZONE_REPORT_BUFFER_SIZE)
+//for key list
+#define KV_LIST_BUFFER_ADDR					(PHY_ADDR_LIST_ADDR + MAX_PHY_ADDRS_PER_CMD * sizeof(IO_PHY_ADDR))
+//for scan filter result
+#define SCAN_RESULT_BUFFER_ADDR				(KV_LIST_BUFFER_ADDR + KV_LIST_BUFFER_SIZE)
+//for compare data
+#define COMPARE_BUFFER_ADDR					(SCAN_RESULT_BUFFER_ADDR + SCAN_RESULT_BUFFER_SIZE)
 // cached & buffered
 // for buffers
 #define DATA_BUFFER_MAP_ADDR		 		0x18000000
@@ -92,16 +125,24 @@
 #define VIRTUAL_DIE_MAP_ADDR				(BAD_BLOCK_TABLE_INFO_MAP_ADDR + sizeof(BAD_BLOCK_TABLE_INFO_MAP))
 // for GC victim selection
 #define GC_VICTIM_MAP_ADDR					(VIRTUAL_DIE_MAP_ADDR + sizeof(VIRTUAL_DIE_MAP))
+// for read disturb and retention refresh
+#define BLOCK_REFRESH_MAP_ADDR				(GC_VICTIM_MAP_ADDR + sizeof(GC_VICTIM_MAP))
+// for zoned namespace
+#define ZONE_MAP_ADDR						(BLOCK_REFRESH_MAP_ADDR + sizeof(BLOCK_REFRESH_MAP))
+// for key value store
+#define KV_INDEX_ADDR						(ZONE_MAP_ADDR + sizeof(ZONE_MAP))
+#define KV_SLICE_MAP_ADDR					(KV_INDEX_ADDR + sizeof(KV_INDEX))
 // for request pool
-#define REQ_POOL_ADDR						(GC_VICTIM_MAP_ADDR + sizeof(GC_VICTIM_MAP))
+#define REQ_POOL_ADDR						((KV_SLICE_MAP_ADDR + sizeof(KV_SLICE_MAP) + (BYTES_PER_REQ_POOL_ENTRY - 1)) & ~(BYTES_PER_REQ_POOL_ENTRY - 1))	//a request does not cross cache lines
 // for dependency table
 #define ROW_ADDR_DEPENDENCY_TABLE_ADDR		(REQ_POOL_ADDR + sizeof(REQ_POOL))
 // for request scheduler
 #define DIE_STATE_TABLE_ADDR				(ROW_ADDR_DEPENDENCY_TABLE_ADDR + sizeof(ROW_ADDR_DEPENDENCY_TABLE))
 #define RETRY_LIMIT_TABLE_ADDR				(DIE_STATE_TABLE_ADDR + sizeof(DIE_STATE_TABLE))
 #define WAY_PRIORITY_TABLE_ADDR 			(RETRY_LIMIT_TABLE_ADDR + sizeof(RETRY_LIMIT_TABLE))
+#define READ_RETRY_TABLE_ADDR				(WAY_PRIORITY_TABLE_ADDR + sizeof(WAY_PRIORITY_TABLE))
 
-#define FTL_MANAGEMENT_END_ADDR				((WAY_PRIORITY_TABLE_ADDR + sizeof(WAY_PRIORITY_TABLE))- 1)
+#define FTL_MANAGEMENT_END_ADDR				((READ_RETRY_TABLE_ADDR + sizeof(READ_RETRY_TABLE))- 1)
 
 #define RESERVED1_START_ADDR				(FTL_MANAGEMENT_END_ADDR + 1)
 #define RESERVED1_END_ADDR					0x3FFFFFFF
@@ -0,0 +1,142 @@
+//////////////////////////////////////////////////////////////////////////////////
+// nand_utilization.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: NAND Utilization Monitor
+// File Name: nand_utilization.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - measure busy time of dies per operation and time blocked by row address dependencies
+//   - sample nandReqQ depth of dies and NSC command queue occupancy of channels in the scheduler
+//   - publish them with the signal counters of the NSC (T4EXT_PM) as a vendor specific log page
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "xil_printf.h"
+#include <string.h>
+#include "xtime_l.h"
+#include "memory_map.h"
+
+NAND_UTILIZATION nandUtilization;
+P_NAND_UTILIZATION_TABLE nandUtilizationTablePtr = (P_NAND_UTILIZATION_TABLE) NAND_UTILIZATION_TABLE_ADDR;
+
+void InitNandUtilization()
+{
+	memset(&nandUtilization, 0, sizeof(NAND_UTILIZATION));
+
+	memset(nandUtilizationTablePtr, 0, sizeof(NAND_UTILIZATION_TABLE));
+	nandUtilizationTablePtr->channelCnt = USER_CHANNELS;
+	nandUtilizationTablePtr->wayCnt = USER_WAYS;
+	nandUtilizationTablePtr->timerFreq = COUNTS_PER_SECOND;
+	nandUtilizationTablePtr->sampleInterval = NAND_UTIL_SAMPLE_INTERVAL;
+}
+
+void StartDieBusy(unsigned int chNo, unsigned int wayNo)
+{
+	P_DIE_UTILIZATION_STATE dieState;
+
+	//a read is issued twice (trigger and transfer), the die is busy from the first issue
+	dieState = &nandUtilization.dieState[chNo][wayNo];
+	if(dieState->busy)
+		return;
+
+	dieState->busy = 1;
+	dieState->busyStartTime = ReadGlobalTimer();
+}
+
+void EndDieBusy(unsigned int chNo, unsigned int wayNo, unsigned int reqCode)
+{
+	P_DIE_UTILIZATION_STATE dieState;
+	unsigned int op;
+
+	dieState = &nandUtilization.dieState[chNo][wayNo];
+	if(!dieState->busy)
+		return;
+
+	if((reqCode == REQ_CODE_READ) || (reqCode == REQ_CODE_READ_TRANSFER) || (reqCode == REQ_CODE_READ_RETRY))
+		op = NAND_OP_READ;
+	else if(reqCode == REQ_CODE_WRITE)
+		op = NAND_OP_WRITE;
+	else if(reqCode == REQ_CODE_ERASE)
+		op = NAND_OP_ERASE;
+	else
+		op = NAND_OP_OTHER;
+
+	dieState->busy = 0;
+	nandUtilization.die[chNo][wayNo].busyTime[op] += ReadGlobalTimer() - dieState->busyStartTime;
+	nandUtilization.die[chNo][wayNo].opCnt[op]++;
+}
+
+void StartRowAddrBlocked(unsigned int chNo, unsigned int wayNo)
+{
+	nandUtilization.dieState[chNo][wayNo].rowAddrBlockedStartTime = ReadGlobalTimer();
+}
+
+void EndRowAddrBlocked(unsigned int chNo, unsigned int wayNo)
+{
+	nandUtilization.die[chNo][wayNo].rowAddrBlockedTime += ReadGlobalTimer() - nandUtilization.dieState[chNo][wayNo].rowAddrBlockedStartTime;
+}
+
+void SampleNandUtilization(unsigned int chNo)
+{
+	unsigned int wayNo, nscQueueDepth;
+
+	nscQueueDepth = V2F_CMD_QUEUE_DEPTH - V2FGetFreeQueueCount(&chCtlReg[chNo]);
+
+	nandUtilization.ch[chNo].sampleCnt++;
+	nandUtilization.ch[chNo].nscQueueDepthSum += nscQueueDepth;
+	if(nscQueueDepth)
+		nandUtilization.ch[chNo].busySampleCnt++;
+
+	for(wayNo = 0; wayNo < USER_WAYS; wayNo++)
+		nandUtilization.die[chNo][wayNo].queueDepthSum += nandReqQ[chNo][wayNo].reqCnt;
+}
+
+void PublishNandUtilization()
+{
+	unsigned int chNo;
+	XTime currentTime;
+
+	for(chNo = 0; chNo < USER_CHANNELS; chNo++)
+		nandUtilization.ch[chNo].perfMonitor = chCtlReg[chNo].t4regEXT->perfMonitor;
+
+	XTime_GetTime(&currentTime);
+	nandUtilizationTablePtr->upTime = currentTime;
+
+	memcpy(nandUtilizationTablePtr->ch, nandUtilization.ch, sizeof(nandUtilization.ch));
+	memcpy(nandUtilizationTablePtr->die, nandUtilization.die, sizeof(nandUtilization.die));
+}
+
+unsigned int MakeNandUtilizationLog(unsigned int bufAddr)
+{
+	memcpy((void*)bufAddr, nandUtilizationTablePtr, sizeof(NAND_UTILIZATION_TABLE));
+
+	return sizeof(NAND_UTILIZATION_TABLE);
+}
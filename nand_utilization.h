@@ -0,0 +1,120 @@
+//////////////////////////////////////////////////////////////////////////////////
+// nand_utilization.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: NAND Utilization Monitor
+// File Name: nand_utilization.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - define busy time and queue depth counters of dies and channels
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef NAND_UTILIZATION_H_
+#define NAND_UTILIZATION_H_
+
+#include "ftl_config.h"
+#include "t4nsc_pm.h"
+
+#define NAND_OP_READ				0
+#define NAND_OP_WRITE				1
+#define NAND_OP_ERASE				2
+#define NAND_OP_OTHER				3		//reset and set features
+#define NAND_OPS					4
+
+#define NAND_UTIL_SAMPLE_INTERVAL	16		//channel visits of the scheduler per queue depth sample, power of 2
+
+#if (NAND_UTILIZATION_MONITOR == 1)
+#define NandUtilDieBusyBegin(chNo, wayNo) StartDieBusy((chNo), (wayNo))
+#define NandUtilDieBusyEnd(chNo, wayNo, reqCode) EndDieBusy((chNo), (wayNo), (reqCode))
+#define NandUtilRowAddrBlockedBegin(chNo, wayNo) ((blockedByRowAddrDepReqQ[(chNo)][(wayNo)].reqCnt == 0) ? StartRowAddrBlocked((chNo), (wayNo)) : (void)0)
+#define NandUtilRowAddrBlockedEnd(chNo, wayNo) ((blockedByRowAddrDepReqQ[(chNo)][(wayNo)].reqCnt == 0) ? EndRowAddrBlocked((chNo), (wayNo)) : (void)0)
+#define NandUtilSample(chNo) (((++nandUtilization.visitCnt[(chNo)] & (NAND_UTIL_SAMPLE_INTERVAL - 1)) == 0) ? SampleNandUtilization((chNo)) : (void)0)
+#else
+#define NandUtilDieBusyBegin(chNo, wayNo)
+#define NandUtilDieBusyEnd(chNo, wayNo, reqCode)
+#define NandUtilRowAddrBlockedBegin(chNo, wayNo)
+#define NandUtilRowAddrBlockedEnd(chNo, wayNo)
+#define NandUtilSample(chNo)
+#endif
+
+typedef struct _DIE_UTILIZATION_STAT {
+	unsigned long long busyTime[NAND_OPS];		//from the first issue of a request to its completion
+	unsigned int opCnt[NAND_OPS];
+	unsigned long long rowAddrBlockedTime;		//while requests of the die are blocked by a row address dependency
+	unsigned long long queueDepthSum;			//nandReqQ depth summed over the samples of the channel
+} DIE_UTILIZATION_STAT, *P_DIE_UTILIZATION_STAT;
+
+typedef struct _CHANNEL_UTILIZATION_STAT {
+	unsigned int sampleCnt;
+	unsigned int busySampleCnt;					//samples with commands queued in the NSC
+	unsigned long long nscQueueDepthSum;
+	T4EXT_PM perfMonitor;						//signal counters of the NSC, read when published
+} CHANNEL_UTILIZATION_STAT, *P_CHANNEL_UTILIZATION_STAT;
+
+typedef struct _DIE_UTILIZATION_STATE {
+	unsigned int busy;
+	unsigned int busyStartTime;
+	unsigned int rowAddrBlockedStartTime;
+} DIE_UTILIZATION_STATE, *P_DIE_UTILIZATION_STATE;
+
+// counters are updated by the scheduler, they stay in cached memory of the FTL
+typedef struct _NAND_UTILIZATION {
+	DIE_UTILIZATION_STATE dieState[USER_CHANNELS][USER_WAYS];
+	DIE_UTILIZATION_STAT die[USER_CHANNELS][USER_WAYS];
+	CHANNEL_UTILIZATION_STAT ch[USER_CHANNELS];
+	unsigned int visitCnt[USER_CHANNELS];
+} NAND_UTILIZATION, *P_NAND_UTILIZATION;
+
+// layout of the NAND utilization log page, published to memory shared with the host interface core
+// a configuration with more dies than fit in a log page returns the leading part only
+typedef struct _NAND_UTILIZATION_TABLE {
+	unsigned int channelCnt;
+	unsigned int wayCnt;
+	unsigned int timerFreq;						//ticks per second of busy and blocked times
+	unsigned int sampleInterval;
+	unsigned long long upTime;					//ticks since boot when published
+	CHANNEL_UTILIZATION_STAT ch[USER_CHANNELS];
+	DIE_UTILIZATION_STAT die[USER_CHANNELS][USER_WAYS];
+} NAND_UTILIZATION_TABLE, *P_NAND_UTILIZATION_TABLE;
+
+void InitNandUtilization();
+void StartDieBusy(unsigned int chNo, unsigned int wayNo);
+void EndDieBusy(unsigned int chNo, unsigned int wayNo, unsigned int reqCode);
+void StartRowAddrBlocked(unsigned int chNo, unsigned int wayNo);
+void EndRowAddrBlocked(unsigned int chNo, unsigned int wayNo);
+void SampleNandUtilization(unsigned int chNo);
+void PublishNandUtilization();
+unsigned int MakeNandUtilizationLog(unsigned int bufAddr);
+
+extern NAND_UTILIZATION nandUtilization;
+extern P_NAND_UTILIZATION_TABLE nandUtilizationTablePtr;
+
+#endif /* NAND_UTILIZATION_H_ */
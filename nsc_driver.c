@@ -107,6 +107,20 @@ void V2FInitializeHandle(T4REGS* t4regs, void* t4nscRegisterBaseAddress)
 	t4regs->t4regSP = (T4REG_SP*)((unsigned int)t4nscRegisterBaseAddress + 0x4000);
 }
 
+// Async commands do not wait for the command queue, the caller must check V2FGetFreeQueueCount() before issuing.
+// The scratchpad is filled word by word so that the register accesses stay 32-bit and in order at any optimization level.
+void V2FCopyToScratchpad(T4REGS* t4regs, unsigned int* payload, unsigned int wordCount)
+{
+	volatile unsigned int* scratchpad = (volatile unsigned int*)t4regs->t4regSP;
+	unsigned int i;
+
+	// completion and report words cleared by the caller must reach memory before the command is issued
+	__asm__ __volatile__("" ::: "memory");
+
+	for(i = 0; i < wordCount; i++)
+		scratchpad[i] = payload[i];
+}
+
 void __attribute__((optimize("O0"))) V2FSetScramblerState(T4REGS* t4regs, int enable)
 {
 	T4REG_CMD_SET_SCRAMBLER setScramblerCmd;
@@ -214,7 +228,7 @@ void __attribute__((optimize("O0"))) V2FSetFeaturesSync(T4REGS* t4regs, int way,
 	while (!(*status & (1 << way)));
 }
 
-void __attribute__((optimize("O0"))) V2FReadPageTriggerAsync(T4REGS* t4regs, int way, unsigned int rowAddress)
+void V2FReadPageTriggerAsync(T4REGS* t4regs, int way, unsigned int rowAddress)
 {
 	T4REG_CMD_READ_PAGE_TRIGGER readPageTrigggerCmd;
 
@@ -222,12 +236,11 @@ void __attribute__((optimize("O0"))) V2FReadPageTriggerAsync(T4REGS* t4regs, int
 	readPageTrigggerCmd.waySelect = 1 << way;
 	readPageTrigggerCmd.rowAddress = rowAddress;
 
-	while (V2FIsControllerBusy(t4regs));
 	V2FFillRegisters(t4regs, T4REG_CMD_READ_PAGE_TRIGGER, readPageTrigggerCmd);
 	V2FIssueCommand(t4regs);
 }
 
-void __attribute__((optimize("O0"))) V2FReadPageTransferAsync(T4REGS* t4regs, int way, void* pageDataBuffer, void* spareDataBuffer, unsigned int* errorInformation, unsigned int* completion, unsigned int rowAddress)
+void V2FReadPageTransferAsync(T4REGS* t4regs, int way, void* pageDataBuffer, void* spareDataBuffer, unsigned int* errorInformation, unsigned int* completion, unsigned int rowAddress)
 {
 	T4REG_CMD_READ_PAGE_TRANSFER_PSLC readpagepSLC;
 
@@ -240,12 +253,11 @@ void __attribute__((optimize("O0"))) V2FReadPageTransferAsync(T4REGS* t4regs, in
 	*completion = 0;
 	readpagepSLC.completionReportAddress = completion;
 
-	while (V2FIsControllerBusy(t4regs));
 	V2FFillRegisters(t4regs, T4REG_CMD_READ_PAGE_TRANSFER_PSLC, readpagepSLC);
 	V2FIssueCommand(t4regs);
 }
 
-void __attribute__((optimize("O0"))) V2FReadPageTransferRawAsync(T4REGS* t4regs, int way, void* pageDataBuffer, unsigned int* completion)
+void V2FReadPageTransferRawAsync(T4REGS* t4regs, int way, void* pageDataBuffer, unsigned int* completion)
 {
 	T4REG_CMD_READ_PAGE_TRANSFER_RAW readPageTransferRaw;
 
@@ -257,13 +269,12 @@ void __attribute__((optimize("O0"))) V2FReadPageTransferRawAsync(T4REGS* t4regs,
 	readPageTransferRaw.completionReportAddress = (unsigned int)completion;
 	*completion = 0;
 
-	while (V2FIsControllerBusy(t4regs));
 	V2FFillRegisters(t4regs, T4REG_CMD_READ_PAGE_TRANSFER_RAW, readPageTransferRaw);
 	V2FIssueCommand(t4regs);
 }
 
 
-void __attribute__((optimize("O0"))) V2FProgramPageAsync(T4REGS* t4regs, int way, unsigned int rowAddress, void* pageDataBuffer, void* spareDataBuffer)
+void V2FProgramPageAsync(T4REGS* t4regs, int way, unsigned int rowAddress, void* pageDataBuffer, void* spareDataBuffer)
 {
 	T4REG_CMD_PROGRAM_PAGE_TRANSFER_PSLC progPagepSLC;
 
@@ -273,12 +284,11 @@ void __attribute__((optimize("O0"))) V2FProgramPageAsync(T4REGS* t4regs, int way
 	progPagepSLC.pageDataAddress = pageDataBuffer;
 	progPagepSLC.spareDataAddress = spareDataBuffer;
 
-	while (V2FIsControllerBusy(t4regs));
 	V2FFillRegisters(t4regs, T4REG_CMD_PROGRAM_PAGE_TRANSFER_PSLC, progPagepSLC);
 	V2FIssueCommand(t4regs);
 }
 
-void __attribute__((optimize("O0"))) V2FEraseBlockAsync(T4REGS* t4regs, int way, unsigned int rowAddress)
+void V2FEraseBlockAsync(T4REGS* t4regs, int way, unsigned int rowAddress)
 {
 	T4REG_CMD_ERASE_BLOCK eraseBlockCmd;
 
@@ -288,12 +298,11 @@ void __attribute__((optimize("O0"))) V2FEraseBlockAsync(T4REGS* t4regs, int way,
 	eraseBlockCmd.waySelect = 1 << way;
 	eraseBlockCmd.rowAddress = rowAddress;
 
-	while (V2FIsControllerBusy(t4regs));
 	V2FFillRegisters(t4regs, T4REG_CMD_ERASE_BLOCK, eraseBlockCmd);
 	V2FIssueCommand(t4regs);
 }
 
-void __attribute__((optimize("O0"))) V2FStatusCheckAsync(T4REGS* t4regs, int way, unsigned int* statusReport)
+void V2FStatusCheckAsync(T4REGS* t4regs, int way, unsigned int* statusReport)
 {
 	T4REG_CMD_READ_STATUS readStatusCmd;
 
@@ -302,7 +311,6 @@ void __attribute__((optimize("O0"))) V2FStatusCheckAsync(T4REGS* t4regs, int way
 	readStatusCmd.reportAddress = (unsigned int)statusReport;
 	*statusReport = 0;
 
-	while (V2FIsControllerBusy(t4regs));
 	V2FFillRegisters(t4regs, T4REG_CMD_READ_STATUS, readStatusCmd);
 	V2FIssueCommand(t4regs);
 }
@@ -321,7 +329,7 @@ void __attribute__((optimize("O0"))) V2FStatusCheckSync(T4REGS* t4regs, int way,
 	return *statusReport;
 }
 
-void __attribute__((optimize("O0"))) V2FReadIdAsync(T4REGS* t4regs, int way, unsigned int* statusReport, unsigned int* completion)
+void V2FReadIdAsync(T4REGS* t4regs, int way, unsigned int* statusReport, unsigned int* completion)
 {
 	T4REG_CMD_READ_ID readIdCmd;
 
@@ -332,7 +340,6 @@ void __attribute__((optimize("O0"))) V2FReadIdAsync(T4REGS* t4regs, int way, uns
 	readIdCmd.reportAddress = (unsigned int)statusReport;
 	readIdCmd.completionReportAddress = (unsigned int)completion;
 
-	while (V2FIsControllerBusy(t4regs));
 	V2FFillRegisters(t4regs, T4REG_CMD_READ_ID, readIdCmd);
 	V2FIssueCommand(t4regs);
 }
@@ -345,6 +352,7 @@ void __attribute__((optimize("O0")))  V2FReadIdSync(T4REGS* t4regs, int way, uns
 		((unsigned char*)statusReport)[i] = 0;
 	unsigned int* completion = &statusReport[4];
 	*completion = 0;
+	while (V2FIsControllerBusy(t4regs));
 	V2FReadIdAsync(t4regs, way, statusReport, completion);
 	while (*completion == 0);
 
@@ -354,7 +362,7 @@ void __attribute__((optimize("O0")))  V2FReadIdSync(T4REGS* t4regs, int way, uns
 		((unsigned char*)statusReport)[i] = buf[i];
 }
 
-unsigned int __attribute__((optimize("O0"))) V2FReadyBusyAsync(T4REGS* t4regs)
+unsigned int V2FReadyBusyAsync(T4REGS* t4regs)
 {
 	volatile unsigned int readyBusy = (t4regs)->t4regBP->nandReadyBusy;
 
@@ -59,6 +59,8 @@
 
 #include "t4nsc_pm.h"
 
+#define V2F_CMD_QUEUE_DEPTH 32
+
 #define T4NSC_CMD_NAND_RESET 4
 #define T4NSC_CMD_MODE_CHANGE 32
 #define T4NSC_CMD_GET_READYBUSY 108
@@ -94,11 +96,11 @@
 #define T4NSC_CMD_FSP_PAGES (T4NSC_CMD_END_OF_COMMON+960)
 #define T4NSC_CMD_END_OF_PLAINOPS (T4NSC_CMD_END_OF_COMMON+1308)
 
-#define V2FFillRegisters(t4regs, cmdtype, cmdpayload) (*((volatile cmdtype*)((t4regs)->t4regSP)) = (cmdpayload))
+#define V2FFillRegisters(t4regs, cmdtype, cmdpayload) V2FCopyToScratchpad((t4regs), (unsigned int*)&(cmdpayload), sizeof(cmdtype) / sizeof(unsigned int))
 #define V2FIssueCommand(t4regs) (((t4regs)->t4regCC)->issueCmd = 1)
 
 #define V2FIsControllerBusy(t4regs) ((t4regs)->t4regID->queueNotFull == 0)
-#define V2FGetFreeQueueCount(t4regs) (32 - ((t4regs)->t4regID->queueCount))
+#define V2FGetFreeQueueCount(t4regs) (V2F_CMD_QUEUE_DEPTH - ((t4regs)->t4regID->queueCount))
 #define V2FGetNANDReadyBusy(t4regs, way) !!((t4regs)->t4regBP->nandReadyBusy & (1 << (way)))
 
 #define V2FCrcValid(errorInformation) !!(*((uint32_t*)(errorInformation)) & 0x10000000)
@@ -433,7 +435,9 @@ typedef struct
 void nfc_set_dqs_delay(int channel, unsigned int newValue);
 void nfc_set_dq_delay(int channel, unsigned int newValue);
 void V2FInitializeHandle(T4REGS* t4regs, void* t4nscRegisterBaseAddress);
+void V2FCopyToScratchpad(T4REGS* t4regs, unsigned int* payload, unsigned int wordCount);
 void V2FResetSync(T4REGS* t4regs, int way);
+void V2FSetFeaturesT(T4REGS* t4regs, int way, unsigned int address, volatile unsigned int* payload);
 void V2FSetFeaturesSync(T4REGS* t4regs, int way, unsigned int feature0x02, unsigned int feature0x10, unsigned int feature0x91, unsigned int feature0x01, unsigned int payLoadAddr);
 void V2FReadPageTriggerAsync(T4REGS* t4regs, int way, unsigned int rowAddress);
 void V2FReadPageTransferAsync(T4REGS* t4regs, int way, void* pageDataBuffer, void* spareDataBuffer, unsigned int* errorInformation, unsigned int* completion, unsigned int rowAddress);
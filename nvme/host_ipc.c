@@ -0,0 +1,259 @@
+//////////////////////////////////////////////////////////////////////////////////
+// host_ipc.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Host Interface to FTL Core Channel
+// File Name: host_ipc.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - releases the FTL core and waits until the FTL is initialized
+//   - passes IO commands from the host interface core to the FTL core
+//   - passes host DMA and NVMe completion register images from the FTL core to the host interface core
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "xil_printf.h"
+#include "xil_cache.h"
+#include "xpseudo_asm.h"
+#include "debug.h"
+#include "io_access.h"
+#include "string.h"
+
+#include "nvme.h"
+#include "host_lld.h"
+#include "host_ipc.h"
+#include "nvme_io_cmd.h"
+
+#include "../memory_map.h"
+
+HOST_IPC *g_hostIpc = (HOST_IPC*)HOST_IPC_ADDR;
+
+void init_host_ipc()
+{
+	g_hostIpc->ftlReady = 0;
+	g_hostIpc->storageCapacity_L = 0;
+	g_hostIpc->shutdownReq = 0;
+	g_hostIpc->shutdownDone = 0;
+	g_hostIpc->statisticsReq = 0;
+	g_hostIpc->statisticsDone = 0;
+	memset((void*)g_hostIpc->asyncEventCnt, 0, sizeof(g_hostIpc->asyncEventCnt));
+	g_hostIpc->asyncEventTotalCnt = 0;
+
+	g_hostIpc->cmdRing.head = 0;
+	g_hostIpc->cmdRing.tail = 0;
+	g_hostIpc->reqRing.head = 0;
+	g_hostIpc->reqRing.tail = 0;
+	dmb();
+}
+
+void start_ftl_core()
+{
+	xil_printf("Release the FTL core (entry 0x%X) \r\n", FTL_CORE_IMAGE_ADDR);
+
+	IO_WRITE32(FTL_CORE_RELEASE_ADDR, FTL_CORE_IMAGE_ADDR);
+	Xil_DCacheFlush();
+	dsb();
+	sev();
+}
+
+void wait_ftl_core_ready()
+{
+	//the host interface core keeps serving the requests of the FTL core while it initializes
+	while(g_hostIpc->ftlReady == 0)
+		handle_host_ipc_req();
+
+	dmb();
+	storageCapacity_L = g_hostIpc->storageCapacity_L;
+	zoneMapPtr = (P_ZONE_MAP) ZONE_MAP_ADDR;
+}
+
+void set_ftl_core_ready()
+{
+	g_hostIpc->storageCapacity_L = storageCapacity_L;
+
+	//FTL tables read by the host interface core (e.g. zone count for identify) are written back to DRAM
+	Xil_DCacheFlush();
+	dmb();
+	g_hostIpc->ftlReady = 1;
+}
+
+void put_host_ipc_cmd(NVME_COMMAND *nvmeCmd)
+{
+	HOST_IPC_CMD_RING *ring = &g_hostIpc->cmdRing;
+	unsigned int tail;
+
+	tail = ring->tail;
+	while((tail - ring->head) == HOST_IPC_CMD_RING_SIZE)
+		handle_host_ipc_req();
+
+	ring->entry[tail & (HOST_IPC_CMD_RING_SIZE - 1)] = *nvmeCmd;
+	dmb();
+	ring->tail = tail + 1;
+}
+
+unsigned int host_ipc_cmd_ring_full()
+{
+	return (g_hostIpc->cmdRing.tail - g_hostIpc->cmdRing.head) == HOST_IPC_CMD_RING_SIZE;
+}
+
+void dispatch_nvme_io_cmd(NVME_COMMAND *nvmeCmd)
+{
+#if HOST_CORE
+	put_host_ipc_cmd(nvmeCmd);
+#else
+	handle_nvme_io_cmd(nvmeCmd);
+	ReqTransSliceToLowLevel();
+#endif
+}
+
+unsigned int get_host_ipc_cmd(NVME_COMMAND *nvmeCmd)
+{
+	HOST_IPC_CMD_RING *ring = &g_hostIpc->cmdRing;
+	unsigned int head;
+
+	head = ring->head;
+	if(head == ring->tail)
+		return 0;
+
+	dmb();
+	*nvmeCmd = ring->entry[head & (HOST_IPC_CMD_RING_SIZE - 1)];
+	dmb();
+	ring->head = head + 1;
+
+	return 1;
+}
+
+unsigned int host_ipc_cmd_pending()
+{
+	return g_hostIpc->cmdRing.head != g_hostIpc->cmdRing.tail;
+}
+
+void put_host_ipc_req(unsigned int type, unsigned int *dword)
+{
+	HOST_IPC_REQ_RING *ring = &g_hostIpc->reqRing;
+	HOST_IPC_REQ *req;
+	unsigned int tail;
+
+	//the host interface core drains the ring on every loop, a full ring only stalls the FTL core
+	tail = ring->tail;
+	while((tail - ring->head) == HOST_IPC_REQ_RING_SIZE)
+		;
+
+	req = &ring->entry[tail & (HOST_IPC_REQ_RING_SIZE - 1)];
+	req->type = type;
+	req->dword[0] = dword[0];
+	req->dword[1] = dword[1];
+	req->dword[2] = dword[2];
+	if(type == HOST_IPC_REQ_DMA)
+	{
+		req->dword[3] = dword[3];
+		req->dword[4] = dword[4];
+	}
+	dmb();
+	ring->tail = tail + 1;
+}
+
+void handle_host_ipc_req()
+{
+	HOST_IPC_REQ_RING *ring = &g_hostIpc->reqRing;
+	HOST_IPC_REQ *req;
+	unsigned int head, tail;
+
+	head = ring->head;
+	tail = ring->tail;
+	if(head == tail)
+		return;
+
+	dmb();
+	while(head != tail)
+	{
+		req = &ring->entry[head & (HOST_IPC_REQ_RING_SIZE - 1)];
+		if(req->type == HOST_IPC_REQ_DMA)
+			write_host_dma_cmd_fifo((HOST_DMA_CMD_FIFO_REG*)req->dword);
+		else
+			write_nvme_cpl_fifo((NVME_CPL_FIFO_REG*)req->dword);
+		head++;
+	}
+	dmb();
+	ring->head = head;
+}
+
+void request_ftl_core_shutdown()
+{
+	g_hostIpc->shutdownDone = 0;
+	dmb();
+	g_hostIpc->shutdownReq = 1;
+
+	while(g_hostIpc->shutdownDone == 0)
+		handle_host_ipc_req();
+
+	handle_host_ipc_req();
+}
+
+unsigned int check_ftl_core_shutdown_req()
+{
+	return g_hostIpc->shutdownReq;
+}
+
+void set_ftl_core_shutdown_done()
+{
+	g_hostIpc->shutdownReq = 0;
+	dmb();
+	g_hostIpc->shutdownDone = 1;
+}
+
+void sync_ftl_statistics()
+{
+#if HOST_CORE
+	//the counters live in cached memory of the FTL core, it publishes them to the shared table
+	g_hostIpc->statisticsDone = 0;
+	dmb();
+	g_hostIpc->statisticsReq = 1;
+
+	while(g_hostIpc->statisticsDone == 0)
+		handle_host_ipc_req();
+
+	dmb();
+#else
+	PublishFtlStatistics();
+#endif
+}
+
+unsigned int check_ftl_statistics_req()
+{
+	return g_hostIpc->statisticsReq;
+}
+
+void set_ftl_statistics_done()
+{
+	dmb();
+	g_hostIpc->statisticsReq = 0;
+	g_hostIpc->statisticsDone = 1;
+}
@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////////////
+// host_ipc.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Host Interface to FTL Core Channel
+// File Name: host_ipc.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - declares the rings connecting the host interface core and the FTL core
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __HOST_IPC_H_
+#define __HOST_IPC_H_
+
+#include "xparameters.h"
+#include "nvme.h"
+#include "nvme_async_event.h"
+
+#define DUAL_CORE_FIRMWARE				0			//1: the FTL runs on core 1, needs an FTL core image linked at FTL_CORE_IMAGE_ADDR in the boot image
+#define HOST_CORE_ID					0
+#define FTL_CORE_ID						1
+
+//core 1 is released by writing its entry to this address and signaling an event
+#define FTL_CORE_RELEASE_ADDR			0xFFFFFFF0
+#define FTL_CORE_IMAGE_ADDR				0x00300000	//the FTL core image is linked to reserved region 0
+
+#define FTL_CORE						((DUAL_CORE_FIRMWARE == 1) && (XPAR_CPU_ID == FTL_CORE_ID))
+#define HOST_CORE						((DUAL_CORE_FIRMWARE == 1) && (XPAR_CPU_ID == HOST_CORE_ID))
+
+#define HOST_IPC_CMD_RING_SIZE			256			//power of 2
+#define HOST_IPC_REQ_RING_SIZE			1024		//power of 2
+
+#define HOST_IPC_REQ_DMA				0
+#define HOST_IPC_REQ_CPL				1
+
+//register image of a host DMA or NVMe completion issued on behalf of the FTL core
+typedef struct _HOST_IPC_REQ
+{
+	unsigned int type;
+	unsigned int dword[5];
+} HOST_IPC_REQ;
+
+//single producer, single consumer, head and tail are free running and written by one core each
+typedef struct _HOST_IPC_CMD_RING
+{
+	volatile unsigned int head;
+	volatile unsigned int tail;
+	NVME_COMMAND entry[HOST_IPC_CMD_RING_SIZE];
+} HOST_IPC_CMD_RING;
+
+typedef struct _HOST_IPC_REQ_RING
+{
+	volatile unsigned int head;
+	volatile unsigned int tail;
+	HOST_IPC_REQ entry[HOST_IPC_REQ_RING_SIZE];
+} HOST_IPC_REQ_RING;
+
+typedef struct _HOST_IPC
+{
+	volatile unsigned int ftlReady;
+	volatile unsigned int storageCapacity_L;
+	volatile unsigned int shutdownReq;
+	volatile unsigned int shutdownDone;
+	volatile unsigned int statisticsReq;
+	volatile unsigned int statisticsDone;
+	volatile unsigned int asyncEventCnt[ASYNC_EVENTS];	//FTL core to host interface core
+	volatile unsigned int asyncEventTotalCnt;
+	HOST_IPC_CMD_RING cmdRing;		//host interface core to FTL core
+	HOST_IPC_REQ_RING reqRing;		//FTL core to host interface core
+} HOST_IPC;
+
+void init_host_ipc();
+void start_ftl_core();
+void wait_ftl_core_ready();
+void set_ftl_core_ready();
+
+void put_host_ipc_cmd(NVME_COMMAND *nvmeCmd);
+unsigned int host_ipc_cmd_ring_full();
+void dispatch_nvme_io_cmd(NVME_COMMAND *nvmeCmd);
+unsigned int get_host_ipc_cmd(NVME_COMMAND *nvmeCmd);
+unsigned int host_ipc_cmd_pending();
+
+void put_host_ipc_req(unsigned int type, unsigned int *dword);
+void handle_host_ipc_req();
+
+void request_ftl_core_shutdown();
+unsigned int check_ftl_core_shutdown_req();
+void set_ftl_core_shutdown_done();
+
+void sync_ftl_statistics();
+unsigned int check_ftl_statistics_req();
+void set_ftl_statistics_done();
+
+extern HOST_IPC *g_hostIpc;
+
+#endif	//__HOST_IPC_H_
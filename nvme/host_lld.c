@@ -58,6 +58,7 @@
 
 #include "nvme.h"
 #include "host_lld.h"
+#include "host_ipc.h"
 
 extern NVME_CONTEXT g_nvmeTask;
 HOST_DMA_STATUS g_hostDmaStatus;
@@ -260,30 +261,50 @@ unsigned int get_nvme_cmd(unsigned short *qID, unsigned short *cmdSlotTag, unsig
 	return (unsigned int)nvmeReg.cmdValid;
 }
 
+void write_nvme_cpl_fifo(NVME_CPL_FIFO_REG *nvmeReg)
+{
+	if(nvmeReg->cplType == ONLY_CPL_TYPE)
+		IO_WRITE32(NVME_CPL_FIFO_REG_ADDR, nvmeReg->dword[0]);
+	if(nvmeReg->cplType != CMD_SLOT_RELEASE_TYPE)
+		IO_WRITE32((NVME_CPL_FIFO_REG_ADDR + 4), nvmeReg->dword[1]);
+	IO_WRITE32((NVME_CPL_FIFO_REG_ADDR + 8), nvmeReg->dword[2]);
+}
+
+void issue_nvme_cpl(NVME_CPL_FIFO_REG *nvmeReg)
+{
+#if FTL_CORE
+	//the completion FIFO is written by the host interface core only
+	put_host_ipc_req(HOST_IPC_REQ_CPL, nvmeReg->dword);
+#else
+	write_nvme_cpl_fifo(nvmeReg);
+#endif
+}
+
 void set_auto_nvme_cpl(unsigned int cmdSlotTag, unsigned int specific, unsigned int statusFieldWord)
 {
 	NVME_CPL_FIFO_REG nvmeReg;
 
+	nvmeReg.dword[0] = 0;
+	nvmeReg.dword[2] = 0;
 	nvmeReg.specific = specific;
 	nvmeReg.cmdSlotTag = cmdSlotTag;
 	nvmeReg.statusFieldWord = statusFieldWord;
 	nvmeReg.cplType = AUTO_CPL_TYPE;
 
-	//IO_WRITE32(NVME_CPL_FIFO_REG_ADDR, nvmeReg.dword[0]);
-	IO_WRITE32((NVME_CPL_FIFO_REG_ADDR + 4), nvmeReg.dword[1]);
-	IO_WRITE32((NVME_CPL_FIFO_REG_ADDR + 8), nvmeReg.dword[2]);
+	issue_nvme_cpl(&nvmeReg);
 }
 
 void set_nvme_slot_release(unsigned int cmdSlotTag)
 {
 	NVME_CPL_FIFO_REG nvmeReg;
 
+	nvmeReg.dword[0] = 0;
+	nvmeReg.dword[1] = 0;
+	nvmeReg.dword[2] = 0;
 	nvmeReg.cmdSlotTag = cmdSlotTag;
 	nvmeReg.cplType = CMD_SLOT_RELEASE_TYPE;
 
-	//IO_WRITE32(NVME_CPL_FIFO_REG_ADDR, nvmeReg.dword[0]);
-	//IO_WRITE32((NVME_CPL_FIFO_REG_ADDR + 4), nvmeReg.dword[1]);
-	IO_WRITE32((NVME_CPL_FIFO_REG_ADDR + 8), nvmeReg.dword[2]);
+	issue_nvme_cpl(&nvmeReg);
 }
 
 void set_nvme_cpl(unsigned int sqId, unsigned int cid, unsigned int specific, unsigned int statusFieldWord)
@@ -296,9 +317,7 @@ void set_nvme_cpl(unsigned int sqId, unsigned int cid, unsigned int specific, un
 	nvmeReg.statusFieldWord = statusFieldWord;
 	nvmeReg.cplType = ONLY_CPL_TYPE;
 
-	IO_WRITE32(NVME_CPL_FIFO_REG_ADDR, nvmeReg.dword[0]);
-	IO_WRITE32((NVME_CPL_FIFO_REG_ADDR + 4), nvmeReg.dword[1]);
-	IO_WRITE32((NVME_CPL_FIFO_REG_ADDR + 8), nvmeReg.dword[2]);
+	issue_nvme_cpl(&nvmeReg);
 }
 
 void set_io_sq(unsigned int ioSqIdx, unsigned int valid, unsigned int cqVector, unsigned int qSzie, unsigned int pcieBaseAddrL, unsigned int pcieBaseAddrH)
@@ -336,6 +355,28 @@ void set_io_cq(unsigned int ioCqIdx, unsigned int valid, unsigned int irqEn, uns
 }
 
 
+void write_host_dma_cmd_fifo(HOST_DMA_CMD_FIFO_REG *hostDmaReg)
+{
+	IO_WRITE32(HOST_DMA_CMD_FIFO_REG_ADDR, hostDmaReg->dword[0]);
+	if(hostDmaReg->dmaType == HOST_DMA_DIRECT_TYPE)
+	{
+		IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 4), hostDmaReg->dword[1]);
+		IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 8), hostDmaReg->dword[2]);
+	}
+	IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 12), hostDmaReg->dword[3]);
+	IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 16), hostDmaReg->dword[4]);//slot_modified
+}
+
+void issue_host_dma_cmd(HOST_DMA_CMD_FIFO_REG *hostDmaReg)
+{
+#if FTL_CORE
+	//the DMA command FIFO is written by the host interface core only, the FTL core keeps its own FIFO tails
+	put_host_ipc_req(HOST_IPC_REQ_DMA, hostDmaReg->dword);
+#else
+	write_host_dma_cmd_fifo(hostDmaReg);
+#endif
+}
+
 void set_direct_tx_dma(unsigned int devAddr, unsigned int pcieAddrH, unsigned int pcieAddrL, unsigned int len)
 {
 	HOST_DMA_CMD_FIFO_REG hostDmaReg;
@@ -347,15 +388,12 @@ void set_direct_tx_dma(unsigned int devAddr, unsigned int pcieAddrH, unsigned in
 	hostDmaReg.pcieAddrH = pcieAddrH;
 	
 	hostDmaReg.dword[3] = 0;
+	hostDmaReg.dword[4] = 0;
 	hostDmaReg.dmaType = HOST_DMA_DIRECT_TYPE;
 	hostDmaReg.dmaDirection = HOST_DMA_TX_DIRECTION;
 	hostDmaReg.dmaLen = len;
 
-	IO_WRITE32(HOST_DMA_CMD_FIFO_REG_ADDR, hostDmaReg.dword[0]);
-	IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 4), hostDmaReg.dword[1]);
-	IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 8), hostDmaReg.dword[2]);
-	IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 12), hostDmaReg.dword[3]);
-	IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 16), hostDmaReg.dword[4]);//slot_modified
+	issue_host_dma_cmd(&hostDmaReg);
 
 	g_hostDmaStatus.fifoTail.directDmaTx++;
 	g_hostDmaStatus.directDmaTxCnt++;
@@ -372,15 +410,12 @@ void set_direct_rx_dma(unsigned int devAddr, unsigned int pcieAddrH, unsigned in
 	hostDmaReg.pcieAddrL = pcieAddrL;
 
 	hostDmaReg.dword[3] = 0;
+	hostDmaReg.dword[4] = 0;
 	hostDmaReg.dmaType = HOST_DMA_DIRECT_TYPE;
 	hostDmaReg.dmaDirection = HOST_DMA_RX_DIRECTION;
 	hostDmaReg.dmaLen = len;
 
-	IO_WRITE32(HOST_DMA_CMD_FIFO_REG_ADDR, hostDmaReg.dword[0]);
-	IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 4), hostDmaReg.dword[1]);
-	IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 8), hostDmaReg.dword[2]);
-	IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 12), hostDmaReg.dword[3]);
-	IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 16), hostDmaReg.dword[4]);//slot_modified
+	issue_host_dma_cmd(&hostDmaReg);
 	g_hostDmaStatus.fifoTail.directDmaRx++;
 	g_hostDmaStatus.directDmaRxCnt++;
 
@@ -391,14 +426,19 @@ void set_auto_tx_dma(unsigned int cmdSlotTag, unsigned int cmd4KBOffset, unsigne
 	HOST_DMA_CMD_FIFO_REG hostDmaReg;
 	unsigned char tempTail;
 
-	ASSERT(cmd4KBOffset < 256);
+	ASSERT(cmd4KBOffset < HOST_DMA_MAX_CMD_4KB_OFFSET);
 	
-	g_hostDmaStatus.fifoHead.dword = IO_READ32(HOST_DMA_FIFO_CNT_REG_ADDR);
-	while((g_hostDmaStatus.fifoTail.autoDmaTx + 1) % 256 == g_hostDmaStatus.fifoHead.autoDmaTx)
+	while(g_hostDmaStatus.autoDmaTxFreeCnt == 0)
+	{
 		g_hostDmaStatus.fifoHead.dword = IO_READ32(HOST_DMA_FIFO_CNT_REG_ADDR);
+		g_hostDmaStatus.autoDmaTxFreeCnt = (unsigned char)(g_hostDmaStatus.fifoHead.autoDmaTx - g_hostDmaStatus.fifoTail.autoDmaTx - 1);
+	}
+	g_hostDmaStatus.autoDmaTxFreeCnt--;
 
 	hostDmaReg.devAddr = devAddr;
 
+	hostDmaReg.dword[1] = 0;
+	hostDmaReg.dword[2] = 0;
 	hostDmaReg.dword[3] = 0;
 	hostDmaReg.dmaType = HOST_DMA_AUTO_TYPE;
 	hostDmaReg.dmaDirection = HOST_DMA_TX_DIRECTION;
@@ -406,11 +446,7 @@ void set_auto_tx_dma(unsigned int cmdSlotTag, unsigned int cmd4KBOffset, unsigne
 	hostDmaReg.cmdSlotTag = cmdSlotTag;
 	hostDmaReg.autoCompletion = autoCompletion;
 
-	IO_WRITE32(HOST_DMA_CMD_FIFO_REG_ADDR, hostDmaReg.dword[0]);
-	//IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 4), hostDmaReg.dword[1]);
-	//IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 8), hostDmaReg.dword[2]);
-	IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 12), hostDmaReg.dword[3]);
-	IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 16), hostDmaReg.dword[4]);//slot_modified
+	issue_host_dma_cmd(&hostDmaReg);
 
 	tempTail = g_hostDmaStatus.fifoTail.autoDmaTx++;
 	if(tempTail > g_hostDmaStatus.fifoTail.autoDmaTx)
@@ -424,14 +460,19 @@ void set_auto_rx_dma(unsigned int cmdSlotTag, unsigned int cmd4KBOffset, unsigne
 	HOST_DMA_CMD_FIFO_REG hostDmaReg;
 	unsigned char tempTail;
 
-	ASSERT(cmd4KBOffset < 256);
+	ASSERT(cmd4KBOffset < HOST_DMA_MAX_CMD_4KB_OFFSET);
 	
-	g_hostDmaStatus.fifoHead.dword = IO_READ32(HOST_DMA_FIFO_CNT_REG_ADDR);
-	while((g_hostDmaStatus.fifoTail.autoDmaRx + 1) % 256 == g_hostDmaStatus.fifoHead.autoDmaRx)
+	while(g_hostDmaStatus.autoDmaRxFreeCnt == 0)
+	{
 		g_hostDmaStatus.fifoHead.dword = IO_READ32(HOST_DMA_FIFO_CNT_REG_ADDR);
+		g_hostDmaStatus.autoDmaRxFreeCnt = (unsigned char)(g_hostDmaStatus.fifoHead.autoDmaRx - g_hostDmaStatus.fifoTail.autoDmaRx - 1);
+	}
+	g_hostDmaStatus.autoDmaRxFreeCnt--;
 
 	hostDmaReg.devAddr = devAddr;
 
+	hostDmaReg.dword[1] = 0;
+	hostDmaReg.dword[2] = 0;
 	hostDmaReg.dword[3] = 0;
 	hostDmaReg.dmaType = HOST_DMA_AUTO_TYPE;
 	hostDmaReg.dmaDirection = HOST_DMA_RX_DIRECTION;
@@ -439,11 +480,7 @@ void set_auto_rx_dma(unsigned int cmdSlotTag, unsigned int cmd4KBOffset, unsigne
 	hostDmaReg.cmdSlotTag = cmdSlotTag;
 	hostDmaReg.autoCompletion = autoCompletion;
 
-	IO_WRITE32(HOST_DMA_CMD_FIFO_REG_ADDR, hostDmaReg.dword[0]);
-	//IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 4), hostDmaReg.dword[1]);
-	//IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 8), hostDmaReg.dword[2]);
-	IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 12), hostDmaReg.dword[3]);
-	IO_WRITE32((HOST_DMA_CMD_FIFO_REG_ADDR + 16), hostDmaReg.dword[4]);//slot_modified
+	issue_host_dma_cmd(&hostDmaReg);
 
 	tempTail = g_hostDmaStatus.fifoTail.autoDmaRx++;
 	if(tempTail > g_hostDmaStatus.fifoTail.autoDmaRx)
@@ -452,6 +489,86 @@ void set_auto_rx_dma(unsigned int cmdSlotTag, unsigned int cmd4KBOffset, unsigne
 	g_hostDmaStatus.autoDmaRxCnt++;
 }
 
+void set_auto_tx_dma_range(unsigned int cmdSlotTag, unsigned int cmd4KBOffset, unsigned int devAddr, unsigned int numOf4KB, unsigned int autoCompletion)
+{
+	HOST_DMA_CMD_FIFO_REG hostDmaReg;
+	unsigned char tempTail;
+	unsigned int index;
+
+	ASSERT(cmd4KBOffset + numOf4KB <= HOST_DMA_MAX_CMD_4KB_OFFSET);
+
+	hostDmaReg.dword[1] = 0;
+	hostDmaReg.dword[2] = 0;
+	hostDmaReg.dword[3] = 0;
+	hostDmaReg.dmaType = HOST_DMA_AUTO_TYPE;
+	hostDmaReg.dmaDirection = HOST_DMA_TX_DIRECTION;
+	hostDmaReg.cmdSlotTag = cmdSlotTag;
+	hostDmaReg.autoCompletion = autoCompletion;
+
+	for(index = 0; index < numOf4KB; index++)
+	{
+		//free space of the FIFO is read again only when the entries known to be free are used up,
+		//the count is kept across calls since the FIFO only drains between them
+		while(g_hostDmaStatus.autoDmaTxFreeCnt == 0)
+		{
+			g_hostDmaStatus.fifoHead.dword = IO_READ32(HOST_DMA_FIFO_CNT_REG_ADDR);
+			g_hostDmaStatus.autoDmaTxFreeCnt = (unsigned char)(g_hostDmaStatus.fifoHead.autoDmaTx - g_hostDmaStatus.fifoTail.autoDmaTx - 1);
+		}
+		g_hostDmaStatus.autoDmaTxFreeCnt--;
+
+		hostDmaReg.devAddr = devAddr + index * 4096;
+		hostDmaReg.cmd4KBOffset = cmd4KBOffset + index;
+
+		issue_host_dma_cmd(&hostDmaReg);
+
+		tempTail = g_hostDmaStatus.fifoTail.autoDmaTx++;
+		if(tempTail > g_hostDmaStatus.fifoTail.autoDmaTx)
+			g_hostDmaAssistStatus.autoDmaTxOverFlowCnt++;
+	}
+
+	g_hostDmaStatus.autoDmaTxCnt += numOf4KB;
+}
+
+void set_auto_rx_dma_range(unsigned int cmdSlotTag, unsigned int cmd4KBOffset, unsigned int devAddr, unsigned int numOf4KB, unsigned int autoCompletion)
+{
+	HOST_DMA_CMD_FIFO_REG hostDmaReg;
+	unsigned char tempTail;
+	unsigned int index;
+
+	ASSERT(cmd4KBOffset + numOf4KB <= HOST_DMA_MAX_CMD_4KB_OFFSET);
+
+	hostDmaReg.dword[1] = 0;
+	hostDmaReg.dword[2] = 0;
+	hostDmaReg.dword[3] = 0;
+	hostDmaReg.dmaType = HOST_DMA_AUTO_TYPE;
+	hostDmaReg.dmaDirection = HOST_DMA_RX_DIRECTION;
+	hostDmaReg.cmdSlotTag = cmdSlotTag;
+	hostDmaReg.autoCompletion = autoCompletion;
+
+	for(index = 0; index < numOf4KB; index++)
+	{
+		//free space of the FIFO is read again only when the entries known to be free are used up,
+		//the count is kept across calls since the FIFO only drains between them
+		while(g_hostDmaStatus.autoDmaRxFreeCnt == 0)
+		{
+			g_hostDmaStatus.fifoHead.dword = IO_READ32(HOST_DMA_FIFO_CNT_REG_ADDR);
+			g_hostDmaStatus.autoDmaRxFreeCnt = (unsigned char)(g_hostDmaStatus.fifoHead.autoDmaRx - g_hostDmaStatus.fifoTail.autoDmaRx - 1);
+		}
+		g_hostDmaStatus.autoDmaRxFreeCnt--;
+
+		hostDmaReg.devAddr = devAddr + index * 4096;
+		hostDmaReg.cmd4KBOffset = cmd4KBOffset + index;
+
+		issue_host_dma_cmd(&hostDmaReg);
+
+		tempTail = g_hostDmaStatus.fifoTail.autoDmaRx++;
+		if(tempTail > g_hostDmaStatus.fifoTail.autoDmaRx)
+			g_hostDmaAssistStatus.autoDmaRxOverFlowCnt++;
+	}
+
+	g_hostDmaStatus.autoDmaRxCnt += numOf4KB;
+}
+
 void check_direct_tx_dma_done()
 {
 	while(g_hostDmaStatus.fifoHead.directDmaTx != g_hostDmaStatus.fifoTail.directDmaTx)
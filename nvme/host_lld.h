@@ -85,6 +85,9 @@
 #define HOST_DMA_TX_DIRECTION				(1)
 #define HOST_DMA_RX_DIRECTION				(0)
 
+#define HOST_DMA_FIFO_ENTRY_COUNT			(256)
+#define HOST_DMA_MAX_CMD_4KB_OFFSET			(1 << 9) //width of cmd4KBOffset
+
 #define ONLY_CPL_TYPE						(0)
 #define AUTO_CPL_TYPE						(1)
 #define CMD_SLOT_RELEASE_TYPE				(2)
@@ -317,6 +320,8 @@ typedef struct _HOST_DMA_STATUS
 	unsigned int directDmaRxCnt;
 	unsigned int autoDmaTxCnt;
 	unsigned int autoDmaRxCnt;
+	unsigned int autoDmaTxFreeCnt;
+	unsigned int autoDmaRxFreeCnt;
 } HOST_DMA_STATUS;
 
 
@@ -340,6 +345,10 @@ void set_nvme_admin_queue(unsigned int sqValid, unsigned int cqValid, unsigned i
 
 unsigned int get_nvme_cmd(unsigned short *qID, unsigned short *cmdSlotTag, unsigned int *cmdSeqNum, unsigned int *cmdDword);
 
+void write_nvme_cpl_fifo(NVME_CPL_FIFO_REG *nvmeReg);
+
+void issue_nvme_cpl(NVME_CPL_FIFO_REG *nvmeReg);
+
 void set_auto_nvme_cpl(unsigned int cmdSlotTag, unsigned int specific, unsigned int statusFieldWord);
 
 void set_nvme_slot_release(unsigned int cmdSlotTag);
@@ -350,6 +359,10 @@ void set_io_sq(unsigned int ioSqIdx, unsigned int valid, unsigned int cqVector,
 
 void set_io_cq(unsigned int ioCqIdx, unsigned int valid, unsigned int irqEn, unsigned int irqVector, unsigned int qSzie, unsigned int pcieBaseAddrL, unsigned int pcieBaseAddrH);
 
+void write_host_dma_cmd_fifo(HOST_DMA_CMD_FIFO_REG *hostDmaReg);
+
+void issue_host_dma_cmd(HOST_DMA_CMD_FIFO_REG *hostDmaReg);
+
 void set_direct_tx_dma(unsigned int devAddr, unsigned int pcieAddrH, unsigned int pcieAddrL, unsigned int len);
 
 void set_direct_rx_dma(unsigned int devAddr, unsigned int pcieAddrH, unsigned int pcieAddrL, unsigned int len);
@@ -358,6 +371,10 @@ void set_auto_tx_dma(unsigned int cmdSlotTag, unsigned int cmd4KBOffset, unsigne
 
 void set_auto_rx_dma(unsigned int cmdSlotTag, unsigned int cmd4KBOffset, unsigned int devAddr, unsigned int autoCompletion);
 
+void set_auto_tx_dma_range(unsigned int cmdSlotTag, unsigned int cmd4KBOffset, unsigned int devAddr, unsigned int numOf4KB, unsigned int autoCompletion);
+
+void set_auto_rx_dma_range(unsigned int cmdSlotTag, unsigned int cmd4KBOffset, unsigned int devAddr, unsigned int numOf4KB, unsigned int autoCompletion);
+
 void set_link_width(unsigned int linkNum);
 
 void pcie_async_reset(unsigned int rstCnt);
@@ -59,7 +59,7 @@
 #define STORAGE_CAPACITY_L				0x00000000	// not used
 #define STORAGE_CAPACITY_H				0x00000000
 
-#define MAX_NUM_OF_NLB					(512 * 1024 / 4096)
+#define MAX_NUM_OF_NLB					(2 * 1024 * 1024 / 4096)
 
 /*Opcodes for Admin Commands */
 #define ADMIN_DELETE_IO_SQ									0x00
@@ -85,8 +85,31 @@
 #define IO_NVM_READ											0x02
 #define IO_NVM_WRITE_UNCORRECTABLE							0x04
 #define IO_NVM_COMPARE										0x05
+#define IO_NVM_WRITE_ZEROES									0x08
 #define IO_NVM_DATASET_MANAGEMENT							0x09
 #define IO_NVM_HELLO										0x58
+
+/* Opcodes for Zoned Namespace Command Set */
+#define IO_ZNS_ZONE_MGMT_SEND								0x79
+#define IO_ZNS_ZONE_MGMT_RECV								0x7A
+#define IO_ZNS_ZONE_APPEND									0x7D
+
+/* Opcodes for Key Value Command Set */
+#define IO_KV_STORE											0x01
+#define IO_KV_RETRIEVE										0x02
+#define IO_KV_LIST											0x06
+#define IO_KV_DELETE										0x10
+#define IO_KV_EXIST											0x14
+
+/* Opcodes for Vendor Specific Physical Address Commands */
+#define IO_PHY_ERASE										0x90
+#define IO_PHY_WRITE										0x91
+#define IO_PHY_READ											0x92
+
+/* Opcodes for Vendor Specific Computational Storage Commands */
+#define IO_SCAN_FILTER										0x93
+
+#define MAX_PHY_ADDRS_PER_CMD								64
 /*Status Code Type */
 #define SCT_GENERIC_COMMAND_STATUS							0
 #define SCT_COMMAND_SPECIFIC_STATUS							1
@@ -162,6 +185,23 @@
 #define SC_INVALID_PROTECTION_INFORMATION					0x81//Compare, Read, Write, Write Zeroes
 #define SC_ATTEMPTED_WRITE_TO_READ_ONLY_RANGE				0x82//Dataset Management, Write, Write Uncorrectable, Write Zeroes
 
+/*Status Code - Command Specific Status Values, Key Value Command Set */
+#define SC_KV_INVALID_VALUE_SIZE							0x85//Store, Retrieve
+#define SC_KV_INVALID_KEY_SIZE								0x86//Store, Retrieve, List, Delete, Exist
+#define SC_KV_KEY_DOES_NOT_EXIST							0x87//Store, Retrieve, Delete, Exist
+#define SC_KV_UNRECOVERED_ERROR								0x88//Store, Retrieve
+#define SC_KV_KEY_EXISTS									0x89//Store
+
+/*Status Code - Command Specific Status Values, Zoned Namespace Command Set */
+#define SC_ZONE_BOUNDARY_ERROR								0xB8//Read, Write, Zone Append
+#define SC_ZONE_IS_FULL										0xB9//Write, Zone Append
+#define SC_ZONE_IS_READ_ONLY								0xBA//Write, Zone Append
+#define SC_ZONE_IS_OFFLINE									0xBB//Read, Write, Zone Append
+#define SC_ZONE_INVALID_WRITE								0xBC//Write
+#define SC_TOO_MANY_ACTIVE_ZONES							0xBD//Write, Zone Append, Zone Management Send
+#define SC_TOO_MANY_OPEN_ZONES								0xBE//Write, Zone Append, Zone Management Send
+#define SC_INVALID_ZONE_STATE_TRANSITION					0xBF//Zone Management Send
+
 /*Status Code - Media and Data Integrity Error Values, NVM Command Set */
 #define SC_WRITE_FAULT										0x80
 #define SC_UNRECOVERED_READ_ERROR							0x81
@@ -190,6 +230,31 @@
 #define Timestamp											0x0E
 #define SOFTWARE_PROGRESS_MARKER							0x80
 
+/* Set/Get Features - Vendor Specific Features Identifiers */
+#define NAMESPACE_DIE_SUBSET								0xC0
+#define NAMESPACE_IOPS_LIMIT								0xC1
+#define NAMESPACE_BANDWIDTH_LIMIT							0xC2
+
+
+/* Identify - Command Set Identifiers */
+#define CSI_NVM												0x00
+#define CSI_KV												0x01
+#define CSI_ZNS												0x02
+
+/* Identify - Namespace Identifier Types */
+#define NIDT_CSI											0x04
+
+
+/* Create I/O Submission Queue - Queue Priority */
+#define QPRIO_URGENT										0x0
+#define QPRIO_HIGH											0x1
+#define QPRIO_MEDIUM										0x2
+#define QPRIO_LOW											0x3
+
+/* Controller Configuration - Arbitration Mechanism Selected */
+#define AMS_ROUND_ROBIN										0x0
+#define AMS_WEIGHTED_ROUND_ROBIN_URGENT						0x1
+
 
 #define NVME_TASK_IDLE										0x0
 #define NVME_TASK_WAIT_CC_EN								0x1
@@ -205,6 +270,7 @@ typedef struct _NVME_COMMAND
 	unsigned short cmdSlotTag;
 	unsigned int cmdSeqNum;
 	unsigned int cmdDword[16];
+	unsigned int fetchTime;		//global timer when get_nvme_cmd() returned the command
 }NVME_COMMAND;
 
 typedef struct _NVME_ADMIN_COMMAND
@@ -319,6 +385,32 @@ typedef struct _ADMIN_SET_FEATURES_NUMBER_OF_QUEUES_DW11
 	};
 } ADMIN_SET_FEATURES_NUMBER_OF_QUEUES_DW11;
 
+typedef struct _ADMIN_SET_FEATURES_ARBITRATION_DW11
+{
+	union {
+		unsigned int dword;
+		struct {
+			unsigned char AB			:3;
+			unsigned char reserved0		:5;
+			unsigned char LPW;
+			unsigned char MPW;
+			unsigned char HPW;
+		};
+	};
+} ADMIN_SET_FEATURES_ARBITRATION_DW11;
+
+typedef struct _ADMIN_SET_FEATURES_NAMESPACE_DIE_MAP_DW11
+{
+	union {
+		unsigned int dword;
+		struct {
+			unsigned char chMask;
+			unsigned char wayMask;
+			unsigned short reserved0;
+		};
+	};
+} ADMIN_SET_FEATURES_NAMESPACE_DIE_MAP_DW11;
+
 
 /* Get Features Command */
 typedef struct _ADMIN_GET_FEATURES_DW10
@@ -417,26 +509,82 @@ typedef struct _ADMIN_IDENTIFY_COMMAND_DW10
 	union {
 		unsigned int dword;
 		struct {
-			unsigned int CNS			:2;
-			unsigned int reserved0		:30;
+			unsigned int CNS			:8;
+			unsigned int reserved0		:8;
+			unsigned int CNTID			:16;
 		};
 	};
 } ADMIN_IDENTIFY_COMMAND_DW10;
 
+typedef struct _ADMIN_IDENTIFY_COMMAND_DW11
+{
+	union {
+		unsigned int dword;
+		struct {
+			unsigned int CNSSID			:16;
+			unsigned int reserved0		:8;
+			unsigned int CSI			:8;
+		};
+	};
+} ADMIN_IDENTIFY_COMMAND_DW11;
+
 /* Get Log Page Command */
+#define LOG_PAGE_SMART_HEALTH_INFORMATION					0x02
+#define LOG_PAGE_VENDOR_HOT_PATH_PROFILE					0xC0
+#define LOG_PAGE_VENDOR_FTL_STATISTICS						0xC1
+#define LOG_PAGE_VENDOR_CMD_LATENCY							0xC2
+#define LOG_PAGE_VENDOR_NAND_UTILIZATION					0xC3
+
+#define LOG_PAGE_MAX_SIZE									0x1000
+
 typedef struct _ADMIN_GET_LOG_PAGE_DW10
 {
 	union {
 		unsigned int dword;
 		struct {
 			unsigned char LID;
-			unsigned char reserved0;
+			unsigned char reserved0		:7;
+			unsigned char RAE			:1;		//retain asynchronous event
 			unsigned short NUMD			:12;
 			unsigned short reserved1	:4;
 		};
 	};
 } ADMIN_GET_LOG_PAGE_DW10;
 
+/* Get Log Page - SMART / Health Information Log */
+#define SMART_CRITICAL_WARNING_AVAILABLE_SPARE				0x01
+#define SMART_CRITICAL_WARNING_TEMPERATURE					0x02
+#define SMART_CRITICAL_WARNING_RELIABILITY					0x04
+#define SMART_CRITICAL_WARNING_READ_ONLY					0x08
+#define SMART_CRITICAL_WARNING_VOLATILE_BACKUP				0x10
+
+typedef struct _NVME_SMART_HEALTH_LOG
+{
+	unsigned char criticalWarning;
+	unsigned short compositeTemperature;
+	unsigned char availableSpare;
+	unsigned char availableSpareThreshold;
+	unsigned char percentageUsed;
+	unsigned char reserved0[26];
+
+	//128 bit counters, the data units are thousands of 512 byte units
+	unsigned int dataUnitsRead[4];
+	unsigned int dataUnitsWritten[4];
+	unsigned int hostReadCommands[4];
+	unsigned int hostWriteCommands[4];
+	unsigned int controllerBusyTime[4];
+	unsigned int powerCycles[4];
+	unsigned int powerOnHours[4];
+	unsigned int unsafeShutdowns[4];
+	unsigned int mediaErrors[4];
+	unsigned int numberOfErrorLogEntries[4];
+
+	unsigned int warningCompositeTemperatureTime;
+	unsigned int criticalCompositeTemperatureTime;
+	unsigned short temperatureSensor[8];
+	unsigned char reserved1[296];
+} NVME_SMART_HEALTH_LOG;
+
 /* Identify - Power State Descriptor Data Structure */
 typedef struct _ADMIN_IDENTIFY_POWER_STATE_DESCRIPTOR
 {
@@ -534,7 +682,8 @@ typedef struct _ADMIN_IDENTIFY_CONTROLLER
 		unsigned short supportsCompare							:1;
 		unsigned short supportsWriteUncorrectable				:1;
 		unsigned short supportsDataSetManagement				:1;
-		unsigned short reserved0								:13;
+		unsigned short supportsWriteZeroes						:1;
+		unsigned short reserved0								:12;
 	} ONCS;
 
 	struct
@@ -673,6 +822,58 @@ typedef struct _ADMIN_IDENTIFY_NAMESPACE
 
 } ADMIN_IDENTIFY_NAMESPACE;
 
+/* Identify - Namespace Identification Descriptor */
+typedef struct _ADMIN_IDENTIFY_NAMESPACE_ID_DESCRIPTOR
+{
+	unsigned char NIDT;
+	unsigned char NIDL;
+	unsigned char reserved0[2];
+	unsigned char NID[16];
+} ADMIN_IDENTIFY_NAMESPACE_ID_DESCRIPTOR;
+
+/* Identify - Zoned Namespace LBA Format Extension Data Structure */
+typedef struct _ADMIN_IDENTIFY_ZNS_FORMAT_EXTENSION
+{
+	unsigned int ZSZE[2];
+	unsigned char ZDES;
+	unsigned char reserved0[7];
+} ADMIN_IDENTIFY_ZNS_FORMAT_EXTENSION;
+
+/* I/O Command Set Specific Identify Namespace Data Structure for Zoned Namespace Command Set */
+typedef struct _ADMIN_IDENTIFY_ZNS_NAMESPACE
+{
+	struct
+	{
+		unsigned short supportsVariableZoneCapacity			:1;
+		unsigned short supportsZoneActiveExcursions			:1;
+		unsigned short reserved0							:14;
+	} ZOC;
+
+	struct
+	{
+		unsigned short supportsReadAcrossZoneBoundaries		:1;
+		unsigned short reserved0							:15;
+	} OZCS;
+
+	unsigned int MAR;
+	unsigned int MOR;
+	unsigned int RRL;
+	unsigned int FRL;
+
+	unsigned char reserved0[2796];
+
+	ADMIN_IDENTIFY_ZNS_FORMAT_EXTENSION LBAFEx[16];
+
+	unsigned char VS[1024];
+} ADMIN_IDENTIFY_ZNS_NAMESPACE;
+
+/* I/O Command Set Specific Identify Controller Data Structure for Zoned Namespace Command Set */
+typedef struct _ADMIN_IDENTIFY_ZNS_CONTROLLER
+{
+	unsigned char ZASL;
+	unsigned char reserved0[4095];
+} ADMIN_IDENTIFY_ZNS_CONTROLLER;
+
 /* Identify Active Namespace Data Structure */
 typedef struct _ADMIN_IDENTIFY_ACTIVE_NAMESPACE
 {
@@ -767,6 +968,133 @@ typedef struct _IO_READ_COMMAND_DW15
 } IO_READ_COMMAND_DW15;
 
 
+/* Zone Management Send Command */
+typedef struct _IO_ZONE_MGMT_SEND_COMMAND_DW13
+{
+	union {
+		unsigned int dword;
+		struct {
+			unsigned int ZSA						:8;
+			unsigned int SELECT_ALL					:1;
+			unsigned int ZSASO						:1;
+			unsigned int reserved0					:22;
+		};
+	};
+} IO_ZONE_MGMT_SEND_COMMAND_DW13;
+
+/* Zone Management Receive Command */
+typedef struct _IO_ZONE_MGMT_RECV_COMMAND_DW13
+{
+	union {
+		unsigned int dword;
+		struct {
+			unsigned int ZRA						:8;
+			unsigned int ZRASF						:8;
+			unsigned int PARTIAL					:1;
+			unsigned int reserved0					:15;
+		};
+	};
+} IO_ZONE_MGMT_RECV_COMMAND_DW13;
+
+/* Physical Address Commands */
+typedef struct _IO_PHY_COMMAND_DW12
+{
+	union {
+		unsigned int dword;
+		struct {
+			unsigned int NPA						:6;	//0's based number of physical addresses
+			unsigned int reserved0					:26;
+		};
+	};
+} IO_PHY_COMMAND_DW12;
+
+/* Scan Filter - range of the scan and size of the result buffer, the start LBA is placed in DW10-11 */
+typedef struct _IO_SCAN_COMMAND_DW12
+{
+	union {
+		unsigned int dword;
+		struct {
+			unsigned int NLB						:16;	//0's based number of logical blocks scanned
+			unsigned int NDB						:8;		//0's based number of 4KB result blocks
+			unsigned int reserved0					:8;
+		};
+	};
+} IO_SCAN_COMMAND_DW12;
+
+/* Scan Filter - record layout, the compared value is placed in DW15 */
+typedef struct _IO_SCAN_COMMAND_DW13
+{
+	union {
+		unsigned int dword;
+		struct {
+			unsigned int RS							:16;	//record size in bytes
+			unsigned int FO							:16;	//field offset in a record
+		};
+	};
+} IO_SCAN_COMMAND_DW13;
+
+typedef struct _IO_SCAN_COMMAND_DW14
+{
+	union {
+		unsigned int dword;
+		struct {
+			unsigned int FS							:8;		//field size in bytes, little endian
+			unsigned int OP							:8;		//compare operator
+			unsigned int reserved0					:16;
+		};
+	};
+} IO_SCAN_COMMAND_DW14;
+
+/* Key Value - key length and store options, the key itself is placed in DW2-3 and DW14-15 */
+typedef struct _IO_KV_COMMAND_DW11
+{
+	union {
+		unsigned int dword;
+		struct {
+			unsigned int KL							:8;	//key length in bytes
+			unsigned int SO							:8;	//store option
+			unsigned int reserved0					:16;
+		};
+	};
+} IO_KV_COMMAND_DW11;
+
+/* Physical Address - a page of a die, listed in host memory or placed in DW10-11 for a single address,
+   BLOCK counts the PHY_IO_BLOCKS_PER_DIE blocks of a die left to physical address I/O, PAGE counts the SLC pages of a block */
+typedef struct _IO_PHY_ADDR
+{
+	union {
+		unsigned int dword[2];
+		struct {
+			unsigned int PAGE						:16;
+			unsigned int BLOCK						:16;
+			unsigned int WAY						:8;
+			unsigned int CH							:8;
+			unsigned int reserved0					:16;
+		};
+	};
+} IO_PHY_ADDR;
+
+/* Report Zones - Zone Report Header */
+typedef struct _ZONE_REPORT_HEADER
+{
+	unsigned int NZ[2];
+	unsigned char reserved0[56];
+} ZONE_REPORT_HEADER;
+
+/* Report Zones - Zone Descriptor Data Structure */
+typedef struct _ZONE_DESCRIPTOR
+{
+	unsigned char ZT;
+	unsigned char ZS;
+	unsigned char ZA;
+	unsigned char reserved0[5];
+	unsigned int ZCAP[2];
+	unsigned int ZSLBA[2];
+	unsigned int WP[2];
+	unsigned char reserved1[32];
+} ZONE_DESCRIPTOR;
+
+
 /* IO Dataset Management Command */
 typedef struct _IO_DATASET_MANAGEMENT_COMMAND_DW10
 {
@@ -819,6 +1147,8 @@ typedef struct _NVME_IO_SQ_STATUS
 	unsigned short qSzie;
 	unsigned int pcieBaseAddrL;
 	unsigned int pcieBaseAddrH;
+	unsigned char qPrio;
+	unsigned char reserved0[3];
 } NVME_IO_SQ_STATUS;
 
 typedef struct _NVME_IO_CQ_STATUS
@@ -54,6 +54,15 @@
 #include "host_lld.h"
 #include "nvme_identify.h"
 #include "nvme_admin_cmd.h"
+#include "nvme_qos.h"
+#include "host_ipc.h"
+#include "nvme_async_event.h"
+
+#include "../address_translation.h"
+#include "../hot_path_profile.h"
+#include "../ftl_statistics.h"
+#include "../cmd_latency_trace.h"
+#include "../nand_utilization.h"
 
 extern NVME_CONTEXT g_nvmeTask;
 
@@ -111,12 +120,14 @@ void handle_set_features(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
 		}
 		case ARBITRATION:
 		{
+			set_io_sq_arbitration(nvmeAdminCmd->dword11);
 			nvmeCPL->dword[0] = 0x0;
 			nvmeCPL->specific = 0x0;
 			break;
 		}
 		case ASYNCHRONOUS_EVENT_CONFIGURATION:
 		{
+			set_async_event_config(nvmeAdminCmd->dword11);
 			nvmeCPL->dword[0] = 0x0;
 			nvmeCPL->specific = 0x0;
 			break;
@@ -141,6 +152,35 @@ void handle_set_features(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
 			nvmeCPL->specific = 0x0;
 			break;
 		}
+		case NAMESPACE_DIE_SUBSET:
+		{
+			ADMIN_SET_FEATURES_NAMESPACE_DIE_MAP_DW11 dieMap;
+
+			dieMap.dword = nvmeAdminCmd->dword11;
+			nvmeCPL->dword[0] = 0x0;
+			nvmeCPL->specific = 0x0;
+			if((nvmeAdminCmd->NSID == 0) || (nvmeAdminCmd->NSID > USER_NAMESPACES) || !SetNamespaceDieMap(nvmeAdminCmd->NSID - 1, dieMap.chMask, dieMap.wayMask))
+				nvmeCPL->statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
+			break;
+		}
+		case NAMESPACE_IOPS_LIMIT:
+		{
+			nvmeCPL->dword[0] = 0x0;
+			nvmeCPL->specific = 0x0;
+			if((nvmeAdminCmd->NSID == 0) || (nvmeAdminCmd->NSID > USER_NAMESPACES) ||
+				!set_namespace_rate_limit(nvmeAdminCmd->NSID, nvmeAdminCmd->dword11, g_namespaceQos[nvmeAdminCmd->NSID - 1].bandwidth.rate / NVME_BLOCKS_PER_MB))
+				nvmeCPL->statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
+			break;
+		}
+		case NAMESPACE_BANDWIDTH_LIMIT:
+		{
+			nvmeCPL->dword[0] = 0x0;
+			nvmeCPL->specific = 0x0;
+			if((nvmeAdminCmd->NSID == 0) || (nvmeAdminCmd->NSID > USER_NAMESPACES) ||
+				!set_namespace_rate_limit(nvmeAdminCmd->NSID, g_namespaceQos[nvmeAdminCmd->NSID - 1].iops.rate, nvmeAdminCmd->dword11))
+				nvmeCPL->statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
+			break;
+		}
 		default:
 		{
 			xil_printf("Not Support FID (Set): %X\r\n", features.FID);
@@ -160,6 +200,12 @@ void handle_get_features(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
 
 	switch(features.FID)
 	{
+		case ARBITRATION:
+		{
+			nvmeCPL->dword[0] = 0x0;
+			nvmeCPL->specific = get_io_sq_arbitration();
+			break;
+		}
 		case LBA_RANGE_TYPE:
 		{
 			ASSERT(nvmeAdminCmd->NSID == 1);
@@ -176,6 +222,12 @@ void handle_get_features(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
 			nvmeCPL->specific = nvmeAdminCmd->dword11;
 			break;
 		}
+		case ASYNCHRONOUS_EVENT_CONFIGURATION:
+		{
+			nvmeCPL->dword[0] = 0x0;
+			nvmeCPL->specific = get_async_event_config();
+			break;
+		}
 		case VOLATILE_WRITE_CACHE:
 		{
 			
@@ -202,6 +254,22 @@ void handle_get_features(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
 			nvmeCPL->specific = 0x0;
 			break;
 		}
+		case NAMESPACE_DIE_SUBSET:
+		case NAMESPACE_IOPS_LIMIT:
+		case NAMESPACE_BANDWIDTH_LIMIT:
+		{
+			nvmeCPL->dword[0] = 0x0;
+			nvmeCPL->specific = 0x0;
+			if((nvmeAdminCmd->NSID == 0) || (nvmeAdminCmd->NSID > USER_NAMESPACES))
+				nvmeCPL->statusField.SC = SC_INVALID_FIELD_IN_COMMAND;
+			else if(features.FID == NAMESPACE_DIE_SUBSET)
+				nvmeCPL->specific = namespaceDieMap.ns[nvmeAdminCmd->NSID - 1].chMask | (namespaceDieMap.ns[nvmeAdminCmd->NSID - 1].wayMask << 8);
+			else if(features.FID == NAMESPACE_IOPS_LIMIT)
+				nvmeCPL->specific = g_namespaceQos[nvmeAdminCmd->NSID - 1].iops.rate;
+			else
+				nvmeCPL->specific = g_namespaceQos[nvmeAdminCmd->NSID - 1].bandwidth.rate / NVME_BLOCKS_PER_MB;
+			break;
+		}
 		default:
 		{
 			xil_printf("Not Support FID (Get): %X\r\n", features.FID);
@@ -238,6 +306,7 @@ void handle_create_io_sq(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
 	ioSqStatus->cqVector = sqInfo11.CQID;
 	ioSqStatus->pcieBaseAddrL = nvmeAdminCmd->PRP1[0];
 	ioSqStatus->pcieBaseAddrH = nvmeAdminCmd->PRP1[1];
+	set_io_sq_priority(ioSqIdx, sqInfo11.QPRIO);
 
 	set_io_sq(ioSqIdx, ioSqStatus->valid, ioSqStatus->cqVector, ioSqStatus->qSzie, ioSqStatus->pcieBaseAddrL, ioSqStatus->pcieBaseAddrH);
 
@@ -266,6 +335,7 @@ void handle_delete_io_sq(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
 	ioSqStatus->pcieBaseAddrH = 0;
 
 	set_io_sq(ioSqIdx, 0, 0, 0, 0, 0);
+	abort_io_sq_stage(ioSqIdx);
 
 	nvmeCPL->dword[0] = 0;
 	nvmeCPL->specific = 0x0;
@@ -331,11 +401,13 @@ void handle_delete_io_cq(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
 void handle_identify(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL)
 {
 	ADMIN_IDENTIFY_COMMAND_DW10 identifyInfo;
+	ADMIN_IDENTIFY_COMMAND_DW11 identifyInfo11;
 	unsigned int pIdentifyData = ADMIN_CMD_DRAM_DATA_BUFFER;
 	unsigned int prp[2];
 	unsigned int prpLen;
 
 	identifyInfo.dword = nvmeAdminCmd->dword10;
+	identifyInfo11.dword = nvmeAdminCmd->dword11;
 
 	if(identifyInfo.CNS == 1)
 	{
@@ -351,12 +423,24 @@ void handle_identify(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL)
 			xil_printf("NI: %X, %X, %X, %X\r\n", nvmeAdminCmd->PRP1[1], nvmeAdminCmd->PRP1[0], nvmeAdminCmd->PRP2[1], nvmeAdminCmd->PRP2[0]);
 		//ASSERT(nvmeAdminCmd->NSID == 1);
 		ASSERT((nvmeAdminCmd->PRP1[0] & 0x3) == 0 && (nvmeAdminCmd->PRP2[0] & 0x3) == 0);
-		identify_namespace(pIdentifyData);
+		identify_namespace(pIdentifyData, nvmeAdminCmd->NSID);
 	}
 	else if(identifyInfo.CNS == 2)
 	{
 		identify_active_namespace(pIdentifyData);
 	}
+	else if(identifyInfo.CNS == 3)
+	{
+		identify_namespace_id_descriptor(pIdentifyData, nvmeAdminCmd->NSID);
+	}
+	else if(identifyInfo.CNS == 5)
+	{
+		identify_zns_namespace(pIdentifyData, nvmeAdminCmd->NSID, identifyInfo11.CSI);
+	}
+	else if(identifyInfo.CNS == 6)
+	{
+		identify_zns_controller(pIdentifyData, identifyInfo11.CSI);
+	}
 	else
 		ASSERT(0);
 	
@@ -383,35 +467,91 @@ void handle_identify(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL)
 	nvmeCPL->specific = 0x0;
 }
 
-void handle_get_log_page(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL)
+void set_admin_tx_data(NVME_ADMIN_COMMAND *nvmeAdminCmd, unsigned int devAddr, unsigned int len)
 {
-	//ADMIN_GET_LOG_PAGE_DW10 getLogPageInfo;
+	unsigned int prp[2];
+	unsigned int prpLen;
 
-	//unsigned int prp1[2];
-	//unsigned int prp2[2];
-	//unsigned int prpLen;
+	//the data of an admin command spans at most two memory pages, PRP2 points to the second one
+	prp[0] = nvmeAdminCmd->PRP1[0];
+	prp[1] = nvmeAdminCmd->PRP1[1];
+	prpLen = 0x1000 - (prp[0] & 0xFFF);
+	if(prpLen > len)
+		prpLen = len;
 
-	//getLogPageInfo.dword = nvmeAdminCmd->dword10;
+	set_direct_tx_dma(devAddr, prp[1], prp[0], prpLen);
+	if(prpLen != len)
+	{
+		prp[0] = nvmeAdminCmd->PRP2[0];
+		prp[1] = nvmeAdminCmd->PRP2[1];
+		set_direct_tx_dma(devAddr + prpLen, prp[1], prp[0], len - prpLen);
+	}
 
-	//prp1[0] = nvmeAdminCmd->PRP1[0];
-	//prp1[1] = nvmeAdminCmd->PRP1[1];
-	//prpLen = 0x1000 - (prp1[0] & 0xFFF);
+	check_direct_tx_dma_done();
+}
 
-	//prp2[0] = nvmeAdminCmd->PRP2[0];
-	//prp2[1] = nvmeAdminCmd->PRP2[1];
+void handle_get_log_page(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL)
+{
+	ADMIN_GET_LOG_PAGE_DW10 getLogPageInfo;
+	unsigned int pLogData = ADMIN_CMD_DRAM_DATA_BUFFER;
+	unsigned int len;
 
-	//xil_printf("ADMIN GET LOG PAGE\n");
+	getLogPageInfo.dword = nvmeAdminCmd->dword10;
+	len = (getLogPageInfo.NUMD + 1) * 4;
+	if(len > LOG_PAGE_MAX_SIZE)
+		len = LOG_PAGE_MAX_SIZE;
 
-	//LID
-	//Mandatory//1-Error information, 2-SMART/Health information, 3-Firmware Slot information
-	//Optional//4-ChangedNamespaceList, 5-Command Effects Log
-	//xil_printf("LID: 0x%X, NUMD: 0x%X \r\n", getLogPageInfo.LID, getLogPageInfo.NUMD);
+	nvmeCPL->dword[0] = 0;
+	nvmeCPL->specific = 0x0;
 
-	//xil_printf("PRP1[63:32] = 0x%X, PRP1[31:0] = 0x%X", prp1[1], prp1[0]);
-	//xil_printf("PRP2[63:32] = 0x%X, PRP2[31:0] = 0x%X", prp2[1], prp2[0]);
+	//bytes beyond the end of a log page are returned as zero
+	memset((void*)pLogData, 0, LOG_PAGE_MAX_SIZE);
 
-	nvmeCPL->dword[0] = 0;
-	nvmeCPL->specific = 0x9;//invalid log page
+	switch(getLogPageInfo.LID)
+	{
+		case LOG_PAGE_SMART_HEALTH_INFORMATION:
+		{
+			sync_ftl_statistics();
+			MakeSmartHealthLog(pLogData);
+			break;
+		}
+		case LOG_PAGE_VENDOR_HOT_PATH_PROFILE:
+		{
+			MakeHotPathProfileLog(pLogData);
+			break;
+		}
+		case LOG_PAGE_VENDOR_FTL_STATISTICS:
+		{
+			sync_ftl_statistics();
+			MakeFtlStatisticsLog(pLogData);
+			break;
+		}
+		case LOG_PAGE_VENDOR_CMD_LATENCY:
+		{
+			sync_ftl_statistics();
+			MakeCmdLatencyLog(pLogData);
+			break;
+		}
+		case LOG_PAGE_VENDOR_NAND_UTILIZATION:
+		{
+			sync_ftl_statistics();
+			MakeNandUtilizationLog(pLogData);
+			break;
+		}
+		default:
+		{
+			xil_printf("Not Support LID: %X\r\n", getLogPageInfo.LID);
+			nvmeCPL->statusField.SCT = SCT_COMMAND_SPECIFIC_STATUS;
+			nvmeCPL->statusField.SC = SC_INVALID_LOG_PAGE;
+			return;
+		}
+	}
+
+	set_admin_tx_data(nvmeAdminCmd, pLogData, len);
+
+	//events reported with this log page can be reported again
+	if(!getLogPageInfo.RAE)
+		clear_async_event(getLogPageInfo.LID);
 }
 
 void handle_nvme_admin_cmd(NVME_COMMAND *nvmeCmd)
@@ -424,6 +564,20 @@ void handle_nvme_admin_cmd(NVME_COMMAND *nvmeCmd)
 	nvmeAdminCmd = (NVME_ADMIN_COMMAND*)nvmeCmd->cmdDword;
 	opc = (unsigned int)nvmeAdminCmd->OPC;
 
+#if HOST_CORE
+	if(opc == ADMIN_SET_FEATURES)
+	{
+		ADMIN_SET_FEATURES_DW10 features;
+
+		//the namespace die map is FTL state, the FTL core handles it in order with IO commands
+		features.dword = nvmeAdminCmd->dword10;
+		if(features.FID == NAMESPACE_DIE_SUBSET)
+		{
+			put_host_ipc_cmd(nvmeCmd);
+			return;
+		}
+	}
+#endif
 
 	needCpl = 1;
 	needSlotRelease = 0;
@@ -481,10 +635,17 @@ void handle_nvme_admin_cmd(NVME_COMMAND *nvmeCmd)
 		}
 		case ADMIN_ASYNCHRONOUS_EVENT_REQUEST:
 		{
+			//the request is completed with the CID once an event occurs
 			needCpl = 0;
 			needSlotRelease = 1;
 			nvmeCPL.dword[0] = 0;
 			nvmeCPL.specific = 0x0;
+			if(!put_async_event_request(nvmeAdminCmd->CID))
+			{
+				needCpl = 1;
+				nvmeCPL.statusField.SCT = SCT_COMMAND_SPECIFIC_STATUS;
+				nvmeCPL.statusField.SC = SC_ASYNCHRONOUS_EVENT_REQUEST_LIMIT_EXCEEDED;
+			}
 			break;
 		}
 		case ADMIN_GET_LOG_PAGE:
@@ -64,6 +64,8 @@ void handle_delete_io_sq(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvme
 
 void handle_identify(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL);
 
+void set_admin_tx_data(NVME_ADMIN_COMMAND *nvmeAdminCmd, unsigned int devAddr, unsigned int len);
+
 void handle_get_log_page(NVME_ADMIN_COMMAND *nvmeAdminCmd, NVME_COMPLETION *nvmeCPL);
 
 void handle_nvme_admin_cmd(NVME_COMMAND *nvmeCmd);
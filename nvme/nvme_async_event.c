@@ -0,0 +1,179 @@
+//////////////////////////////////////////////////////////////////////////////////
+// nvme_async_event.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: NVMe Asynchronous Event
+// File Name: nvme_async_event.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - counts events raised by the FTL core in memory shared with the host interface core
+//   - holds asynchronous event requests and completes them with pending events
+//   - masks a reported event until the host reads its log page
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#include "xil_printf.h"
+#include "xpseudo_asm.h"
+#include "debug.h"
+#include "string.h"
+
+#include "nvme.h"
+#include "host_lld.h"
+#include "host_ipc.h"
+#include "nvme_async_event.h"
+
+ASYNC_EVENT_CONTEXT g_asyncEvent;
+
+static const unsigned char asyncEventType[ASYNC_EVENTS] = {
+	ASYNC_EVENT_TYPE_SMART_HEALTH, ASYNC_EVENT_TYPE_VENDOR_SPECIFIC, ASYNC_EVENT_TYPE_VENDOR_SPECIFIC
+};
+static const unsigned char asyncEventInfo[ASYNC_EVENTS] = {
+	ASYNC_EVENT_INFO_SPARE_BELOW_THRESHOLD, ASYNC_EVENT_INFO_FREE_BLOCK_LOW, ASYNC_EVENT_INFO_WEAR_LEVEL
+};
+static const unsigned char asyncEventLogPage[ASYNC_EVENTS] = {
+	LOG_PAGE_SMART_HEALTH_INFORMATION, LOG_PAGE_VENDOR_FTL_STATISTICS, LOG_PAGE_VENDOR_FTL_STATISTICS
+};
+//critical warning bit enabling a SMART / health event, vendor specific events are always enabled
+static const unsigned char asyncEventConfigMask[ASYNC_EVENTS] = {
+	SMART_CRITICAL_WARNING_AVAILABLE_SPARE, 0, 0
+};
+
+void init_async_event()
+{
+	memset(&g_asyncEvent, 0, sizeof(g_asyncEvent));
+	g_asyncEvent.config = ASYNC_EVENT_CONFIG_DEFAULT;
+	g_asyncEvent.recheck = 1;
+}
+
+void reset_async_event()
+{
+	//requests of a reset controller are not completed, events not reported yet stay pending
+	g_asyncEvent.head = 0;
+	g_asyncEvent.cnt = 0;
+	g_asyncEvent.maskedEvent = 0;
+	g_asyncEvent.config = ASYNC_EVENT_CONFIG_DEFAULT;
+	g_asyncEvent.recheck = 1;
+}
+
+void raise_async_event(unsigned int event)
+{
+	//written by the FTL core only, the host interface core polls the total count
+	g_hostIpc->asyncEventCnt[event]++;
+	dmb();
+	g_hostIpc->asyncEventTotalCnt++;
+}
+
+unsigned int put_async_event_request(unsigned int cid)
+{
+	if(g_asyncEvent.cnt == MAX_NUM_OF_AER)
+		return 0;
+
+	g_asyncEvent.cid[(g_asyncEvent.head + g_asyncEvent.cnt) % MAX_NUM_OF_AER] = cid;
+	g_asyncEvent.cnt++;
+	g_asyncEvent.recheck = 1;
+
+	return 1;
+}
+
+void set_async_event_config(unsigned int dword11)
+{
+	g_asyncEvent.config = dword11;
+	g_asyncEvent.recheck = 1;
+}
+
+unsigned int get_async_event_config()
+{
+	return g_asyncEvent.config;
+}
+
+void clear_async_event(unsigned int logPageId)
+{
+	unsigned int event;
+
+	for(event = 0; event < ASYNC_EVENTS; event++)
+		if(asyncEventLogPage[event] == logPageId)
+			g_asyncEvent.maskedEvent &= ~(1 << event);
+
+	g_asyncEvent.recheck = 1;
+}
+
+static void complete_async_event(unsigned int event)
+{
+	ASYNC_EVENT_COMPLETION_DW0 cpl;
+
+	cpl.dword = 0;
+	cpl.eventType = asyncEventType[event];
+	cpl.eventInfo = asyncEventInfo[event];
+	cpl.logPageId = asyncEventLogPage[event];
+
+	set_nvme_cpl(0, g_asyncEvent.cid[g_asyncEvent.head], cpl.dword, 0);
+	g_asyncEvent.head = (g_asyncEvent.head + 1) % MAX_NUM_OF_AER;
+	g_asyncEvent.cnt--;
+
+	g_asyncEvent.maskedEvent |= (1 << event);
+
+	xil_printf("Asynchronous event: type %X, info %X, log page %X\r\n", cpl.eventType, cpl.eventInfo, cpl.logPageId);
+}
+
+void check_async_event()
+{
+	unsigned int totalCnt, event, eventCnt;
+
+	//one read of the shared memory per loop unless an event or a request is pending
+	totalCnt = g_hostIpc->asyncEventTotalCnt;
+	if((totalCnt == g_asyncEvent.checkedTotalCnt) && !g_asyncEvent.recheck)
+		return;
+
+	dmb();
+	g_asyncEvent.checkedTotalCnt = totalCnt;
+	g_asyncEvent.recheck = 0;
+
+	for(event = 0; event < ASYNC_EVENTS; event++)
+	{
+		eventCnt = g_hostIpc->asyncEventCnt[event];
+		if(eventCnt == g_asyncEvent.reportedCnt[event])
+			continue;
+
+		if(asyncEventConfigMask[event] && !(g_asyncEvent.config & asyncEventConfigMask[event]))
+		{
+			//a disabled event is dropped, not reported later
+			g_asyncEvent.reportedCnt[event] = eventCnt;
+			continue;
+		}
+
+		//a masked event waits for its log page to be read, any event waits for a request
+		if((g_asyncEvent.maskedEvent & (1 << event)) || (g_asyncEvent.cnt == 0))
+			continue;
+
+		complete_async_event(event);
+		g_asyncEvent.reportedCnt[event] = eventCnt;
+	}
+}
@@ -0,0 +1,98 @@
+//////////////////////////////////////////////////////////////////////////////////
+// nvme_async_event.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: NVMe Asynchronous Event
+// File Name: nvme_async_event.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - define asynchronous events raised by the FTL and outstanding asynchronous event requests
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __NVME_ASYNC_EVENT_H_
+#define __NVME_ASYNC_EVENT_H_
+
+#define MAX_NUM_OF_AER						4		//asynchronous event request limit (AERL + 1)
+
+#define ASYNC_EVENT_TYPE_SMART_HEALTH		0x1
+#define ASYNC_EVENT_TYPE_VENDOR_SPECIFIC	0x7
+
+#define ASYNC_EVENT_INFO_SPARE_BELOW_THRESHOLD	0x02
+#define ASYNC_EVENT_INFO_FREE_BLOCK_LOW			0x00	//vendor specific
+#define ASYNC_EVENT_INFO_WEAR_LEVEL				0x01	//vendor specific
+
+#define ASYNC_EVENT_CONFIG_DEFAULT			0xFF	//every SMART / health critical warning is reported
+
+//events raised by the FTL
+#define ASYNC_EVENT_SPARE_BELOW_THRESHOLD	0		//available spare of a die fell below the threshold
+#define ASYNC_EVENT_FREE_BLOCK_LOW			1		//free blocks of a die fell to the critical watermark, GC stalls writes soon
+#define ASYNC_EVENT_WEAR_LEVEL				2		//percentage used crossed a wear step
+#define ASYNC_EVENTS						3
+
+typedef struct _ASYNC_EVENT_COMPLETION_DW0
+{
+	union {
+		unsigned int dword;
+		struct {
+			unsigned int eventType		:3;
+			unsigned int reserved0		:5;
+			unsigned int eventInfo		:8;
+			unsigned int logPageId		:8;
+			unsigned int reserved1		:8;
+		};
+	};
+} ASYNC_EVENT_COMPLETION_DW0;
+
+typedef struct _ASYNC_EVENT_CONTEXT
+{
+	unsigned short cid[MAX_NUM_OF_AER];		//outstanding requests, completed in arrival order
+	unsigned int head;
+	unsigned int cnt;
+	unsigned int config;					//asynchronous event configuration feature
+	unsigned int maskedEvent;				//reported events, unmasked when the host reads their log page
+	unsigned int recheck;
+	unsigned int checkedTotalCnt;
+	unsigned int reportedCnt[ASYNC_EVENTS];
+} ASYNC_EVENT_CONTEXT;
+
+void init_async_event();
+void reset_async_event();
+void raise_async_event(unsigned int event);
+
+unsigned int put_async_event_request(unsigned int cid);
+void set_async_event_config(unsigned int dword11);
+unsigned int get_async_event_config();
+void clear_async_event(unsigned int logPageId);
+void check_async_event();
+
+extern ASYNC_EVENT_CONTEXT g_asyncEvent;
+
+#endif	//__NVME_ASYNC_EVENT_H_
@@ -55,7 +55,9 @@
 
 #include "nvme.h"
 #include "nvme_identify.h"
+#include "nvme_async_event.h"
 #include "../ftl_config.h"
+#include "../zone_management.h"
 
 void identify_controller(unsigned int pBuffer)
 {
@@ -84,7 +86,7 @@ void identify_controller(unsigned int pBuffer)
 	identifyCNTL->IEEE[1] = 0xD2;
 	identifyCNTL->IEEE[2] = 0x5C;
 	identifyCNTL->CMIC = 0x0;
-	identifyCNTL->MDTS = 0x8;
+	identifyCNTL->MDTS = 0x9;	//2MB, limited by the 4KB offset field of the host DMA
 	identifyCNTL->CNTLID = 0x9;
 
 	identifyCNTL->OACS.supportsSecuritySendSecurityReceive = 0x0;
@@ -92,12 +94,12 @@ void identify_controller(unsigned int pBuffer)
 	identifyCNTL->OACS.supportsFirmwareActivateFirmwareDownload = 0x0;
 
 	identifyCNTL->ACL = 0x3;
-	identifyCNTL->AERL = 0x3;
+	identifyCNTL->AERL = MAX_NUM_OF_AER - 1;
 
 	identifyCNTL->FRMW.firstFirmwareSlotReadOnly = 0x1;
 	identifyCNTL->FRMW.supportedNumberOfFirmwareSlots = 0x1;
 
-	identifyCNTL->LPA.supportsSMARTHealthInformationLogPage = 0x0;
+	identifyCNTL->LPA.supportsSMARTHealthInformationLogPage = 0x0;	//the SMART log is kept for the controller, not per namespace
 
 	identifyCNTL->ELPE = 0x8;
 	identifyCNTL->NPSS = 0x0;
@@ -110,11 +112,12 @@ void identify_controller(unsigned int pBuffer)
 	identifyCNTL->CQES.requiredCompletionQueueEntrySize = 0x4;
 	identifyCNTL->CQES.maximumCompletionQueueEntrySize = 0x4;
 
-	identifyCNTL->NN = USER_CHANNELS;
+	identifyCNTL->NN = USER_NAMESPACES;
 
-	identifyCNTL->ONCS.supportsCompare = 0x0;
+	identifyCNTL->ONCS.supportsCompare = 0x1;
 	identifyCNTL->ONCS.supportsWriteUncorrectable = 0x0;
 	identifyCNTL->ONCS.supportsDataSetManagement = 0x0;
+	identifyCNTL->ONCS.supportsWriteZeroes = 0x1;
 
 	identifyCNTL->FUSES.supportsCompareWrite = 0x0;
 
@@ -145,19 +148,26 @@ void identify_controller(unsigned int pBuffer)
 	powerStateDesc->RWL = 0x0;
 }
 
-void identify_namespace(unsigned int pBuffer)
+void identify_namespace(unsigned int pBuffer, unsigned int nsid)
 {
 	ADMIN_IDENTIFY_NAMESPACE *identifyNS;
 	ADMIN_IDENTIFY_FORMAT_DATA *formatData;
+	unsigned int nsze;
 	identifyNS = (ADMIN_IDENTIFY_NAMESPACE *)pBuffer;
 
 	memset(identifyNS, 0, sizeof(ADMIN_IDENTIFY_NAMESPACE));
 
-	identifyNS->NSZE[0] = storageCapacity_L / USER_CHANNELS;
+	//the zoned namespace ends at the last whole zone
+	if(ZONED_NAMESPACE_ID && (nsid == ZONED_NAMESPACE_ID))
+		nsze = zoneMapPtr->zoneCnt * NVME_BLOCKS_PER_ZONE;
+	else
+		nsze = storageCapacity_L / USER_NAMESPACES;
+
+	identifyNS->NSZE[0] = nsze;
 	identifyNS->NSZE[1] = STORAGE_CAPACITY_H;
-	identifyNS->NCAP[0] = storageCapacity_L / USER_CHANNELS;
+	identifyNS->NCAP[0] = nsze;
 	identifyNS->NCAP[1] = STORAGE_CAPACITY_H;
-	identifyNS->NUSE[0] = storageCapacity_L / USER_CHANNELS;
+	identifyNS->NUSE[0] = nsze;
 	identifyNS->NUSE[1] = STORAGE_CAPACITY_H;
 
 	identifyNS->NSFEAT.supportsThinProvisioning = 0x0;
@@ -196,6 +206,58 @@ void identify_namespace(unsigned int pBuffer)
 	formatData->RP = 0x2;
 }
 
+void identify_namespace_id_descriptor(unsigned int pBuffer, unsigned int nsid)
+{
+	ADMIN_IDENTIFY_NAMESPACE_ID_DESCRIPTOR *idDesc;
+	idDesc = (ADMIN_IDENTIFY_NAMESPACE_ID_DESCRIPTOR *)pBuffer;
+
+	memset((void *)pBuffer, 0, 4096);
+
+	//only the command set identifier is reported, the list ends with a zero descriptor
+	idDesc->NIDT = NIDT_CSI;
+	idDesc->NIDL = 0x1;
+	if(ZONED_NAMESPACE_ID && (nsid == ZONED_NAMESPACE_ID))
+		idDesc->NID[0] = CSI_ZNS;
+	else if(KV_NAMESPACE_ID && (nsid == KV_NAMESPACE_ID))
+		idDesc->NID[0] = CSI_KV;
+	else
+		idDesc->NID[0] = CSI_NVM;
+}
+
+void identify_zns_namespace(unsigned int pBuffer, unsigned int nsid, unsigned int csi)
+{
+	ADMIN_IDENTIFY_ZNS_NAMESPACE *identifyZNS;
+	identifyZNS = (ADMIN_IDENTIFY_ZNS_NAMESPACE *)pBuffer;
+
+	memset(identifyZNS, 0, sizeof(ADMIN_IDENTIFY_ZNS_NAMESPACE));
+
+	if((csi != CSI_ZNS) || !ZONED_NAMESPACE_ID || (nsid != ZONED_NAMESPACE_ID))
+		return;
+
+	identifyZNS->ZOC.supportsVariableZoneCapacity = 0x0;
+	identifyZNS->ZOC.supportsZoneActiveExcursions = 0x0;
+	identifyZNS->OZCS.supportsReadAcrossZoneBoundaries = 0x1;
+
+	//0's based values
+	identifyZNS->MAR = MAX_ACTIVE_ZONES - 1;
+	identifyZNS->MOR = MAX_OPEN_ZONES - 1;
+
+	identifyZNS->LBAFEx[0].ZSZE[0] = NVME_BLOCKS_PER_ZONE;
+	identifyZNS->LBAFEx[0].ZDES = 0x0;
+}
+
+void identify_zns_controller(unsigned int pBuffer, unsigned int csi)
+{
+	ADMIN_IDENTIFY_ZNS_CONTROLLER *identifyZNS;
+	identifyZNS = (ADMIN_IDENTIFY_ZNS_CONTROLLER *)pBuffer;
+
+	memset(identifyZNS, 0, sizeof(ADMIN_IDENTIFY_ZNS_CONTROLLER));
+
+	//zone append size limit is same as MDTS
+	if(csi == CSI_ZNS)
+		identifyZNS->ZASL = 0x0;
+}
+
 void identify_active_namespace(unsigned int pBuffer)
 {
     ADMIN_IDENTIFY_ACTIVE_NAMESPACE *identifyNS;
@@ -204,7 +266,7 @@ void identify_active_namespace(unsigned int pBuffer)
     identifyNS = (ADMIN_IDENTIFY_ACTIVE_NAMESPACE *)pBuffer;
     memset(identifyNS, 0, sizeof(ADMIN_IDENTIFY_ACTIVE_NAMESPACE));
 
-    for(i = 0; i < USER_CHANNELS; i++)
+    for(i = 0; i < USER_NAMESPACES; i++)
     {
         identifyNS->active_namespace[i] = i + 1;
     }
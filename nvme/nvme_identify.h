@@ -57,7 +57,13 @@
 
 void identify_controller(unsigned int pBuffer);
 
-void identify_namespace(unsigned int pBuffer);
+void identify_namespace(unsigned int pBuffer, unsigned int nsid);
+
+void identify_namespace_id_descriptor(unsigned int pBuffer, unsigned int nsid);
+
+void identify_zns_namespace(unsigned int pBuffer, unsigned int nsid, unsigned int csi);
+
+void identify_zns_controller(unsigned int pBuffer, unsigned int csi);
 
 
 #endif	//__NVME_IDENTIFY_H_
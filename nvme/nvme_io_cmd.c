@@ -60,6 +60,22 @@
 
 #include "../ftl_config.h"
 #include "../request_transform.h"
+#include "../memory_map.h"
+
+void set_nvme_io_cpl_status(unsigned int cmdSlotTag, unsigned int statusCode)
+{
+	NVME_COMPLETION nvmeCPL;
+
+	nvmeCPL.dword[0] = 0;
+	nvmeCPL.specific = 0x0;
+	if((statusCode >= SC_ZONE_BOUNDARY_ERROR) || ((statusCode >= SC_KV_INVALID_VALUE_SIZE) && (statusCode <= SC_KV_KEY_EXISTS)))
+		nvmeCPL.statusField.SCT = SCT_COMMAND_SPECIFIC_STATUS;
+	else
+		nvmeCPL.statusField.SCT = SCT_GENERIC_COMMAND_STATUS;
+	nvmeCPL.statusField.SC = statusCode;
+
+	set_auto_nvme_cpl(cmdSlotTag, nvmeCPL.specific, nvmeCPL.statusFieldWord);
+}
 
 void handle_nvme_io_read(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
 {
@@ -79,12 +95,12 @@ void handle_nvme_io_read(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
 	startLba[1] = nvmeIOCmd->dword[11];
 	nlb = readInfo12.NLB;
 
-	ASSERT(startLba[0] < storageCapacity_L / USER_CHANNELS && (startLba[1] < STORAGE_CAPACITY_H || startLba[1] == 0));
+	ASSERT(startLba[0] < storageCapacity_L / USER_NAMESPACES && (startLba[1] < STORAGE_CAPACITY_H || startLba[1] == 0));
 	//ASSERT(nlb < MAX_NUM_OF_NLB);
 	ASSERT((nvmeIOCmd->PRP1[0] & 0x3) == 0 && (nvmeIOCmd->PRP2[0] & 0x3) == 0); //error
 	ASSERT(nvmeIOCmd->PRP1[1] < 0x10000 && nvmeIOCmd->PRP2[1] < 0x10000);
 
-	ReqTransNvmeToSlice(cmdSlotTag, startLba[0] + (storageCapacity_L / USER_CHANNELS) * (nsid - 1), nlb, IO_NVM_READ);
+	ReqTransNvmeToSlice(cmdSlotTag, startLba[0] + (storageCapacity_L / USER_NAMESPACES) * (nsid - 1), nlb, IO_NVM_READ);
 }
 
 
@@ -94,7 +110,7 @@ void handle_nvme_io_write(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
 	//IO_READ_COMMAND_DW13 writeInfo13;
 	//IO_READ_COMMAND_DW15 writeInfo15;
 	unsigned int startLba[2];
-	unsigned int nlb;
+	unsigned int nlb, writeLba, statusCode;
 	unsigned int nsid = nvmeIOCmd->NSID;
 
 	writeInfo12.dword = nvmeIOCmd->dword[12];
@@ -108,13 +124,357 @@ void handle_nvme_io_write(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
 	startLba[1] = nvmeIOCmd->dword[11];
 	nlb = writeInfo12.NLB;
 
-	ASSERT(startLba[0] < storageCapacity_L / USER_CHANNELS && (startLba[1] < STORAGE_CAPACITY_H || startLba[1] == 0));
+	ASSERT(startLba[0] < storageCapacity_L / USER_NAMESPACES && (startLba[1] < STORAGE_CAPACITY_H || startLba[1] == 0));
 	//ASSERT(nlb < MAX_NUM_OF_NLB);
 	ASSERT((nvmeIOCmd->PRP1[0] & 0xF) == 0 && (nvmeIOCmd->PRP2[0] & 0xF) == 0);
 	ASSERT(nvmeIOCmd->PRP1[1] < 0x10000 && nvmeIOCmd->PRP2[1] < 0x10000);
 
-	ReqTransNvmeToSlice(cmdSlotTag, startLba[0] + (storageCapacity_L / USER_CHANNELS) * (nsid - 1), nlb, IO_NVM_WRITE);
+	//zones are written only at their write pointers
+	if(ZONED_NAMESPACE_ID && (nsid == ZONED_NAMESPACE_ID))
+	{
+		statusCode = CheckZoneWrite(startLba[0], nlb, 0, &writeLba);
+		if(statusCode != SC_SUCCESSFUL_COMPLETION)
+		{
+			set_nvme_io_cpl_status(cmdSlotTag, statusCode);
+			return;
+		}
+	}
+
+	ReqTransNvmeToSlice(cmdSlotTag, startLba[0] + (storageCapacity_L / USER_NAMESPACES) * (nsid - 1), nlb, IO_NVM_WRITE);
+}
+
+void handle_nvme_io_write_zeroes(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
+{
+	IO_WRITE_COMMAND_DW12 writeInfo12;
+	unsigned int startLba, numOfNvmeBlock;
+	unsigned int nsid = nvmeIOCmd->NSID;
+
+	writeInfo12.dword = nvmeIOCmd->dword[12];
+
+	startLba = nvmeIOCmd->dword[10];
+	numOfNvmeBlock = writeInfo12.NLB + 1;
+	if((nvmeIOCmd->dword[11] != 0) || (startLba >= storageCapacity_L / USER_NAMESPACES) || (numOfNvmeBlock > storageCapacity_L / USER_NAMESPACES - startLba))
+	{
+		set_nvme_io_cpl_status(cmdSlotTag, SC_LBA_OUT_OF_RANGE);
+		return;
+	}
+
+	//no data is transferred, zeroed slices are served from the map
+	ZeroNvmeBlocks(cmdSlotTag, startLba + (storageCapacity_L / USER_NAMESPACES) * (nsid - 1), numOfNvmeBlock);
+
+	set_nvme_io_cpl_status(cmdSlotTag, SC_SUCCESSFUL_COMPLETION);
+}
+
+void handle_nvme_io_compare(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
+{
+	IO_READ_COMMAND_DW12 readInfo12;
+	NVME_COMPLETION nvmeCPL;
+	unsigned int startLba, numOfNvmeBlock;
+	unsigned int nsid = nvmeIOCmd->NSID;
+
+	readInfo12.dword = nvmeIOCmd->dword[12];
+
+	startLba = nvmeIOCmd->dword[10];
+	numOfNvmeBlock = readInfo12.NLB + 1;
+	if((nvmeIOCmd->dword[11] != 0) || (startLba >= storageCapacity_L / USER_NAMESPACES) || (numOfNvmeBlock > storageCapacity_L / USER_NAMESPACES - startLba))
+	{
+		set_nvme_io_cpl_status(cmdSlotTag, SC_LBA_OUT_OF_RANGE);
+		return;
+	}
+	if(numOfNvmeBlock > MAX_NUM_OF_NLB)
+	{
+		set_nvme_io_cpl_status(cmdSlotTag, SC_INVALID_FIELD_IN_COMMAND);
+		return;
+	}
+
+	set_auto_rx_dma_range(cmdSlotTag, 0, COMPARE_BUFFER_ADDR, numOfNvmeBlock, NVME_COMMAND_AUTO_COMPLETION_OFF);
+	check_auto_rx_dma_done();
+
+	//miscompare is a media and data integrity error
+	nvmeCPL.dword[0] = 0;
+	nvmeCPL.specific = 0x0;
+	if(CompareNvmeBlocks(cmdSlotTag, startLba + (storageCapacity_L / USER_NAMESPACES) * (nsid - 1), numOfNvmeBlock, COMPARE_BUFFER_ADDR) == SC_SUCCESSFUL_COMPLETION)
+	{
+		nvmeCPL.statusField.SCT = SCT_GENERIC_COMMAND_STATUS;
+		nvmeCPL.statusField.SC = SC_SUCCESSFUL_COMPLETION;
+	}
+	else
+	{
+		nvmeCPL.statusField.SCT = SCT_MEDIA_AND_DATA_INTEGRITY_ERRORS;
+		nvmeCPL.statusField.SC = SC_COMPARE_FAILURE;
+	}
+
+	set_auto_nvme_cpl(cmdSlotTag, nvmeCPL.specific, nvmeCPL.statusFieldWord);
+}
+
+void handle_nvme_io_zone_append(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
+{
+	IO_READ_COMMAND_DW12 appendInfo12;
+	unsigned int startLba[2];
+	unsigned int nlb, writeLba, statusCode;
+	unsigned int nsid = nvmeIOCmd->NSID;
+
+	appendInfo12.dword = nvmeIOCmd->dword[12];
+
+	startLba[0] = nvmeIOCmd->dword[10];
+	startLba[1] = nvmeIOCmd->dword[11];
+	nlb = appendInfo12.NLB;
+
+	ASSERT((nvmeIOCmd->PRP1[0] & 0xF) == 0 && (nvmeIOCmd->PRP2[0] & 0xF) == 0);
+	ASSERT(nvmeIOCmd->PRP1[1] < 0x10000 && nvmeIOCmd->PRP2[1] < 0x10000);
+
+	if(startLba[1] != 0)
+	{
+		set_nvme_io_cpl_status(cmdSlotTag, SC_LBA_OUT_OF_RANGE);
+		return;
+	}
+
+	//the device picks the LBA at the write pointer of the zone starting at SLBA
+	statusCode = CheckZoneWrite(startLba[0], nlb, 1, &writeLba);
+	if(statusCode != SC_SUCCESSFUL_COMPLETION)
+	{
+		set_nvme_io_cpl_status(cmdSlotTag, statusCode);
+		return;
+	}
+
+	//the completion returns the assigned LBA once all data is received
+	SetDeferredNvmeCpl(cmdSlotTag, writeLba, nlb + 1);
+	ReqTransNvmeToSlice(cmdSlotTag, writeLba + (storageCapacity_L / USER_NAMESPACES) * (nsid - 1), nlb, IO_NVM_WRITE);
+}
+
+void handle_nvme_io_zone_mgmt_send(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
+{
+	IO_ZONE_MGMT_SEND_COMMAND_DW13 sendInfo13;
+	unsigned int statusCode;
+
+	sendInfo13.dword = nvmeIOCmd->dword[13];
+
+	if(nvmeIOCmd->dword[11] != 0)
+		statusCode = SC_LBA_OUT_OF_RANGE;
+	else
+		statusCode = ZoneManagementSend(cmdSlotTag, nvmeIOCmd->dword[10], sendInfo13.ZSA, sendInfo13.SELECT_ALL);
+
+	set_nvme_io_cpl_status(cmdSlotTag, statusCode);
+}
+
+void handle_nvme_io_zone_mgmt_recv(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
+{
+	IO_ZONE_MGMT_RECV_COMMAND_DW13 recvInfo13;
+	unsigned int statusCode, transferBytes;
+
+	recvInfo13.dword = nvmeIOCmd->dword[13];
+
+	//number of dwords is 0's based
+	transferBytes = (nvmeIOCmd->dword[12] + 1) * 4;
+	if(transferBytes > ZONE_REPORT_BUFFER_SIZE)
+		transferBytes = ZONE_REPORT_BUFFER_SIZE;
+
+	if(recvInfo13.ZRA != ZONE_RECV_ACTION_REPORT_ZONES)
+		statusCode = SC_INVALID_FIELD_IN_COMMAND;
+	else if(nvmeIOCmd->dword[11] != 0)
+		statusCode = SC_LBA_OUT_OF_RANGE;
+	else
+		statusCode = MakeZoneReport(nvmeIOCmd->dword[10], recvInfo13.ZRASF, recvInfo13.PARTIAL, ZONE_REPORT_BUFFER_ADDR, transferBytes);
+
+	if(statusCode == SC_SUCCESSFUL_COMPLETION)
+	{
+		set_auto_tx_dma_range(cmdSlotTag, 0, ZONE_REPORT_BUFFER_ADDR, (transferBytes + BYTES_PER_NVME_BLOCK - 1) / BYTES_PER_NVME_BLOCK, NVME_COMMAND_AUTO_COMPLETION_OFF);
+		check_auto_tx_dma_done();
+	}
+
+	set_nvme_io_cpl_status(cmdSlotTag, statusCode);
+}
+void handle_nvme_io_phy(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd, unsigned int reqCode)
+{
+	IO_PHY_COMMAND_DW12 phyInfo12;
+	IO_PHY_ADDR *phyAddr;
+	unsigned int numOfPhyAddr, listLen, addrIdx;
+
+	phyInfo12.dword = nvmeIOCmd->dword[12];
+	numOfPhyAddr = phyInfo12.NPA + 1;
+
+	//a single address is placed in the command, a vector is fetched from host memory
+	if(numOfPhyAddr == 1)
+		phyAddr = (IO_PHY_ADDR *)&nvmeIOCmd->dword[10];
+	else
+	{
+		listLen = numOfPhyAddr * sizeof(IO_PHY_ADDR);
+		if(((nvmeIOCmd->dword[10] & 0x7) != 0) || ((nvmeIOCmd->dword[10] & 0xFFF) + listLen > 0x1000))
+		{
+			set_nvme_io_cpl_status(cmdSlotTag, SC_INVALID_FIELD_IN_COMMAND);
+			return;
+		}
+
+		set_direct_rx_dma(PHY_ADDR_LIST_ADDR, nvmeIOCmd->dword[11], nvmeIOCmd->dword[10], listLen);
+		check_direct_rx_dma_done();
+		phyAddr = (IO_PHY_ADDR *)PHY_ADDR_LIST_ADDR;
+	}
+
+	for(addrIdx = 0; addrIdx < numOfPhyAddr; addrIdx++)
+		if((phyAddr[addrIdx].CH >= USER_CHANNELS) || (phyAddr[addrIdx].WAY >= USER_WAYS) || (phyAddr[addrIdx].BLOCK >= PHY_IO_BLOCKS_PER_DIE) || (phyAddr[addrIdx].PAGE >= USER_PAGES_PER_BLOCK))
+		{
+			set_nvme_io_cpl_status(cmdSlotTag, SC_INVALID_FIELD_IN_COMMAND);
+			return;
+		}
+
+	if(reqCode == REQ_CODE_WRITE)
+	{
+		for(addrIdx = 0; addrIdx < numOfPhyAddr; addrIdx++)
+			set_auto_rx_dma_range(cmdSlotTag, addrIdx * NVME_BLOCKS_PER_SLICE, PHY_IO_DATA_BUFFER_BASE_ADDR + addrIdx * BYTES_PER_PHY_IO_DATA_BUFFER_ENTRY,
+					NVME_BLOCKS_PER_SLICE, NVME_COMMAND_AUTO_COMPLETION_OFF);
+		check_auto_rx_dma_done();
+	}
+
+	//requests go to the dies without translation and run in parallel across the vector
+	for(addrIdx = 0; addrIdx < numOfPhyAddr; addrIdx++)
+		ReqTransPhyToLowLevel(cmdSlotTag, reqCode, phyAddr[addrIdx].CH, phyAddr[addrIdx].WAY, phyAddr[addrIdx].BLOCK, phyAddr[addrIdx].PAGE,
+				PHY_IO_DATA_BUFFER_BASE_ADDR + addrIdx * BYTES_PER_PHY_IO_DATA_BUFFER_ENTRY);
+
+	//the physical I/O buffer is reused by the next command
+	SyncAllLowLevelReqDone();
+
+	if(reqCode == REQ_CODE_READ)
+	{
+		for(addrIdx = 0; addrIdx < numOfPhyAddr; addrIdx++)
+			set_auto_tx_dma_range(cmdSlotTag, addrIdx * NVME_BLOCKS_PER_SLICE, PHY_IO_DATA_BUFFER_BASE_ADDR + addrIdx * BYTES_PER_PHY_IO_DATA_BUFFER_ENTRY,
+					NVME_BLOCKS_PER_SLICE, NVME_COMMAND_AUTO_COMPLETION_OFF);
+		check_auto_tx_dma_done();
+	}
+
+	set_nvme_io_cpl_status(cmdSlotTag, SC_SUCCESSFUL_COMPLETION);
+}
+
+void handle_nvme_io_scan_filter(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
+{
+	IO_SCAN_COMMAND_DW12 scanInfo12;
+	IO_SCAN_COMMAND_DW13 scanInfo13;
+	IO_SCAN_COMMAND_DW14 scanInfo14;
+	SCAN_PREDICATE predicate;
+	NVME_COMPLETION nvmeCPL;
+	unsigned int nsid, startLba, numOfNvmeBlock, bufSize, resultBytes, statusCode;
+
+	scanInfo12.dword = nvmeIOCmd->dword[12];
+	scanInfo13.dword = nvmeIOCmd->dword[13];
+	scanInfo14.dword = nvmeIOCmd->dword[14];
+	nsid = nvmeIOCmd->NSID;
+
+	startLba = nvmeIOCmd->dword[10];
+	numOfNvmeBlock = scanInfo12.NLB + 1;
+	if((nvmeIOCmd->dword[11] != 0) || (startLba >= storageCapacity_L / USER_NAMESPACES) || (numOfNvmeBlock > storageCapacity_L / USER_NAMESPACES - startLba))
+	{
+		set_nvme_io_cpl_status(cmdSlotTag, SC_LBA_OUT_OF_RANGE);
+		return;
+	}
+
+	predicate.recordSize = scanInfo13.RS;
+	predicate.fieldOffset = scanInfo13.FO;
+	predicate.fieldSize = scanInfo14.FS;
+	predicate.compareOp = scanInfo14.OP;
+	predicate.value = nvmeIOCmd->dword[15];
+
+	statusCode = CheckScanPredicate(&predicate);
+	if(statusCode != SC_SUCCESSFUL_COMPLETION)
+	{
+		set_nvme_io_cpl_status(cmdSlotTag, statusCode);
+		return;
+	}
+
+	bufSize = (scanInfo12.NDB + 1) * BYTES_PER_NVME_BLOCK;
+	if(bufSize > SCAN_RESULT_BUFFER_SIZE)
+		bufSize = SCAN_RESULT_BUFFER_SIZE;
+
+	resultBytes = ScanFilter(cmdSlotTag, startLba + (storageCapacity_L / USER_NAMESPACES) * (nsid - 1), numOfNvmeBlock, &predicate, SCAN_RESULT_BUFFER_ADDR, bufSize);
+
+	//only the filled part of the result buffer crosses PCIe
+	set_auto_tx_dma_range(cmdSlotTag, 0, SCAN_RESULT_BUFFER_ADDR, (resultBytes + BYTES_PER_NVME_BLOCK - 1) / BYTES_PER_NVME_BLOCK, NVME_COMMAND_AUTO_COMPLETION_OFF);
+	check_auto_tx_dma_done();
+
+	nvmeCPL.dword[0] = 0;
+	nvmeCPL.specific = ((P_SCAN_RESULT_HEADER)SCAN_RESULT_BUFFER_ADDR)->matchedRecordCnt;
+	set_auto_nvme_cpl(cmdSlotTag, nvmeCPL.specific, nvmeCPL.statusFieldWord);
+}
+
+void get_nvme_io_kv_key(NVME_IO_COMMAND *nvmeIOCmd, unsigned int *key, unsigned int keySize)
+{
+	unsigned char *keyByte;
+	unsigned int byteNo;
+
+	key[0] = nvmeIOCmd->dword[2];
+	key[1] = nvmeIOCmd->dword[3];
+	key[2] = nvmeIOCmd->dword[14];
+	key[3] = nvmeIOCmd->dword[15];
+
+	//bytes beyond the key length are not part of the key
+	keyByte = (unsigned char *)key;
+	for(byteNo = keySize; byteNo < KV_MAX_KEY_SIZE; byteNo++)
+		keyByte[byteNo] = 0;
 }
+
+void handle_nvme_io_kv(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
+{
+	IO_KV_COMMAND_DW11 kvInfo11;
+	unsigned int key[KV_MAX_KEY_SIZE / 4];
+	unsigned int statusCode, transferBytes;
+
+	kvInfo11.dword = nvmeIOCmd->dword[11];
+	get_nvme_io_kv_key(nvmeIOCmd, key, kvInfo11.KL);
+
+	switch(nvmeIOCmd->OPC)
+	{
+		case IO_KV_STORE:
+		{
+			//on success the completion is posted once the value is transferred
+			statusCode = KvStore(cmdSlotTag, key, kvInfo11.KL, nvmeIOCmd->dword[10], kvInfo11.SO);
+			if(statusCode != SC_SUCCESSFUL_COMPLETION)
+				set_nvme_io_cpl_status(cmdSlotTag, statusCode);
+			break;
+		}
+		case IO_KV_RETRIEVE:
+		{
+			statusCode = KvRetrieve(cmdSlotTag, key, kvInfo11.KL, nvmeIOCmd->dword[10]);
+			if(statusCode != SC_SUCCESSFUL_COMPLETION)
+				set_nvme_io_cpl_status(cmdSlotTag, statusCode);
+			break;
+		}
+		case IO_KV_LIST:
+		{
+			transferBytes = nvmeIOCmd->dword[10];
+			if(transferBytes > KV_LIST_BUFFER_SIZE)
+				transferBytes = KV_LIST_BUFFER_SIZE;
+
+			statusCode = KvList(key, kvInfo11.KL, KV_LIST_BUFFER_ADDR, transferBytes);
+			if(statusCode == SC_SUCCESSFUL_COMPLETION)
+			{
+				set_auto_tx_dma_range(cmdSlotTag, 0, KV_LIST_BUFFER_ADDR, (transferBytes + BYTES_PER_NVME_BLOCK - 1) / BYTES_PER_NVME_BLOCK, NVME_COMMAND_AUTO_COMPLETION_OFF);
+				check_auto_tx_dma_done();
+			}
+
+			set_nvme_io_cpl_status(cmdSlotTag, statusCode);
+			break;
+		}
+		case IO_KV_DELETE:
+		{
+			set_nvme_io_cpl_status(cmdSlotTag, KvDelete(key, kvInfo11.KL));
+			break;
+		}
+		case IO_KV_EXIST:
+		{
+			set_nvme_io_cpl_status(cmdSlotTag, KvExist(key, kvInfo11.KL));
+			break;
+		}
+		case IO_NVM_FLUSH:
+		{
+			set_nvme_io_cpl_status(cmdSlotTag, SC_SUCCESSFUL_COMPLETION);
+			break;
+		}
+		default:
+		{
+			set_nvme_io_cpl_status(cmdSlotTag, SC_INVALID_COMMAND_OPCODE);
+			break;
+		}
+	}
+}
+
 void handle_nvme_io_hello(unsigned int cmdSlotTag, NVME_IO_COMMAND *nvmeIOCmd)
 {
 	NVME_COMPLETION nvmeCPL;
@@ -143,6 +503,15 @@ void handle_nvme_io_cmd(NVME_COMMAND *nvmeCmd)
 
 
 	opc = (unsigned int)nvmeIOCmd->OPC;
+	CmdLatencyTraceStart(nvmeCmd->cmdSlotTag, GetCmdLatencyClass(opc, nvmeIOCmd->NSID), nvmeCmd->fetchTime);
+
+	//the key value command set reuses opcodes of the NVM command set
+	if(KV_NAMESPACE_ID && (nvmeIOCmd->NSID == KV_NAMESPACE_ID))
+	{
+		handle_nvme_io_kv(nvmeCmd->cmdSlotTag, nvmeIOCmd);
+		CmdLatencyTraceHandled(nvmeCmd->cmdSlotTag);
+		return;
+	}
 
 	switch(opc)
 	{
@@ -166,6 +535,73 @@ void handle_nvme_io_cmd(NVME_COMMAND *nvmeCmd)
 			handle_nvme_io_read(nvmeCmd->cmdSlotTag, nvmeIOCmd);
 			break;
 		}
+		case IO_NVM_WRITE_ZEROES:
+		{
+			//zones are written at the write pointer only
+			if(!ZONED_NAMESPACE_ID || (nvmeIOCmd->NSID != ZONED_NAMESPACE_ID))
+				handle_nvme_io_write_zeroes(nvmeCmd->cmdSlotTag, nvmeIOCmd);
+			else
+				set_nvme_io_cpl_status(nvmeCmd->cmdSlotTag, SC_INVALID_COMMAND_OPCODE);
+			break;
+		}
+		case IO_NVM_COMPARE:
+		{
+			handle_nvme_io_compare(nvmeCmd->cmdSlotTag, nvmeIOCmd);
+			break;
+		}
+		case IO_ZNS_ZONE_APPEND:
+		{
+			if(ZONED_NAMESPACE_ID && (nvmeIOCmd->NSID == ZONED_NAMESPACE_ID))
+				handle_nvme_io_zone_append(nvmeCmd->cmdSlotTag, nvmeIOCmd);
+			else
+				set_nvme_io_cpl_status(nvmeCmd->cmdSlotTag, SC_INVALID_COMMAND_OPCODE);
+			break;
+		}
+		case IO_ZNS_ZONE_MGMT_SEND:
+		{
+			if(ZONED_NAMESPACE_ID && (nvmeIOCmd->NSID == ZONED_NAMESPACE_ID))
+				handle_nvme_io_zone_mgmt_send(nvmeCmd->cmdSlotTag, nvmeIOCmd);
+			else
+				set_nvme_io_cpl_status(nvmeCmd->cmdSlotTag, SC_INVALID_COMMAND_OPCODE);
+			break;
+		}
+		case IO_ZNS_ZONE_MGMT_RECV:
+		{
+			if(ZONED_NAMESPACE_ID && (nvmeIOCmd->NSID == ZONED_NAMESPACE_ID))
+				handle_nvme_io_zone_mgmt_recv(nvmeCmd->cmdSlotTag, nvmeIOCmd);
+			else
+				set_nvme_io_cpl_status(nvmeCmd->cmdSlotTag, SC_INVALID_COMMAND_OPCODE);
+			break;
+		}
+		case IO_PHY_WRITE:
+		{
+			if(PHY_IO_BLOCKS_PER_DIE)
+				handle_nvme_io_phy(nvmeCmd->cmdSlotTag, nvmeIOCmd, REQ_CODE_WRITE);
+			else
+				set_nvme_io_cpl_status(nvmeCmd->cmdSlotTag, SC_INVALID_COMMAND_OPCODE);
+			break;
+		}
+		case IO_PHY_READ:
+		{
+			if(PHY_IO_BLOCKS_PER_DIE)
+				handle_nvme_io_phy(nvmeCmd->cmdSlotTag, nvmeIOCmd, REQ_CODE_READ);
+			else
+				set_nvme_io_cpl_status(nvmeCmd->cmdSlotTag, SC_INVALID_COMMAND_OPCODE);
+			break;
+		}
+		case IO_PHY_ERASE:
+		{
+			if(PHY_IO_BLOCKS_PER_DIE)
+				handle_nvme_io_phy(nvmeCmd->cmdSlotTag, nvmeIOCmd, REQ_CODE_ERASE);
+			else
+				set_nvme_io_cpl_status(nvmeCmd->cmdSlotTag, SC_INVALID_COMMAND_OPCODE);
+			break;
+		}
+		case IO_SCAN_FILTER:
+		{
+			handle_nvme_io_scan_filter(nvmeCmd->cmdSlotTag, nvmeIOCmd);
+			break;
+		}
 		case IO_NVM_HELLO:
 		{
 			xil_printf("Custom Hello Command\r\n");
@@ -179,5 +615,7 @@ void handle_nvme_io_cmd(NVME_COMMAND *nvmeCmd)
 			break;
 		}
 	}
+
+	CmdLatencyTraceHandled(nvmeCmd->cmdSlotTag);
 }
 
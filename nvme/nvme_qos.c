@@ -0,0 +1,465 @@
+//////////////////////////////////////////////////////////////////////////////////
+// nvme_qos.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: NVMe IO Submission Queue Arbiter
+// File Name: nvme_qos.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - stages IO commands per submission queue
+//   - selects the next IO command by round robin, or by deadline, urgent priority and weighted round robin
+//   - limits IOPS and bandwidth of each namespace with token buckets
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#include "xil_printf.h"
+#include "debug.h"
+#include "string.h"
+
+#include "nvme.h"
+#include "host_lld.h"
+#include "nvme_qos.h"
+#include "host_ipc.h"
+
+extern NVME_CONTEXT g_nvmeTask;
+
+IO_SQ_STAGE_ENTRY g_ioCmdStagePool[IO_CMD_STAGE_ENTRY_COUNT];
+IO_SQ_STAGE g_ioSqStage[MAX_NUM_OF_IO_SQ];
+IO_SQ_ARBITER g_ioSqArbiter;
+NAMESPACE_QOS g_namespaceQos[USER_NAMESPACES];
+
+static unsigned int get_qos_tick()
+{
+	XTime curTime;
+
+	XTime_GetTime(&curTime);
+
+	return (unsigned int)curTime;
+}
+
+void init_io_sq_arbiter()
+{
+	unsigned int ioSqIdx;
+
+	memset(g_ioSqStage, 0, sizeof(g_ioSqStage));
+	memset(&g_ioSqArbiter, 0, sizeof(g_ioSqArbiter));
+	memset(g_namespaceQos, 0, sizeof(g_namespaceQos));
+	reset_io_sq_stage();
+
+	for(ioSqIdx = 0; ioSqIdx < MAX_NUM_OF_IO_SQ; ioSqIdx++)
+		set_io_sq_priority(ioSqIdx, QPRIO_MEDIUM);
+
+	//AB = 1 command, HPW = MPW = LPW = 1 command
+	set_io_sq_arbitration(0x0);
+}
+
+void reset_io_sq_stage()
+{
+	unsigned int ioSqIdx;
+
+	//commands of a reset controller are not completed
+	for(ioSqIdx = 0; ioSqIdx < MAX_NUM_OF_IO_SQ; ioSqIdx++)
+	{
+		g_ioSqStage[ioSqIdx].head = IO_CMD_STAGE_NONE;
+		g_ioSqStage[ioSqIdx].tail = IO_CMD_STAGE_NONE;
+		g_ioSqStage[ioSqIdx].cnt = 0;
+	}
+
+	g_ioSqArbiter.stagedCnt = 0;
+}
+
+void set_io_sq_priority(unsigned int ioSqIdx, unsigned int qPrio)
+{
+	unsigned int deadlineUs;
+
+	ASSERT(ioSqIdx < MAX_NUM_OF_IO_SQ && qPrio < NUM_OF_QPRIO);
+
+	if(qPrio == QPRIO_URGENT)
+		deadlineUs = IO_SQ_DEADLINE_URGENT_US;
+	else if(qPrio == QPRIO_HIGH)
+		deadlineUs = IO_SQ_DEADLINE_HIGH_US;
+	else if(qPrio == QPRIO_MEDIUM)
+		deadlineUs = IO_SQ_DEADLINE_MEDIUM_US;
+	else
+		deadlineUs = IO_SQ_DEADLINE_LOW_US;
+
+	g_nvmeTask.ioSqInfo[ioSqIdx].qPrio = qPrio;
+	g_ioSqStage[ioSqIdx].deadlineTick = deadlineUs * QOS_TICKS_PER_US;
+	g_ioSqStage[ioSqIdx].deadlineMissCnt = 0;
+	g_ioSqStage[ioSqIdx].maxWaitTick = 0;
+}
+
+void abort_io_sq_stage(unsigned int ioSqIdx)
+{
+	IO_SQ_STAGE *stage;
+	NVME_COMPLETION nvmeCPL;
+
+	stage = &g_ioSqStage[ioSqIdx];
+
+	nvmeCPL.dword[0] = 0;
+	nvmeCPL.specific = 0x0;
+	nvmeCPL.statusField.SCT = SCT_GENERIC_COMMAND_STATUS;
+	nvmeCPL.statusField.SC = SC_COMMAND_ABORTED_DUE_TO_SQ_DELETION;
+
+	while(stage->cnt)
+	{
+		set_auto_nvme_cpl(g_ioCmdStagePool[stage->head].nvmeCmd.cmdSlotTag, nvmeCPL.specific, nvmeCPL.statusFieldWord);
+
+		stage->head = g_ioCmdStagePool[stage->head].nextEntry;
+		stage->cnt--;
+		g_ioSqArbiter.stagedCnt--;
+	}
+	stage->tail = IO_CMD_STAGE_NONE;
+}
+
+unsigned int set_io_sq_arbitration(unsigned int dword11)
+{
+	ADMIN_SET_FEATURES_ARBITRATION_DW11 arbitration;
+
+	arbitration.dword = dword11;
+
+	g_ioSqArbiter.arbitrationDword = arbitration.dword;
+	g_ioSqArbiter.burst = arbitration.AB;
+	g_ioSqArbiter.weight[QPRIO_URGENT] = 0;
+	g_ioSqArbiter.weight[QPRIO_HIGH] = arbitration.HPW + 1;		//zero-based -> non zero-based
+	g_ioSqArbiter.weight[QPRIO_MEDIUM] = arbitration.MPW + 1;
+	g_ioSqArbiter.weight[QPRIO_LOW] = arbitration.LPW + 1;
+
+	memcpy(g_ioSqArbiter.credit, g_ioSqArbiter.weight, sizeof(g_ioSqArbiter.credit));
+
+	xil_printf("Arbitration AB: %d, HPW: %d, MPW: %d, LPW: %d\r\n", arbitration.AB, arbitration.HPW, arbitration.MPW, arbitration.LPW);
+
+	return arbitration.dword;
+}
+
+unsigned int get_io_sq_arbitration()
+{
+	return g_ioSqArbiter.arbitrationDword;
+}
+
+static void refill_token_bucket(TOKEN_BUCKET *bucket, XTime curTime)
+{
+	unsigned long long newToken;
+	unsigned int depth;
+
+	if(bucket->rate == 0)
+		return;
+
+	newToken = ((curTime - bucket->lastRefillTime) * bucket->rate) / COUNTS_PER_SECOND;
+	if(newToken == 0)
+		return;
+
+	depth = (bucket->rate / 1000) * TOKEN_BUCKET_DEPTH_MS;
+	if(depth == 0)
+		depth = 1;
+
+	if((long long)bucket->token + (long long)newToken > (long long)depth)
+		bucket->token = depth;
+	else
+		bucket->token += (int)newToken;
+
+	bucket->lastRefillTime = curTime;
+}
+
+unsigned int set_namespace_rate_limit(unsigned int nsid, unsigned int iopsLimit, unsigned int mbpsLimit)
+{
+	NAMESPACE_QOS *nsQos;
+	XTime curTime;
+
+	if((nsid == 0) || (nsid > USER_NAMESPACES))
+		return 0;
+	//the bandwidth bucket counts NVMe blocks in 32 bits
+	if(mbpsLimit > (0xffffffff / NVME_BLOCKS_PER_MB))
+		return 0;
+
+	nsQos = &g_namespaceQos[nsid - 1];
+	XTime_GetTime(&curTime);
+
+	nsQos->iops.rate = iopsLimit;
+	nsQos->iops.token = 1;
+	nsQos->iops.lastRefillTime = curTime;
+
+	nsQos->bandwidth.rate = mbpsLimit * NVME_BLOCKS_PER_MB;
+	nsQos->bandwidth.token = 1;
+	nsQos->bandwidth.lastRefillTime = curTime;
+	nsQos->throttled = 0;
+
+	xil_printf("namespace %d limit: %d IOPS, %d MB/s\r\n", nsid, iopsLimit, mbpsLimit);
+
+	return 1;
+}
+
+static unsigned int is_namespace_throttled(NAMESPACE_QOS *nsQos)
+{
+	return (nsQos->iops.rate && (nsQos->iops.token <= 0)) || (nsQos->bandwidth.rate && (nsQos->bandwidth.token <= 0));
+}
+
+static NAMESPACE_QOS *get_namespace_qos(NVME_COMMAND *nvmeCmd)
+{
+	NVME_IO_COMMAND *nvmeIOCmd;
+
+	nvmeIOCmd = (NVME_IO_COMMAND*)nvmeCmd->cmdDword;
+
+	if((nvmeIOCmd->OPC != IO_NVM_READ) && (nvmeIOCmd->OPC != IO_NVM_WRITE))
+		return 0;
+	if((nvmeIOCmd->NSID == 0) || (nvmeIOCmd->NSID > USER_NAMESPACES))
+		return 0;
+
+	return &g_namespaceQos[nvmeIOCmd->NSID - 1];
+}
+
+static unsigned int is_io_sq_ready(unsigned int ioSqIdx)
+{
+	IO_SQ_STAGE *stage;
+	NAMESPACE_QOS *nsQos;
+
+	stage = &g_ioSqStage[ioSqIdx];
+	if(stage->cnt == 0)
+		return 0;
+
+	//the head command waits while the token bucket of its namespace is empty
+	nsQos = get_namespace_qos(&g_ioCmdStagePool[stage->head].nvmeCmd);
+	if(nsQos && is_namespace_throttled(nsQos))
+	{
+		//SQs are polled many times while the bucket stays empty, only the first one counts
+		if(!nsQos->throttled)
+		{
+			nsQos->throttled = 1;
+			nsQos->throttleCnt++;
+		}
+		return 0;
+	}
+
+	return 1;
+}
+
+static void pop_io_sq_stage(unsigned int ioSqIdx, NVME_COMMAND *nvmeCmd, unsigned int curTick)
+{
+	IO_SQ_STAGE *stage;
+	NAMESPACE_QOS *nsQos;
+	unsigned int waitTick;
+
+	stage = &g_ioSqStage[ioSqIdx];
+
+	*nvmeCmd = g_ioCmdStagePool[stage->head].nvmeCmd;
+	waitTick = curTick - g_ioCmdStagePool[stage->head].arrivalTick;
+
+	if(waitTick > stage->deadlineTick)
+		stage->deadlineMissCnt++;
+	if(waitTick > stage->maxWaitTick)
+		stage->maxWaitTick = waitTick;
+
+	nsQos = get_namespace_qos(nvmeCmd);
+	if(nsQos)
+	{
+		if(nsQos->iops.rate)
+			nsQos->iops.token--;
+		if(nsQos->bandwidth.rate)
+			nsQos->bandwidth.token -= (nvmeCmd->cmdDword[12] & 0xFFFF) + 1;
+	}
+
+	stage->head = g_ioCmdStagePool[stage->head].nextEntry;
+	if(stage->head == IO_CMD_STAGE_NONE)
+		stage->tail = IO_CMD_STAGE_NONE;
+	stage->cnt--;
+	g_ioSqArbiter.stagedCnt--;
+}
+
+void stage_nvme_io_cmd(NVME_COMMAND *nvmeCmd)
+{
+	IO_SQ_STAGE *stage;
+	unsigned int entryNo;
+
+	ASSERT(0 < nvmeCmd->qID && nvmeCmd->qID <= MAX_NUM_OF_IO_SQ);
+
+	//a command slot is held by one outstanding command at a time, so is its pool entry
+	stage = &g_ioSqStage[nvmeCmd->qID - 1];
+	entryNo = nvmeCmd->cmdSlotTag;
+
+	g_ioCmdStagePool[entryNo].nvmeCmd = *nvmeCmd;
+	g_ioCmdStagePool[entryNo].arrivalTick = get_qos_tick();
+	g_ioCmdStagePool[entryNo].nextEntry = IO_CMD_STAGE_NONE;
+
+	if(stage->tail != IO_CMD_STAGE_NONE)
+		g_ioCmdStagePool[stage->tail].nextEntry = entryNo;
+	else
+		stage->head = entryNo;
+	stage->tail = entryNo;
+	stage->cnt++;
+	g_ioSqArbiter.stagedCnt++;
+}
+
+void drain_io_sq_stage()
+{
+	NVME_COMMAND nvmeCmd;
+	unsigned int ioSqIdx, curTick;
+
+	//staged commands are handled regardless of arbitration and rate limits
+	curTick = get_qos_tick();
+	for(ioSqIdx = 0; ioSqIdx < MAX_NUM_OF_IO_SQ; ioSqIdx++)
+		while(g_ioSqStage[ioSqIdx].cnt)
+		{
+			pop_io_sq_stage(ioSqIdx, &nvmeCmd, curTick);
+			dispatch_nvme_io_cmd(&nvmeCmd);
+		}
+}
+
+static unsigned int find_overdue_io_sq(unsigned int curTick)
+{
+	IO_SQ_STAGE *stage;
+	unsigned int ioSqIdx, selectedSqIdx, waitTick, overdueTick, maxOverdueTick;
+
+	selectedSqIdx = MAX_NUM_OF_IO_SQ;
+	maxOverdueTick = 0;
+
+	for(ioSqIdx = 0; ioSqIdx < MAX_NUM_OF_IO_SQ; ioSqIdx++)
+	{
+		stage = &g_ioSqStage[ioSqIdx];
+		if(!is_io_sq_ready(ioSqIdx))
+			continue;
+
+		waitTick = curTick - g_ioCmdStagePool[stage->head].arrivalTick;
+		if(waitTick > stage->deadlineTick)
+		{
+			overdueTick = waitTick - stage->deadlineTick;
+			if(overdueTick >= maxOverdueTick)
+			{
+				maxOverdueTick = overdueTick;
+				selectedSqIdx = ioSqIdx;
+			}
+		}
+	}
+
+	return selectedSqIdx;
+}
+
+static unsigned int is_io_sq_in_class(unsigned int ioSqIdx, unsigned int qPrio)
+{
+	return (qPrio == QPRIO_ANY) || (g_nvmeTask.ioSqInfo[ioSqIdx].qPrio == qPrio);
+}
+
+static unsigned int find_next_io_sq(unsigned int qPrio)
+{
+	unsigned int ioSqIdx, cnt;
+
+	//keep serving the current SQ of this class until its arbitration burst is used up
+	ioSqIdx = g_ioSqArbiter.curSq[qPrio];
+	if(is_io_sq_in_class(ioSqIdx, qPrio) && is_io_sq_ready(ioSqIdx))
+		if((g_ioSqArbiter.burst == ARBITRATION_BURST_NO_LIMIT) || (g_ioSqArbiter.burstCnt[qPrio] < (1 << g_ioSqArbiter.burst)))
+		{
+			g_ioSqArbiter.burstCnt[qPrio]++;
+			return ioSqIdx;
+		}
+
+	for(cnt = 0; cnt < MAX_NUM_OF_IO_SQ; cnt++)
+	{
+		ioSqIdx = (ioSqIdx + 1) % MAX_NUM_OF_IO_SQ;
+
+		if(is_io_sq_in_class(ioSqIdx, qPrio) && is_io_sq_ready(ioSqIdx))
+		{
+			g_ioSqArbiter.curSq[qPrio] = ioSqIdx;
+			g_ioSqArbiter.burstCnt[qPrio] = 1;
+			return ioSqIdx;
+		}
+	}
+
+	return MAX_NUM_OF_IO_SQ;
+}
+
+static unsigned int find_wrr_io_sq(unsigned int curTick)
+{
+	unsigned int ioSqIdx, qPrio, round;
+
+	//a command waiting longer than the deadline of its SQ goes first
+	ioSqIdx = find_overdue_io_sq(curTick);
+
+	//urgent class is served with strict priority
+	if(ioSqIdx == MAX_NUM_OF_IO_SQ)
+		ioSqIdx = find_next_io_sq(QPRIO_URGENT);
+
+	//weighted round robin among high, medium and low classes
+	round = 0;
+	while((ioSqIdx == MAX_NUM_OF_IO_SQ) && (round < 2))
+	{
+		for(qPrio = QPRIO_HIGH; qPrio <= QPRIO_LOW; qPrio++)
+			if(g_ioSqArbiter.credit[qPrio])
+			{
+				ioSqIdx = find_next_io_sq(qPrio);
+				if(ioSqIdx != MAX_NUM_OF_IO_SQ)
+				{
+					g_ioSqArbiter.credit[qPrio]--;
+					break;
+				}
+			}
+
+		//every class with staged commands ran out of credits, start a new round
+		if(ioSqIdx == MAX_NUM_OF_IO_SQ)
+			memcpy(g_ioSqArbiter.credit, g_ioSqArbiter.weight, sizeof(g_ioSqArbiter.credit));
+
+		round++;
+	}
+
+	return ioSqIdx;
+}
+
+unsigned int select_nvme_io_cmd(NVME_COMMAND *nvmeCmd)
+{
+	unsigned int ioSqIdx, curTick, nsIdx;
+	XTime curTime;
+
+	if(g_ioSqArbiter.stagedCnt == 0)
+		return 0;
+
+	XTime_GetTime(&curTime);
+	curTick = (unsigned int)curTime;
+
+	for(nsIdx = 0; nsIdx < USER_NAMESPACES; nsIdx++)
+	{
+		refill_token_bucket(&g_namespaceQos[nsIdx].iops, curTime);
+		refill_token_bucket(&g_namespaceQos[nsIdx].bandwidth, curTime);
+		if(!is_namespace_throttled(&g_namespaceQos[nsIdx]))
+			g_namespaceQos[nsIdx].throttled = 0;
+	}
+
+	//round robin arbitration ignores deadlines and priority classes, only the arbitration burst applies
+	if(IO_SQ_ARBITRATION_MECHANISM == AMS_ROUND_ROBIN)
+		ioSqIdx = find_next_io_sq(QPRIO_ANY);
+	else
+		ioSqIdx = find_wrr_io_sq(curTick);
+
+	//every staged command belongs to a throttled namespace
+	if(ioSqIdx == MAX_NUM_OF_IO_SQ)
+		return 0;
+
+	pop_io_sq_stage(ioSqIdx, nvmeCmd, curTick);
+
+	return 1;
+}
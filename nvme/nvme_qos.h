@@ -0,0 +1,131 @@
+//////////////////////////////////////////////////////////////////////////////////
+// nvme_qos.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: NVMe IO Submission Queue Arbiter
+// File Name: nvme_qos.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - declares data structures and functions for arbitrating NVMe IO commands between submission queues
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __NVME_QOS_H_
+#define __NVME_QOS_H_
+
+#include "xtime_l.h"
+#include "../ftl_config.h"
+
+#define IO_CMD_STAGE_ENTRY_COUNT		(1 << P_SLOT_TAG_WIDTH)	//entries are indexed by command slot, staging never runs out of room
+#define IO_CMD_STAGE_NONE				0xffff
+#define IO_CMD_FETCH_BATCH				16
+
+#define NUM_OF_QPRIO					4
+#define QPRIO_ANY						NUM_OF_QPRIO	//round robin among all SQs regardless of their priority class
+
+//CC.AMS is not reported by the host IP, this follows the mechanism the host selects at CC.EN
+#define IO_SQ_ARBITRATION_MECHANISM		AMS_ROUND_ROBIN
+
+#define IO_SQ_DEADLINE_URGENT_US		200
+#define IO_SQ_DEADLINE_HIGH_US			1000
+#define IO_SQ_DEADLINE_MEDIUM_US		5000
+#define IO_SQ_DEADLINE_LOW_US			20000
+
+#define ARBITRATION_BURST_NO_LIMIT		0x7
+
+#define QOS_TICKS_PER_US				(COUNTS_PER_SECOND / 1000000)
+
+#define TOKEN_BUCKET_DEPTH_MS			100		//a bucket holds tokens of 100ms at most
+#define NVME_BLOCKS_PER_MB				((1024 * 1024) / BYTES_PER_NVME_BLOCK)
+
+typedef struct _IO_SQ_STAGE_ENTRY
+{
+	NVME_COMMAND nvmeCmd;
+	unsigned int arrivalTick;
+	unsigned int nextEntry;
+} IO_SQ_STAGE_ENTRY;
+
+//staged commands of an SQ are linked in order of arrival through the shared pool
+typedef struct _IO_SQ_STAGE
+{
+	unsigned short head;
+	unsigned short tail;
+	unsigned int cnt;
+	unsigned int deadlineTick;
+	unsigned int deadlineMissCnt;
+	unsigned int maxWaitTick;
+} IO_SQ_STAGE;
+
+typedef struct _IO_SQ_ARBITER
+{
+	unsigned char burst;					//arbitration burst (AB), 2^AB commands from one SQ per turn
+	unsigned short weight[NUM_OF_QPRIO];	//credits of a round per priority class (HPW, MPW, LPW + 1), urgent is strict priority
+	unsigned short credit[NUM_OF_QPRIO];
+	unsigned char curSq[NUM_OF_QPRIO + 1];	//round-robin position of each priority class and of QPRIO_ANY
+	unsigned char burstCnt[NUM_OF_QPRIO + 1];
+	unsigned int stagedCnt;
+	unsigned int arbitrationDword;
+} IO_SQ_ARBITER;
+
+typedef struct _TOKEN_BUCKET
+{
+	unsigned int rate;					//tokens per second, 0 means no limit
+	int token;							//may go negative, a command is admitted while the bucket is not empty
+	XTime lastRefillTime;
+} TOKEN_BUCKET;
+
+typedef struct _NAMESPACE_QOS
+{
+	TOKEN_BUCKET iops;					//a token is a command
+	TOKEN_BUCKET bandwidth;				//a token is an NVMe block
+	unsigned int throttled;				//a command waits on an empty bucket since the last refill
+	unsigned int throttleCnt;			//transitions into throttled
+} NAMESPACE_QOS;
+
+void init_io_sq_arbiter();
+void reset_io_sq_stage();
+void set_io_sq_priority(unsigned int ioSqIdx, unsigned int qPrio);
+void abort_io_sq_stage(unsigned int ioSqIdx);
+void drain_io_sq_stage();
+
+unsigned int set_io_sq_arbitration(unsigned int dword11);
+unsigned int get_io_sq_arbitration();
+
+unsigned int set_namespace_rate_limit(unsigned int nsid, unsigned int iopsLimit, unsigned int mbpsLimit);
+
+void stage_nvme_io_cmd(NVME_COMMAND *nvmeCmd);
+unsigned int select_nvme_io_cmd(NVME_COMMAND *nvmeCmd);
+
+extern IO_SQ_STAGE_ENTRY g_ioCmdStagePool[IO_CMD_STAGE_ENTRY_COUNT];
+extern IO_SQ_STAGE g_ioSqStage[MAX_NUM_OF_IO_SQ];
+extern IO_SQ_ARBITER g_ioSqArbiter;
+extern NAMESPACE_QOS g_namespaceQos[USER_NAMESPACES];
+
+#endif	//__NVME_QOS_H_
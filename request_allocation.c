@@ -45,6 +45,7 @@
 
 #include "xil_printf.h"
 #include <assert.h>
+#include "xpseudo_asm.h"
 #include "memory_map.h"
 
 P_REQ_POOL reqPoolPtr;
@@ -54,6 +55,7 @@ BLOCKED_BY_BUFFER_DEPENDENCY_REQUEST_QUEUE blockedByBufDepReqQ;
 BLOCKED_BY_ROW_ADDR_DEPENDENCY_REQUEST_QUEUE blockedByRowAddrDepReqQ[USER_CHANNELS][USER_WAYS];
 NVME_DMA_REQUEST_QUEUE nvmeDmaReqQ;
 NAND_REQUEST_QUEUE nandReqQ[USER_CHANNELS][USER_WAYS];
+FAILED_PROGRAM_REQUEST_QUEUE failedProgramReqQ;
 
 unsigned int notCompletedNandReqCnt;
 unsigned int blockedReqCnt;
@@ -64,12 +66,11 @@ void InitReqPool()
 
 	reqPoolPtr = (P_REQ_POOL) REQ_POOL_ADDR; //revise address
 
-	freeReqQ.headReq = 0;
-	freeReqQ.tailReq = AVAILABLE_OUNTSTANDING_REQ_COUNT - 1;
+	freeReqQ.head = 0;
+	freeReqQ.tail = 0;
 
-	sliceReqQ.headReq = REQ_SLOT_TAG_NONE;
-	sliceReqQ.tailReq = REQ_SLOT_TAG_NONE;
-	sliceReqQ.reqCnt = 0;
+	sliceReqQ.head = 0;
+	sliceReqQ.tail = 0;
 
 	blockedByBufDepReqQ.headReq = REQ_SLOT_TAG_NONE;
 	blockedByBufDepReqQ.tailReq = REQ_SLOT_TAG_NONE;
@@ -79,6 +80,10 @@ void InitReqPool()
 	nvmeDmaReqQ.tailReq = REQ_SLOT_TAG_NONE;
 	nvmeDmaReqQ.reqCnt = 0;
 
+	failedProgramReqQ.headReq = REQ_SLOT_TAG_NONE;
+	failedProgramReqQ.tailReq = REQ_SLOT_TAG_NONE;
+	failedProgramReqQ.reqCnt = 0;
+
 	for(chNo = 0; chNo<USER_CHANNELS; chNo++)
 		for(wayNo = 0; wayNo<USER_WAYS; wayNo++)
 		{
@@ -93,17 +98,13 @@ void InitReqPool()
 
 	for(reqSlotTag = 0; reqSlotTag < AVAILABLE_OUNTSTANDING_REQ_COUNT; reqSlotTag++)
 	{
-		reqPoolPtr->reqPool[reqSlotTag].reqQueueType =  REQ_QUEUE_TYPE_FREE;
 		reqPoolPtr->reqPool[reqSlotTag].prevBlockingReq = REQ_SLOT_TAG_NONE;
 		reqPoolPtr->reqPool[reqSlotTag].nextBlockingReq = REQ_SLOT_TAG_NONE;
-		reqPoolPtr->reqPool[reqSlotTag].prevReq = reqSlotTag - 1;
-		reqPoolPtr->reqPool[reqSlotTag].nextReq = reqSlotTag + 1;
+		reqPoolPtr->reqPool[reqSlotTag].prevReq = REQ_SLOT_TAG_NONE;
+		reqPoolPtr->reqPool[reqSlotTag].nextReq = REQ_SLOT_TAG_NONE;
+		PutToFreeReqQ(reqSlotTag);
 	}
 
-	reqPoolPtr->reqPool[0].prevReq = REQ_SLOT_TAG_NONE;
-	reqPoolPtr->reqPool[AVAILABLE_OUNTSTANDING_REQ_COUNT - 1].nextReq = REQ_SLOT_TAG_NONE;
-	freeReqQ.reqCnt = AVAILABLE_OUNTSTANDING_REQ_COUNT;
-
 	notCompletedNandReqCnt = 0;
 	blockedReqCnt = 0;
 }
@@ -111,97 +112,60 @@ void InitReqPool()
 
 void PutToFreeReqQ(unsigned int reqSlotTag)
 {
-	if(freeReqQ.tailReq != REQ_SLOT_TAG_NONE)
-	{
-		reqPoolPtr->reqPool[reqSlotTag].prevReq = freeReqQ.tailReq;
-		reqPoolPtr->reqPool[reqSlotTag].nextReq = REQ_SLOT_TAG_NONE;
-		reqPoolPtr->reqPool[freeReqQ.tailReq].nextReq = reqSlotTag;
-		freeReqQ.tailReq = reqSlotTag;
-	}
-	else
-	{
-		reqPoolPtr->reqPool[reqSlotTag].prevReq = REQ_SLOT_TAG_NONE;
-		reqPoolPtr->reqPool[reqSlotTag].nextReq = REQ_SLOT_TAG_NONE;
-		freeReqQ.headReq = reqSlotTag;
-		freeReqQ.tailReq = reqSlotTag;
-	}
+	unsigned int tail;
 
 	reqPoolPtr->reqPool[reqSlotTag].reqQueueType =  REQ_QUEUE_TYPE_FREE;
-	freeReqQ.reqCnt++;
+
+	//the ring holds every request of the pool, so it never overflows
+	tail = freeReqQ.tail;
+	freeReqQ.reqSlotTag[tail & (REQ_RING_ENTRY_COUNT - 1)] = reqSlotTag;
+	dmb();
+	freeReqQ.tail = tail + 1;
 }
 
 unsigned int GetFromFreeReqQ()
 {
-	unsigned int reqSlotTag;
-
-	reqSlotTag = freeReqQ.headReq;
+	unsigned int reqSlotTag, head;
 
-	if(reqSlotTag == REQ_SLOT_TAG_NONE)
-	{
+	head = freeReqQ.head;
+	if(head == freeReqQ.tail)
 		SyncAvailFreeReq();
-		reqSlotTag = freeReqQ.headReq;
-	}
 
-	if(reqPoolPtr->reqPool[reqSlotTag].nextReq != REQ_SLOT_TAG_NONE)
-	{
-		freeReqQ.headReq = reqPoolPtr->reqPool[reqSlotTag].nextReq;
-		reqPoolPtr->reqPool[reqPoolPtr->reqPool[reqSlotTag].nextReq].prevReq = REQ_SLOT_TAG_NONE;
-	}
-	else
-	{
-		freeReqQ.headReq = REQ_SLOT_TAG_NONE;
-		freeReqQ.tailReq = REQ_SLOT_TAG_NONE;
-	}
+	dmb();
+	reqSlotTag = freeReqQ.reqSlotTag[head & (REQ_RING_ENTRY_COUNT - 1)];
+	freeReqQ.head = head + 1;
 
 	reqPoolPtr->reqPool[reqSlotTag].reqQueueType =  REQ_QUEUE_TYPE_NONE;
-	freeReqQ.reqCnt--;
+	reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag = NVME_CMD_SLOT_TAG_NONE;
 
 	return reqSlotTag;
 }
 
 void PutToSliceReqQ(unsigned int reqSlotTag)
 {
-	if(sliceReqQ.tailReq != REQ_SLOT_TAG_NONE)
-	{
-		reqPoolPtr->reqPool[reqSlotTag].prevReq = sliceReqQ.tailReq;
-		reqPoolPtr->reqPool[reqSlotTag].nextReq = REQ_SLOT_TAG_NONE;
-		reqPoolPtr->reqPool[sliceReqQ.tailReq].nextReq = reqSlotTag;
-		sliceReqQ.tailReq = reqSlotTag;
-	}
-	else
-	{
-		reqPoolPtr->reqPool[reqSlotTag].prevReq = REQ_SLOT_TAG_NONE;
-		reqPoolPtr->reqPool[reqSlotTag].nextReq = REQ_SLOT_TAG_NONE;
-		sliceReqQ.headReq = reqSlotTag;
-		sliceReqQ.tailReq = reqSlotTag;
-	}
+	unsigned int tail;
 
 	reqPoolPtr->reqPool[reqSlotTag].reqQueueType =  REQ_QUEUE_TYPE_SLICE;
-	sliceReqQ.reqCnt++;
+
+	tail = sliceReqQ.tail;
+	sliceReqQ.reqSlotTag[tail & (REQ_RING_ENTRY_COUNT - 1)] = reqSlotTag;
+	dmb();
+	sliceReqQ.tail = tail + 1;
 }
 
 unsigned int GetFromSliceReqQ()
 {
-	unsigned int reqSlotTag;
-
-	reqSlotTag = sliceReqQ.headReq;
+	unsigned int reqSlotTag, head;
 
-	if(reqSlotTag == REQ_SLOT_TAG_NONE)
+	head = sliceReqQ.head;
+	if(head == sliceReqQ.tail)
 		return REQ_SLOT_TAG_FAIL;
 
-	if(reqPoolPtr->reqPool[reqSlotTag].nextReq != REQ_SLOT_TAG_NONE)
-	{
-		sliceReqQ.headReq = reqPoolPtr->reqPool[reqSlotTag].nextReq;
-		reqPoolPtr->reqPool[reqPoolPtr->reqPool[reqSlotTag].nextReq].prevReq = REQ_SLOT_TAG_NONE;
-	}
-	else
-	{
-		sliceReqQ.headReq = REQ_SLOT_TAG_NONE;
-		sliceReqQ.tailReq = REQ_SLOT_TAG_NONE;
-	}
+	dmb();
+	reqSlotTag = sliceReqQ.reqSlotTag[head & (REQ_RING_ENTRY_COUNT - 1)];
+	sliceReqQ.head = head + 1;
 
 	reqPoolPtr->reqPool[reqSlotTag].reqQueueType =  REQ_QUEUE_TYPE_NONE;
-	sliceReqQ.reqCnt--;
 
 	return reqSlotTag;
 }
@@ -224,6 +188,7 @@ void PutToBlockedByBufDepReqQ(unsigned int reqSlotTag)
 	}
 
 	reqPoolPtr->reqPool[reqSlotTag].reqQueueType =  REQ_QUEUE_TYPE_BLOCKED_BY_BUF_DEP;
+	CmdLatencyTraceWaitBegin(reqSlotTag);
 	blockedByBufDepReqQ.reqCnt++;
 	blockedReqCnt++;
 }
@@ -259,6 +224,7 @@ void SelectiveGetFromBlockedByBufDepReqQ(unsigned int reqSlotTag)
 	}
 
 	reqPoolPtr->reqPool[reqSlotTag].reqQueueType =  REQ_QUEUE_TYPE_NONE;
+	CmdLatencyTraceWaitEnd(reqSlotTag, CMD_LATENCY_WAIT_BUF_DEP);
 	blockedByBufDepReqQ.reqCnt--;
 	blockedReqCnt--;
 }
@@ -281,6 +247,8 @@ void PutToBlockedByRowAddrDepReqQ(unsigned int reqSlotTag, unsigned int chNo, un
 	}
 
 	reqPoolPtr->reqPool[reqSlotTag].reqQueueType =  REQ_QUEUE_TYPE_BLOCKED_BY_ROW_ADDR_DEP;
+	CmdLatencyTraceWaitBegin(reqSlotTag);
+	NandUtilRowAddrBlockedBegin(chNo, wayNo);
 	blockedByRowAddrDepReqQ[chNo][wayNo].reqCnt++;
 	blockedReqCnt++;
 }
@@ -316,7 +284,9 @@ void SelectiveGetFromBlockedByRowAddrDepReqQ(unsigned int reqSlotTag, unsigned i
 	}
 
 	reqPoolPtr->reqPool[reqSlotTag].reqQueueType = REQ_QUEUE_TYPE_NONE;
+	CmdLatencyTraceWaitEnd(reqSlotTag, CMD_LATENCY_WAIT_ROW_ADDR_DEP);
 	blockedByRowAddrDepReqQ[chNo][wayNo].reqCnt--;
+	NandUtilRowAddrBlockedEnd(chNo, wayNo);
 	blockedReqCnt--;
 }
 
@@ -376,6 +346,83 @@ void SelectiveGetFromNvmeDmaReqQ(unsigned int reqSlotTag)
 	ReleaseBlockedByBufDepReq(reqSlotTag);
 }
 
+unsigned int DetachFromNandReqQ(unsigned int chNo, unsigned int wayNo)
+{
+	unsigned int reqSlotTag;
+
+	//the head request leaves the queue without completion, it keeps its buffer dependency
+	reqSlotTag = nandReqQ[chNo][wayNo].headReq;
+	if(reqSlotTag == REQ_SLOT_TAG_NONE)
+		assert(!"[WARNING] there is no request in Nand-req-queue[WARNING]");
+
+	if(reqPoolPtr->reqPool[reqSlotTag].nextReq != REQ_SLOT_TAG_NONE)
+	{
+		nandReqQ[chNo][wayNo].headReq = reqPoolPtr->reqPool[reqSlotTag].nextReq;
+		reqPoolPtr->reqPool[reqPoolPtr->reqPool[reqSlotTag].nextReq].prevReq = REQ_SLOT_TAG_NONE;
+	}
+	else
+	{
+		nandReqQ[chNo][wayNo].headReq = REQ_SLOT_TAG_NONE;
+		nandReqQ[chNo][wayNo].tailReq = REQ_SLOT_TAG_NONE;
+	}
+
+	reqPoolPtr->reqPool[reqSlotTag].reqQueueType = REQ_QUEUE_TYPE_NONE;
+	NandUtilDieBusyEnd(chNo, wayNo, reqPoolPtr->reqPool[reqSlotTag].reqCode);
+	nandReqQ[chNo][wayNo].reqCnt--;
+	notCompletedNandReqCnt--;
+
+	return reqSlotTag;
+}
+
+void PutToFailedProgramReqQ(unsigned int reqSlotTag)
+{
+	if(failedProgramReqQ.tailReq != REQ_SLOT_TAG_NONE)
+	{
+		reqPoolPtr->reqPool[reqSlotTag].prevReq = failedProgramReqQ.tailReq;
+		reqPoolPtr->reqPool[reqSlotTag].nextReq = REQ_SLOT_TAG_NONE;
+		reqPoolPtr->reqPool[failedProgramReqQ.tailReq].nextReq = reqSlotTag;
+		failedProgramReqQ.tailReq = reqSlotTag;
+	}
+	else
+	{
+		reqPoolPtr->reqPool[reqSlotTag].prevReq = REQ_SLOT_TAG_NONE;
+		reqPoolPtr->reqPool[reqSlotTag].nextReq = REQ_SLOT_TAG_NONE;
+		failedProgramReqQ.headReq = reqSlotTag;
+		failedProgramReqQ.tailReq = reqSlotTag;
+	}
+
+	//the program is not completed until it is re-issued, sync loops keep running the scheduler
+	reqPoolPtr->reqPool[reqSlotTag].reqQueueType = REQ_QUEUE_TYPE_FAILED_PROGRAM;
+	failedProgramReqQ.reqCnt++;
+	notCompletedNandReqCnt++;
+}
+
+unsigned int GetFromFailedProgramReqQ()
+{
+	unsigned int reqSlotTag;
+
+	reqSlotTag = failedProgramReqQ.headReq;
+	if(reqSlotTag == REQ_SLOT_TAG_NONE)
+		assert(!"[WARNING] there is no request in failed-program-queue [WARNING]");
+
+	if(reqPoolPtr->reqPool[reqSlotTag].nextReq != REQ_SLOT_TAG_NONE)
+	{
+		failedProgramReqQ.headReq = reqPoolPtr->reqPool[reqSlotTag].nextReq;
+		reqPoolPtr->reqPool[reqPoolPtr->reqPool[reqSlotTag].nextReq].prevReq = REQ_SLOT_TAG_NONE;
+	}
+	else
+	{
+		failedProgramReqQ.headReq = REQ_SLOT_TAG_NONE;
+		failedProgramReqQ.tailReq = REQ_SLOT_TAG_NONE;
+	}
+
+	reqPoolPtr->reqPool[reqSlotTag].reqQueueType = REQ_QUEUE_TYPE_NONE;
+	failedProgramReqQ.reqCnt--;
+	notCompletedNandReqCnt--;
+
+	return reqSlotTag;
+}
+
 void PutToNandReqQ(unsigned int reqSlotTag, unsigned chNo, unsigned wayNo)
 {
 	if(nandReqQ[chNo][wayNo].tailReq != REQ_SLOT_TAG_NONE)
@@ -394,6 +441,7 @@ void PutToNandReqQ(unsigned int reqSlotTag, unsigned chNo, unsigned wayNo)
 	}
 
 	reqPoolPtr->reqPool[reqSlotTag].reqQueueType = REQ_QUEUE_TYPE_NAND;
+	CmdLatencyTraceWaitBegin(reqSlotTag);
 	nandReqQ[chNo][wayNo].reqCnt++;
 	notCompletedNandReqCnt++;
 }
@@ -418,6 +466,8 @@ void GetFromNandReqQ(unsigned int chNo, unsigned int wayNo, unsigned int reqStat
 	}
 
 	reqPoolPtr->reqPool[reqSlotTag].reqQueueType = REQ_QUEUE_TYPE_NONE;
+	CmdLatencyTraceWaitEnd(reqSlotTag, CMD_LATENCY_WAIT_NAND);
+	NandUtilDieBusyEnd(chNo, wayNo, reqCode);
 	nandReqQ[chNo][wayNo].reqCnt--;
 	notCompletedNandReqCnt--;
 
@@ -55,9 +55,12 @@
 #define REQ_SLOT_TAG_NONE		0xffff
 #define REQ_SLOT_TAG_FAIL		0xffff
 
+#define BYTES_PER_REQ_POOL_ENTRY	32
+
 typedef struct _REQ_POOL
 {
 	SSD_REQ_FORMAT reqPool[AVAILABLE_OUNTSTANDING_REQ_COUNT];
+	SSD_REQ_COLD_FORMAT reqColdPool[AVAILABLE_OUNTSTANDING_REQ_COUNT];
 } REQ_POOL, *P_REQ_POOL;
 
 void InitReqPool();
@@ -79,6 +82,10 @@ void SelectiveGetFromNvmeDmaReqQ(unsigned int regSlotTag);
 
 void PutToNandReqQ(unsigned int reqSlotTag, unsigned chNo, unsigned wayNo);
 void GetFromNandReqQ(unsigned int chNo, unsigned int wayNo, unsigned int reqStatus, unsigned int reqCode);
+unsigned int DetachFromNandReqQ(unsigned int chNo, unsigned int wayNo);
+
+void PutToFailedProgramReqQ(unsigned int reqSlotTag);
+unsigned int GetFromFailedProgramReqQ();
 
 extern P_REQ_POOL reqPoolPtr;
 extern FREE_REQUEST_QUEUE freeReqQ;
@@ -87,6 +94,7 @@ extern BLOCKED_BY_BUFFER_DEPENDENCY_REQUEST_QUEUE blockedByBufDepReqQ;
 extern BLOCKED_BY_ROW_ADDR_DEPENDENCY_REQUEST_QUEUE blockedByRowAddrDepReqQ[USER_CHANNELS][USER_WAYS];
 extern NVME_DMA_REQUEST_QUEUE nvmeDmaReqQ;
 extern NAND_REQUEST_QUEUE nandReqQ[USER_CHANNELS][USER_WAYS];
+extern FAILED_PROGRAM_REQUEST_QUEUE failedProgramReqQ;
 
 extern unsigned int notCompletedNandReqCnt;
 extern unsigned int blockedReqCnt;
@@ -59,10 +59,12 @@
 #define REQ_QUEUE_TYPE_BLOCKED_BY_ROW_ADDR_DEP		0x4
 #define REQ_QUEUE_TYPE_NVME_DMA						0x5
 #define REQ_QUEUE_TYPE_NAND							0x6
+#define REQ_QUEUE_TYPE_FAILED_PROGRAM				0x7
 
 #define REQ_CODE_WRITE				0x00
 #define REQ_CODE_READ				0x08
 #define REQ_CODE_READ_TRANSFER		0x09
+#define REQ_CODE_READ_RETRY			0x0A
 #define REQ_CODE_ERASE				0x0C
 #define REQ_CODE_RESET				0x0D
 #define REQ_CODE_SET_FEATURE		0x0E
@@ -98,8 +100,10 @@
 
 #define REQ_OPT_BLOCK_SPACE_MAIN	0
 #define REQ_OPT_BLOCK_SPACE_TOTAL 	1
+#define REQ_OPT_BLOCK_SPACE_PHY_IO	2	//block of physical address I/O, counted from the first block the FTL leaves to the host
 
 #define LOGICAL_SLICE_ADDR_NONE 	0xffffffff
+#define NVME_CMD_SLOT_TAG_NONE		0xffff
 
 typedef struct _DATA_BUF_INFO{
 	union {
@@ -110,11 +114,11 @@ typedef struct _DATA_BUF_INFO{
 
 
 typedef struct _NVME_DMA_INFO{
-	unsigned int startIndex : 16;
-	unsigned int nvmeBlockOffset : 16;
-	unsigned int numOfNvmeBlock : 16;
-	unsigned int reqTail	: 8;
-	unsigned int reserved0 : 8;
+	unsigned short startIndex;
+	unsigned short nvmeBlockOffset;
+	unsigned short numOfNvmeBlock;
+	unsigned char reqTail;
+	unsigned char reserved0;
 	unsigned int overFlowCnt;
 } NVME_DMA_INFO, *P_NVME_DMA_INFO;
 
@@ -123,52 +127,57 @@ typedef struct _NAND_INFO{
 	union {
 		unsigned int virtualSliceAddr;
 		struct {
-			unsigned int physicalCh : 4;
-			unsigned int physicalWay : 4;
-			unsigned int physicalBlock : 16;
-			unsigned int phyReserved0 : 8;
+			unsigned char physicalCh;
+			unsigned char physicalWay;
+			unsigned short physicalBlock;
 		};
 	};
 	union {
 		unsigned int programmedPageCnt;
 		struct {
-			unsigned int physicalPage : 16;
-			unsigned int phyReserved1 : 16;
+			unsigned short physicalPage;
+			unsigned short phyReserved1;
 		};
 	};
 } NAND_INFO, *P_NAND_INFO;
 
 
 typedef struct _REQ_OPTION{
-	unsigned int dataBufFormat : 2;
-	unsigned int nandAddr : 2;
-	unsigned int nandEcc : 1;
-	unsigned int nandEccWarning : 1;
-	unsigned int rowAddrDependencyCheck : 1;
-	unsigned int blockSpace : 1;
-	unsigned int reserved0 : 24;
+	unsigned char dataBufFormat;
+	unsigned char nandAddr;
+	unsigned char nandEcc;
+	unsigned char nandEccWarning;
+	unsigned char rowAddrDependencyCheck;
+	unsigned char blockSpace;
 } REQ_OPTION, *P_REQ_OPTION;
 
 
+// fields touched by the request scheduler, naturally aligned without bitfields, 32 bytes (a cache line) per request
 typedef struct _SSD_REQ_FORMAT
 {
-	unsigned int reqType : 4;
-	unsigned int reqQueueType : 4;
-	unsigned int reqCode : 8;
-	unsigned int nvmeCmdSlotTag : 16;
-
-	unsigned int logicalSliceAddr;
+	unsigned char reqType;
+	unsigned char reqQueueType;
+	unsigned char reqCode;
+	unsigned char reserved0;
 
 	REQ_OPTION reqOpt;
-	DATA_BUF_INFO dataBufInfo;
-	NVME_DMA_INFO nvmeDmaInfo;
-	NAND_INFO nandInfo;
+	unsigned short nvmeCmdSlotTag;
 
-	unsigned int prevReq : 16;
-	unsigned int nextReq : 16;
-	unsigned int prevBlockingReq : 16;
-	unsigned int nextBlockingReq : 16;
+	unsigned short prevReq;
+	unsigned short nextReq;
+	unsigned short prevBlockingReq;
+	unsigned short nextBlockingReq;
 
+	DATA_BUF_INFO dataBufInfo;
+	NAND_INFO nandInfo;
 } SSD_REQ_FORMAT, *P_SSD_REQ_FORMAT;
 
+// fields touched by request transform and host DMA only
+typedef struct _SSD_REQ_COLD_FORMAT
+{
+	unsigned int logicalSliceAddr;
+	NVME_DMA_INFO nvmeDmaInfo;
+	unsigned int traceTime;		//global timer when the request started waiting, see cmd_latency_trace.h
+} SSD_REQ_COLD_FORMAT, *P_SSD_REQ_COLD_FORMAT;
+
 #endif /* REQUEST_FORMAT_H_ */
@@ -46,20 +46,31 @@
 #define REQUEST_QUEUE_H_
 
 
+#include "ftl_config.h"
+
+#define REQ_RING_ENTRY_COUNT	((USER_DIES) * 128)		//holds every request of the pool, power of 2
+
+#define ReqRingCnt(ring) ((ring).tail - (ring).head)
+
+// FIFO-only queues are rings of request slot tags instead of lists threaded through the request pool.
+// head is written by the consumer and tail by the producer only, each in its own cache line,
+// so a producer and a consumer may run on different cores.
 typedef struct _FREE_REQUEST_QUEUE
 {
-	unsigned int headReq : 16;
-	unsigned int tailReq : 16;
-	unsigned int reqCnt : 16;
-	unsigned int reserved0 : 16;
+	volatile unsigned int head;
+	unsigned int reserved0[7];
+	volatile unsigned int tail;
+	unsigned int reserved1[7];
+	unsigned short reqSlotTag[REQ_RING_ENTRY_COUNT];
 } FREE_REQUEST_QUEUE, *P_FREE_REQUEST_QUEUE;
 
 typedef struct _SLICE_REQUEST_QUEUE
 {
-	unsigned int headReq : 16;
-	unsigned int tailReq : 16;
-	unsigned int reqCnt : 16;
-	unsigned int reserved0 : 16;
+	volatile unsigned int head;
+	unsigned int reserved0[7];
+	volatile unsigned int tail;
+	unsigned int reserved1[7];
+	unsigned short reqSlotTag[REQ_RING_ENTRY_COUNT];
 } SLICE_REQUEST_QUEUE, *P_SLICE_REQUEST_QUEUE;
 
 typedef struct _BLOCKED_BY_BUFFER_DEPENDENCY_REQUEST_QUEUE
@@ -94,5 +105,14 @@ typedef struct _NAND_REQUEST_QUEUE
 	unsigned int reserved0 : 16;
 } NAND_REQUEST_QUEUE, *P_NAND_REQUEST_QUEUE;
 
+//programs failed on a die, re-issued to another block once the scheduler has left its channel loops
+typedef struct _FAILED_PROGRAM_REQUEST_QUEUE
+{
+	unsigned int headReq : 16;
+	unsigned int tailReq : 16;
+	unsigned int reqCnt : 16;
+	unsigned int reserved0 : 16;
+} FAILED_PROGRAM_REQUEST_QUEUE, *P_FAILED_PROGRAM_REQUEST_QUEUE;
+
 
 #endif /* REQUEST_QUEUE_H_ */
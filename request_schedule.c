@@ -55,18 +55,25 @@ P_COMPLETE_FLAG_TABLE completeFlagTablePtr;
 P_STATUS_REPORT_TABLE statusReportTablePtr;
 P_ERROR_INFO_TABLE eccErrorInfoTablePtr;
 P_RETRY_LIMIT_TABLE retryLimitTablePtr;
+P_READ_RETRY_TABLE readRetryTablePtr;
+P_READ_RETRY_PAY_LOAD_TABLE readRetryPayLoadTablePtr;
+
+//read retry option of each level, the level walks away from the default read reference voltage step by step
+static const unsigned char readRetryOption[READ_RETRY_LEVELS] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
 
 P_DIE_STATE_TABLE dieStateTablePtr;
 P_WAY_PRIORITY_TABLE wayPriorityTablePtr;
 
 void InitReqScheduler()
 {
-	int chNo,wayNo;
+	int chNo,wayNo,dieNo,blockNo;
 
 	completeFlagTablePtr = (P_COMPLETE_FLAG_TABLE) COMPLETE_FLAG_TABLE_ADDR;
 	statusReportTablePtr = (P_STATUS_REPORT_TABLE) STATUS_REPORT_TABLE_ADDR;
 	eccErrorInfoTablePtr = (P_ERROR_INFO_TABLE) ERROR_INFO_TABLE_ADDR;
 	retryLimitTablePtr = (P_RETRY_LIMIT_TABLE) RETRY_LIMIT_TABLE_ADDR;
+	readRetryTablePtr = (P_READ_RETRY_TABLE) READ_RETRY_TABLE_ADDR;
+	readRetryPayLoadTablePtr = (P_READ_RETRY_PAY_LOAD_TABLE) READ_RETRY_PAY_LOAD_TABLE_ADDR;
 
 	dieStateTablePtr = (P_DIE_STATE_TABLE) DIE_STATE_TABLE_ADDR;
 	wayPriorityTablePtr = (P_WAY_PRIORITY_TABLE) WAY_PRIORITY_TABLE_ADDR;
@@ -102,6 +109,17 @@ void InitReqScheduler()
 		dieStateTablePtr->dieState[chNo][0].prevWay = WAY_NONE;
 		dieStateTablePtr->dieState[chNo][USER_WAYS-1].nextWay = WAY_NONE;
 	}
+
+	for(chNo=0; chNo<USER_CHANNELS; ++chNo)
+		for(wayNo=0; wayNo<USER_WAYS; ++wayNo)
+		{
+			readRetryTablePtr->dieLevel[chNo][wayNo] = READ_RETRY_LEVEL_DEFAULT;
+			readRetryPayLoadTablePtr->payload[chNo][wayNo] = 0;
+		}
+
+	for(dieNo=0; dieNo<USER_DIES; ++dieNo)
+		for(blockNo=0; blockNo<TOTAL_BLOCKS_PER_DIE; ++blockNo)
+			readRetryTablePtr->blockLevel[dieNo][blockNo] = READ_RETRY_LEVEL_DEFAULT;
 }
 
 
@@ -117,7 +135,7 @@ void SyncAllLowLevelReqDone()
 
 void SyncAvailFreeReq()
 {
-	while(freeReqQ.headReq == REQ_SLOT_TAG_NONE)
+	while(ReqRingCnt(freeReqQ) == 0)
 	{
 		CheckDoneNvmeDmaReq();
 		SchedulingNandReq();
@@ -139,11 +157,35 @@ void SchedulingNandReq()
 
 	for(chNo = 0; chNo < USER_CHANNELS; chNo++)
 		SchedulingNandReqPerCh(chNo);
+
+	if(failedProgramReqQ.headReq != REQ_SLOT_TAG_NONE)
+		HandleFailedProgramReq();
+}
+
+void HandleFailedProgramReq()
+{
+	unsigned int reqSlotTag, virtualSliceAddr;
+
+	//a request is taken off the queue before a new block is taken, which may run the scheduler and come back here
+	while(failedProgramReqQ.headReq != REQ_SLOT_TAG_NONE)
+	{
+		reqSlotTag = GetFromFailedProgramReqQ();
+		virtualSliceAddr = reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr;
+		RetireGrownBadBlock(Vsa2VdieTranslation(virtualSliceAddr), Vsa2VblockTranslation(virtualSliceAddr));
+
+		if(!ReissueFailedProgram(reqSlotTag))
+		{
+			PutToFreeReqQ(reqSlotTag);
+			ReleaseBlockedByBufDepReq(reqSlotTag);
+		}
+	}
 }
 
 void SchedulingNandReqPerCh(unsigned int chNo)
 {
-	unsigned int readyBusy, wayNo, reqStatus, nextWay, waitWayCnt;
+	unsigned int readyBusy, wayNo, reqStatus, nextWay, waitWayCnt, freeQueueCnt;
+
+	NandUtilSample(chNo);
 
 	waitWayCnt = 0;
 	if(wayPriorityTablePtr->wayPriority[chNo].idleHead != WAY_NONE)
@@ -223,7 +265,10 @@ void SchedulingNandReqPerCh(unsigned int chNo)
 		}
 	}
 	if(waitWayCnt != USER_WAYS)
-		if(!V2FIsControllerBusy(&chCtlReg[chNo]))
+	{
+		// issue as many commands as the NSC command queue can accept in this channel visit
+		freeQueueCnt = V2FGetFreeQueueCount(&chCtlReg[chNo]);
+		if(freeQueueCnt)
 		{
 			if(wayPriorityTablePtr->wayPriority[chNo].statusCheckHead != WAY_NONE)
 			{
@@ -232,6 +277,8 @@ void SchedulingNandReqPerCh(unsigned int chNo)
 
 				while(wayNo != WAY_NONE)
 				{
+					nextWay = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+
 					if(V2FWayReady(readyBusy, wayNo))
 					{
 						reqStatus = CheckReqStatus(chNo, wayNo);
@@ -239,11 +286,12 @@ void SchedulingNandReqPerCh(unsigned int chNo)
 						SelectiveGetFromNandStatusCheckList(chNo,wayNo);
 						PutToNandStatusReportList(chNo, wayNo);
 
-						if(V2FIsControllerBusy(&chCtlReg[chNo]))
+						freeQueueCnt--;
+						if(freeQueueCnt == 0)
 							return;
 					}
 
-					wayNo = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+					wayNo = nextWay;
 				}
 			}
 			if(wayPriorityTablePtr->wayPriority[chNo].readTriggerHead != WAY_NONE)
@@ -252,15 +300,18 @@ void SchedulingNandReqPerCh(unsigned int chNo)
 
 				while(wayNo != WAY_NONE)
 				{
+					nextWay = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+
 					ExecuteNandReq(chNo, wayNo, REQ_STATUS_RUNNING);
 
 					SelectiveGetFromNandReadTriggerList(chNo, wayNo);
 					PutToNandStatusCheckList(chNo, wayNo);
 
-					if(V2FIsControllerBusy(&chCtlReg[chNo]))
+					freeQueueCnt--;
+					if(freeQueueCnt == 0)
 						return;
 
-					wayNo = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+					wayNo = nextWay;
 				}
 			}
 
@@ -271,15 +322,18 @@ void SchedulingNandReqPerCh(unsigned int chNo)
 
 				while(wayNo != WAY_NONE)
 				{
+					nextWay = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+
 					ExecuteNandReq(chNo, wayNo, REQ_STATUS_RUNNING);
 
 					SelectiveGetFromNandEraseList(chNo, wayNo);
 					PutToNandStatusCheckList(chNo, wayNo);
 
-					if(V2FIsControllerBusy(&chCtlReg[chNo]))
+					freeQueueCnt--;
+					if(freeQueueCnt == 0)
 						return;
 
-					wayNo = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+					wayNo = nextWay;
 				}
 			}
 			if(wayPriorityTablePtr->wayPriority[chNo].writeHead != WAY_NONE)
@@ -288,15 +342,18 @@ void SchedulingNandReqPerCh(unsigned int chNo)
 
 				while(wayNo != WAY_NONE)
 				{
+					nextWay = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+
 					ExecuteNandReq(chNo, wayNo, REQ_STATUS_RUNNING);
 
 					SelectiveGetFromNandWriteList(chNo, wayNo);
 					PutToNandStatusCheckList(chNo, wayNo);
 
-					if(V2FIsControllerBusy(&chCtlReg[chNo]))
+					freeQueueCnt--;
+					if(freeQueueCnt == 0)
 						return;
 
-					wayNo = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+					wayNo = nextWay;
 				}
 			}
 			if(wayPriorityTablePtr->wayPriority[chNo].readTransferHead != WAY_NONE)
@@ -305,24 +362,27 @@ void SchedulingNandReqPerCh(unsigned int chNo)
 
 				while(wayNo != WAY_NONE)
 				{
+					nextWay = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+
 					ExecuteNandReq(chNo, wayNo, REQ_STATUS_RUNNING);
 
 					SelectiveGetFromNandReadTransferList(chNo, wayNo);
 					PutToNandStatusReportList(chNo, wayNo);
 
-					if(V2FIsControllerBusy(&chCtlReg[chNo]))
+					freeQueueCnt--;
+					if(freeQueueCnt == 0)
 						return;
 
-					wayNo = dieStateTablePtr->dieState[chNo][wayNo].nextWay;
+					wayNo = nextWay;
 				}
 			}
 		}
-
+	}
 }
 
 void PutToNandWayPriorityTable(unsigned int reqSlotTag, unsigned int chNo, unsigned int wayNo)
 {
-	if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ)
+	if((reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ) || (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_RETRY))
 		PutToNandReadTriggerList(chNo, wayNo);
 	else if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER)
 		PutToNandReadTransferList(chNo, wayNo);
@@ -641,7 +701,7 @@ void SelectiveGetFromNandStatusCheckList(unsigned int chNo, unsigned int wayNo)
 
 void IssueNandReq(unsigned int chNo, unsigned int wayNo)
 {
-	unsigned int reqSlotTag, rowAddr;
+	unsigned int reqSlotTag, rowAddr, readRetryLevel;
 	void* dataBufAddr;
 	void* spareDataBufAddr;
 	unsigned int* errorInfo;
@@ -652,12 +712,30 @@ void IssueNandReq(unsigned int chNo, unsigned int wayNo)
 	dataBufAddr = (void*)GenerateDataBufAddr(reqSlotTag);
 	spareDataBufAddr = (void*)GenerateSpareDataBufAddr(reqSlotTag);
 
+	if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ)
+	{
+		//the read reference voltage of the die is shifted ahead of the read trigger
+		readRetryLevel = GetReadRetryLevel(chNo, wayNo, reqSlotTag);
+		if(readRetryLevel != readRetryTablePtr->dieLevel[chNo][wayNo])
+			reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ_RETRY;
+	}
+
 	if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ)
 	{
 		dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt = REQ_STATUS_CHECK_OPT_CHECK;
 
 		V2FReadPageTriggerAsync(&chCtlReg[chNo], wayNo, rowAddr);
 	}
+	else if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_RETRY)
+	{
+		dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt = REQ_STATUS_CHECK_OPT_CHECK;
+
+		readRetryLevel = GetReadRetryLevel(chNo, wayNo, reqSlotTag);
+		readRetryTablePtr->dieLevel[chNo][wayNo] = readRetryLevel;
+		readRetryPayLoadTablePtr->payload[chNo][wayNo] = readRetryOption[readRetryLevel];
+
+		V2FSetFeaturesT(&chCtlReg[chNo], wayNo, READ_RETRY_FEATURE_ADDR, &readRetryPayLoadTablePtr->payload[chNo][wayNo]);
+	}
 	else if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER)
 	{
 		dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt = REQ_STATUS_CHECK_OPT_COMPLETION_FLAG;
@@ -665,6 +743,8 @@ void IssueNandReq(unsigned int chNo, unsigned int wayNo)
 		errorInfo = (unsigned int*)(&eccErrorInfoTablePtr->errorInfo[chNo][wayNo]);
 		completion = (unsigned int*)(&completeFlagTablePtr->completeFlag[chNo][wayNo]);
 
+		InvalidateNandReadDataBuf(reqSlotTag);
+
 		if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc == REQ_OPT_NAND_ECC_ON)
 			V2FReadPageTransferAsync(&chCtlReg[chNo], wayNo, dataBufAddr, spareDataBufAddr, errorInfo, completion, rowAddr);
 		else
@@ -674,6 +754,8 @@ void IssueNandReq(unsigned int chNo, unsigned int wayNo)
 	{
 		dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt = REQ_STATUS_CHECK_OPT_CHECK;
 
+		FlushDataBuf(dataBufAddr, BYTES_PER_DATA_REGION_OF_SLICE);
+		FlushDataBuf(spareDataBufAddr, BYTES_PER_SPARE_REGION_OF_SLICE);
 		V2FProgramPageAsync(&chCtlReg[chNo], wayNo, rowAddr, dataBufAddr, spareDataBufAddr);
 	}
 	else if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_ERASE)
@@ -686,6 +768,8 @@ void IssueNandReq(unsigned int chNo, unsigned int wayNo)
 	{
 		dieStateTablePtr->dieState[chNo][wayNo].reqStatusCheckOpt = REQ_STATUS_CHECK_OPT_NONE;
 
+		//reset restores the default read reference voltage
+		readRetryTablePtr->dieLevel[chNo][wayNo] = READ_RETRY_LEVEL_DEFAULT;
 		V2FResetSync(&chCtlReg[chNo], wayNo);
 	}
 	else if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_SET_FEATURE)
@@ -699,6 +783,20 @@ void IssueNandReq(unsigned int chNo, unsigned int wayNo)
 
 }
 
+#if (CACHED_DATA_BUFFER == 1)
+void InvalidateNandReadDataBuf(unsigned int reqSlotTag)
+{
+	//a raw read transfers the whole row to the data buffer address
+	if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc == REQ_OPT_NAND_ECC_ON)
+	{
+		InvalidateDataBuf(GenerateDataBufAddr(reqSlotTag), BYTES_PER_DATA_REGION_OF_SLICE);
+		InvalidateDataBuf(GenerateSpareDataBufAddr(reqSlotTag), BYTES_PER_SPARE_REGION_OF_SLICE);
+	}
+	else
+		InvalidateDataBuf(GenerateDataBufAddr(reqSlotTag), BYTES_PER_NAND_ROW);
+}
+#endif
+
 unsigned int GenerateNandRowAddr(unsigned int reqSlotTag)
 {
 	unsigned int rowAddr, lun, virtualBlockNo, tempBlockNo, phyBlockNo, tempPageNo, dieNo;
@@ -734,6 +832,16 @@ unsigned int GenerateNandRowAddr(unsigned int reqSlotTag)
 			tempBlockNo = phyBlockMapPtr->phyBlock[dieNo][tempBlockNo].remappedPhyBlock % TOTAL_BLOCKS_PER_LUN;
 			tempPageNo = reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalPage;
 		}
+		else if(PHY_IO_BLOCKS_PER_DIE && (reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace == REQ_OPT_BLOCK_SPACE_PHY_IO))
+		{
+			//blocks of physical address I/O follow the blocks of the FTL and are remapped the same way, the page is already an LSB page
+			phyBlockNo = Vblock2PblockOfTbsTranslation(FTL_BLOCKS_PER_DIE + reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalBlock);
+			lun =  phyBlockNo / TOTAL_BLOCKS_PER_LUN;
+			tempBlockNo = phyBlockMapPtr->phyBlock[dieNo][phyBlockNo].remappedPhyBlock % TOTAL_BLOCKS_PER_LUN;
+			tempPageNo = reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalPage;
+		}
+		else
+			assert(!"[WARNING] wrong block space option [WARNING]");
 	}
 	else
 		assert(!"[WARNING] wrong nand addr option [WARNING]");
@@ -762,7 +870,7 @@ unsigned int GenerateDataBufAddr(unsigned int reqSlotTag)
 	else if(reqPoolPtr->reqPool[reqSlotTag].reqType == REQ_TYPE_NVME_DMA)
 	{
 		if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat == REQ_OPT_DATA_BUF_ENTRY)
-			return (DATA_BUFFER_BASE_ADDR + reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry * BYTES_PER_DATA_REGION_OF_SLICE + reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset * BYTES_PER_NVME_BLOCK);
+			return (DATA_BUFFER_BASE_ADDR + reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry * BYTES_PER_DATA_REGION_OF_SLICE + reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset * BYTES_PER_NVME_BLOCK);
 		else
 			assert(!"[WARNING] wrong reqOpt-dataBufFormat [WARNING]");
 	}
@@ -883,6 +991,21 @@ unsigned int CheckEccErrorInfo(unsigned int chNo, unsigned int wayNo)
 	return ERROR_INFO_FAIL;
 }
 
+unsigned int GetReadRetryLevel(unsigned int chNo, unsigned int wayNo, unsigned int reqSlotTag)
+{
+	unsigned int rowAddr, phyBlockNo;
+
+	//raw reads of the bad block detection process always use the default voltage
+	if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc == REQ_OPT_NAND_ECC_OFF)
+		return READ_RETRY_LEVEL_DEFAULT;
+
+	//a read starts at the last successful level of the block and moves to the next level on every retry
+	rowAddr = GenerateNandRowAddr(reqSlotTag);
+	phyBlockNo = ((rowAddr % LUN_1_BASE_ADDR) / PAGES_PER_MLC_BLOCK) + ((rowAddr / LUN_1_BASE_ADDR)* TOTAL_BLOCKS_PER_LUN);
+
+	return (readRetryTablePtr->blockLevel[Pcw2VdieTranslation(chNo, wayNo)][phyBlockNo] + RETRY_LIMIT - retryLimitTablePtr->retryLimit[chNo][wayNo]) % READ_RETRY_LEVELS;
+}
+
 void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatus)
 {
 	unsigned int reqSlotTag, rowAddr, phyBlockNo;
@@ -893,7 +1016,10 @@ void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatu
 	switch(dieStateTablePtr->dieState[chNo][wayNo].dieState)
 	{
 		case DIE_STATE_IDLE:
+			HotPathProfileBegin(HOT_PATH_PROFILE_STAGE_NAND_ISSUE);
+			NandUtilDieBusyBegin(chNo, wayNo);
 			IssueNandReq(chNo, wayNo);
+			HotPathProfileEnd(HOT_PATH_PROFILE_STAGE_NAND_ISSUE);
 			dieStateTablePtr->dieState[chNo][wayNo].dieState = DIE_STATE_EXE;
 			break;
 		case DIE_STATE_EXE:
@@ -901,8 +1027,35 @@ void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatu
 			{
 				if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ)
 					reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ_TRANSFER;
+				else if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_RETRY)
+					reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
 				else
 				{
+					//lines the CPU fetched while the NSC was writing the buffer are dropped
+					if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER)
+						InvalidateNandReadDataBuf(reqSlotTag);
+
+					if((reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER) && (reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc == REQ_OPT_NAND_ECC_ON))
+					{
+						//the next read of this block starts at the level that succeeded
+						rowAddr = GenerateNandRowAddr(reqSlotTag);
+						phyBlockNo = ((rowAddr % LUN_1_BASE_ADDR) / PAGES_PER_MLC_BLOCK) + ((rowAddr / LUN_1_BASE_ADDR)* TOTAL_BLOCKS_PER_LUN);
+						readRetryTablePtr->blockLevel[Pcw2VdieTranslation(chNo, wayNo)][phyBlockNo] = readRetryTablePtr->dieLevel[chNo][wayNo];
+
+						if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr == REQ_OPT_NAND_ADDR_VSA)
+							UpdateBlockReadHealth(Vsa2VdieTranslation(reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr), Vsa2VblockTranslation(reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr),
+									V2FWorstChunkErrorCount(&eccErrorInfoTablePtr->errorInfo[chNo][wayNo][0]), RETRY_LIMIT - retryLimitTablePtr->retryLimit[chNo][wayNo]);
+					}
+					else if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_ERASE)
+					{
+						//an erased block is read at the default voltage again
+						rowAddr = GenerateNandRowAddr(reqSlotTag);
+						phyBlockNo = ((rowAddr % LUN_1_BASE_ADDR) / PAGES_PER_MLC_BLOCK) + ((rowAddr / LUN_1_BASE_ADDR)* TOTAL_BLOCKS_PER_LUN);
+						readRetryTablePtr->blockLevel[Pcw2VdieTranslation(chNo, wayNo)][phyBlockNo] = READ_RETRY_LEVEL_DEFAULT;
+					}
+					else if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_WRITE)
+						ftlStatistics.nandWriteSliceCnt++;
+
 					retryLimitTablePtr->retryLimit[chNo][wayNo] = RETRY_LIMIT;
 					GetFromNandReqQ(chNo, wayNo, reqStatus, reqPoolPtr->reqPool[reqSlotTag].reqCode);
 				}
@@ -911,18 +1064,22 @@ void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatu
 			}
 			else if(reqStatus == REQ_STATUS_FAIL)
 			{
-				if((reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ) || (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER))
+				if((reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ) || (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER) || (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_RETRY))
 					if(retryLimitTablePtr->retryLimit[chNo][wayNo] > 0)
 					{
+						//the retry is issued at the next read retry level
 						retryLimitTablePtr->retryLimit[chNo][wayNo]--;
-
-						if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER)
-							reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
+						reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
+						ftlStatistics.readRetryCnt++;
 
 						dieStateTablePtr->dieState[chNo][wayNo].dieState = DIE_STATE_IDLE;
 						return;
 					}
 
+				//a read failing ECC at every read retry level is a media error
+				if(((reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ) || (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER) || (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_RETRY)) && (reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc == REQ_OPT_NAND_ECC_ON))
+					ftlStatistics.mediaErrorCnt++;
+
 				if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ)
 					xil_printf("Read Trigger FAIL on      ");
 				else if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_READ_TRANSFER)
@@ -943,11 +1100,25 @@ void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatu
 						*badCheck = PSEUDO_BAD_BLOCK_MARK;
 					}
 
-				//grown bad block information update
-				phyBlockNo = ((rowAddr % LUN_1_BASE_ADDR) / PAGES_PER_MLC_BLOCK) + ((rowAddr / LUN_1_BASE_ADDR)* TOTAL_BLOCKS_PER_LUN);
-				UpdatePhyBlockMapForGrownBadBlock(Pcw2VdieTranslation(chNo, wayNo), phyBlockNo);
+				//grown bad block information update, blocks of physical address I/O are managed by the host
+				if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace != REQ_OPT_BLOCK_SPACE_PHY_IO)
+				{
+					phyBlockNo = ((rowAddr % LUN_1_BASE_ADDR) / PAGES_PER_MLC_BLOCK) + ((rowAddr / LUN_1_BASE_ADDR)* TOTAL_BLOCKS_PER_LUN);
+					UpdatePhyBlockMapForGrownBadBlock(Pcw2VdieTranslation(chNo, wayNo), phyBlockNo);
+				}
 
 				retryLimitTablePtr->retryLimit[chNo][wayNo] = RETRY_LIMIT;
+
+				//user data of a failed program is programmed again to another block and the failing block is retired
+				//taking a new block may erase or collect garbage, so it is left to HandleFailedProgramReq outside of the channel loops
+				if((reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_WRITE) && (reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr == REQ_OPT_NAND_ADDR_VSA))
+				{
+					DetachFromNandReqQ(chNo, wayNo);
+					PutToFailedProgramReqQ(reqSlotTag);
+					dieStateTablePtr->dieState[chNo][wayNo].dieState = DIE_STATE_IDLE;
+					return;
+				}
+
 				GetFromNandReqQ(chNo, wayNo, reqStatus, reqPoolPtr->reqPool[reqSlotTag].reqCode);
 				dieStateTablePtr->dieState[chNo][wayNo].dieState = DIE_STATE_IDLE;
 			}
@@ -956,9 +1127,16 @@ void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatu
 				rowAddr = GenerateNandRowAddr(reqSlotTag);
 				xil_printf("ECC Uncorrectable Soon on ch %x way %x rowAddr %x / completion %x statusReport %x \r\n", chNo, wayNo, rowAddr, completeFlagTablePtr->completeFlag[chNo][wayNo],statusReportTablePtr->statusReport[chNo][wayNo]);
 
-				//grown bad block information update
-				phyBlockNo = ((rowAddr % LUN_1_BASE_ADDR) / PAGES_PER_MLC_BLOCK) + ((rowAddr / LUN_1_BASE_ADDR)* TOTAL_BLOCKS_PER_LUN);
-				UpdatePhyBlockMapForGrownBadBlock(Pcw2VdieTranslation(chNo, wayNo), phyBlockNo);
+				//the data was still corrected, the block is refreshed and reused instead of being retired
+				if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr == REQ_OPT_NAND_ADDR_VSA)
+					UpdateBlockReadHealth(Vsa2VdieTranslation(reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr), Vsa2VblockTranslation(reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr),
+							V2FWorstChunkErrorCount(&eccErrorInfoTablePtr->errorInfo[chNo][wayNo][0]), RETRY_LIMIT - retryLimitTablePtr->retryLimit[chNo][wayNo]);
+				else if(reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace != REQ_OPT_BLOCK_SPACE_PHY_IO)
+				{
+					//grown bad block information update
+					phyBlockNo = ((rowAddr % LUN_1_BASE_ADDR) / PAGES_PER_MLC_BLOCK) + ((rowAddr / LUN_1_BASE_ADDR)* TOTAL_BLOCKS_PER_LUN);
+					UpdatePhyBlockMapForGrownBadBlock(Pcw2VdieTranslation(chNo, wayNo), phyBlockNo);
+				}
 
 				retryLimitTablePtr->retryLimit[chNo][wayNo] = RETRY_LIMIT;
 				GetFromNandReqQ(chNo, wayNo, reqStatus, reqPoolPtr->reqPool[reqSlotTag].reqCode);
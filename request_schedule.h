@@ -57,7 +57,11 @@
 
 #define PSEUDO_BAD_BLOCK_MARK	0
 
-#define RETRY_LIMIT				5	//retry the failed request to the extent that the limit number allows
+#define READ_RETRY_LEVELS			8		//entries of the read reference voltage table
+#define READ_RETRY_LEVEL_DEFAULT	0
+#define READ_RETRY_FEATURE_ADDR		0x89	//feature address of the read retry option
+
+#define RETRY_LIMIT				(READ_RETRY_LEVELS - 1)	//retry the failed request to the extent that the limit number allows, a read walks the whole voltage table once
 
 #define DIE_STATE_IDLE			0
 #define DIE_STATE_EXE			1
@@ -93,6 +97,15 @@ typedef struct _RETRY_LIMIT_TABLE {
 	int retryLimit[USER_CHANNELS][USER_WAYS];
 } RETRY_LIMIT_TABLE, *P_RETRY_LIMIT_TABLE;
 
+typedef struct _READ_RETRY_TABLE {
+	unsigned char dieLevel[USER_CHANNELS][USER_WAYS];				//read retry level currently set on each die
+	unsigned char blockLevel[USER_DIES][TOTAL_BLOCKS_PER_DIE];	//level of the last successful read of each physical block
+} READ_RETRY_TABLE, *P_READ_RETRY_TABLE;
+
+typedef struct _READ_RETRY_PAY_LOAD_TABLE {
+	unsigned int payload[USER_CHANNELS][USER_WAYS];
+} READ_RETRY_PAY_LOAD_TABLE, *P_READ_RETRY_PAY_LOAD_TABLE;
+
 typedef struct _DIE_STATE_ENTRY {
 	unsigned int dieState	:	8;
 	unsigned int reqStatusCheckOpt	:	4;
@@ -135,6 +148,7 @@ void SyncAllLowLevelReqDone();
 void SyncAvailFreeReq();
 void SyncReleaseEraseReq(unsigned int chNo, unsigned int wayNo, unsigned int blockNo);
 void SchedulingNandReq();
+void HandleFailedProgramReq();
 void SchedulingNandReqPerCh(unsigned int chNo);
 
 void PutToNandWayPriorityTable(unsigned int reqSlotTag, unsigned int chNo, unsigned int wayNo);
@@ -159,6 +173,12 @@ unsigned int GenerateDataBufAddr(unsigned int reqSlotTag);
 unsigned int GenerateSpareDataBufAddr(unsigned int reqSlotTag);
 unsigned int CheckReqStatus(unsigned int chNo, unsigned int wayNo);
 unsigned int CheckEccErrorInfo(unsigned int chNo, unsigned int wayNo);
+unsigned int GetReadRetryLevel(unsigned int chNo, unsigned int wayNo, unsigned int reqSlotTag);
+#if (CACHED_DATA_BUFFER == 1)
+void InvalidateNandReadDataBuf(unsigned int reqSlotTag);
+#else
+#define InvalidateNandReadDataBuf(reqSlotTag)	do { } while(0)
+#endif
 
 void ExecuteNandReq(unsigned int chNo, unsigned int wayNo, unsigned int reqStatus);
 
@@ -167,7 +187,9 @@ extern P_COMPLETE_FLAG_TABLE completeFlagTablePtr;
 extern P_STATUS_REPORT_TABLE statusReportTablePtr;
 extern P_ERROR_INFO_TABLE eccErrorInfoTablePtr;
 extern P_RETRY_LIMIT_TABLE retryLimitTablePtr;
-extern P_DIE_STATE_TABLE dieStatusTablePtr;
+extern P_READ_RETRY_TABLE readRetryTablePtr;
+extern P_READ_RETRY_PAY_LOAD_TABLE readRetryPayLoadTablePtr;
+extern P_DIE_STATE_TABLE dieStateTablePtr;
 extern P_WAY_PRIORITY_TABLE wayPriorityTablePtr;
 
 
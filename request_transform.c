@@ -49,36 +49,29 @@
 
 #include "xil_printf.h"
 #include <assert.h>
+#include <string.h>
 #include "nvme/nvme.h"
 #include "nvme/host_lld.h"
 #include "memory_map.h"
 #include "ftl_config.h"
 
 P_ROW_ADDR_DEPENDENCY_TABLE rowAddrDependencyTablePtr;
+DEFERRED_NVME_CPL_TABLE deferredNvmeCplTable;
 
 void InitDependencyTable()
 {
-	unsigned int blockNo, wayNo, chNo;
 	rowAddrDependencyTablePtr = (P_ROW_ADDR_DEPENDENCY_TABLE)ROW_ADDR_DEPENDENCY_TABLE_ADDR;
 
-	for(blockNo=0 ; blockNo<MAIN_BLOCKS_PER_DIE ; blockNo++)
-	{
-		for(wayNo=0 ; wayNo<USER_WAYS ; wayNo++)
-		{
-			for(chNo=0 ; chNo<USER_CHANNELS ; chNo++)
-			{
-				rowAddrDependencyTablePtr->block[chNo][wayNo][blockNo].permittedProgPage = 0;
-				rowAddrDependencyTablePtr->block[chNo][wayNo][blockNo].blockedReadReqCnt = 0;
-				rowAddrDependencyTablePtr->block[chNo][wayNo][blockNo].blockedEraseReqFlag = 0;
-			}
-		}
-	}
+	//every field of an entry starts at 0, the table is filled in address order
+	memset(rowAddrDependencyTablePtr, 0, sizeof(ROW_ADDR_DEPENDENCY_TABLE));
 }
 
 void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigned int nlb, unsigned int cmdCode)
 {
 	unsigned int reqSlotTag, requestedNvmeBlock, tempNumOfNvmeBlock, transCounter, tempLsa, loop, nvmeBlockOffset, nvmeDmaStartIndex, reqCode;
 
+	HotPathProfileBegin(HOT_PATH_PROFILE_STAGE_REQ_TRANS);
+
 	requestedNvmeBlock = nlb + 1;
 	transCounter = 0;
 	nvmeDmaStartIndex = 0;
@@ -86,12 +79,23 @@ void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigne
 	loop = ((startLba % NVME_BLOCKS_PER_SLICE) + requestedNvmeBlock) / NVME_BLOCKS_PER_SLICE;
 
 	if(cmdCode == IO_NVM_WRITE)
+	{
 		reqCode = REQ_CODE_WRITE;
+		ftlStatistics.hostWriteCmdCnt++;
+		ftlStatistics.hostWriteNvmeBlockCnt += requestedNvmeBlock;
+	}
 	else if(cmdCode == IO_NVM_READ)
+	{
 		reqCode = REQ_CODE_READ;
+		ftlStatistics.hostReadCmdCnt++;
+		ftlStatistics.hostReadNvmeBlockCnt += requestedNvmeBlock;
+	}
 	else
 		assert(!"[WARNING] Not supported command code [WARNING]");
 
+	//the command is traced until DMAs of all its blocks are done
+	CmdLatencyTraceAddNvmeBlock(cmdSlotTag, requestedNvmeBlock);
+
 	//first transform
 	nvmeBlockOffset = (startLba % NVME_BLOCKS_PER_SLICE);
 	if(loop)
@@ -104,10 +108,10 @@ void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigne
 	reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_SLICE;
 	reqPoolPtr->reqPool[reqSlotTag].reqCode = reqCode;
 	reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag = cmdSlotTag;
-	reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = tempLsa;
-	reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.startIndex = nvmeDmaStartIndex;
-	reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset = nvmeBlockOffset;
-	reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock = tempNumOfNvmeBlock;
+	reqPoolPtr->reqColdPool[reqSlotTag].logicalSliceAddr = tempLsa;
+	reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.startIndex = nvmeDmaStartIndex;
+	reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset = nvmeBlockOffset;
+	reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock = tempNumOfNvmeBlock;
 
 	PutToSliceReqQ(reqSlotTag);
 
@@ -126,10 +130,10 @@ void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigne
 		reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_SLICE;
 		reqPoolPtr->reqPool[reqSlotTag].reqCode = reqCode;
 		reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag = cmdSlotTag;
-		reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = tempLsa;
-		reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.startIndex = nvmeDmaStartIndex;
-		reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset = nvmeBlockOffset;
-		reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock = tempNumOfNvmeBlock;
+		reqPoolPtr->reqColdPool[reqSlotTag].logicalSliceAddr = tempLsa;
+		reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.startIndex = nvmeDmaStartIndex;
+		reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset = nvmeBlockOffset;
+		reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock = tempNumOfNvmeBlock;
 
 		PutToSliceReqQ(reqSlotTag);
 
@@ -142,37 +146,48 @@ void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigne
 	nvmeBlockOffset = 0;
 	tempNumOfNvmeBlock = (startLba + requestedNvmeBlock) % NVME_BLOCKS_PER_SLICE;
 	if((tempNumOfNvmeBlock == 0) || (loop == 0))
+	{
+		HotPathProfileEnd(HOT_PATH_PROFILE_STAGE_REQ_TRANS);
 		return ;
+	}
 
 	reqSlotTag = GetFromFreeReqQ();
 
 	reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_SLICE;
 	reqPoolPtr->reqPool[reqSlotTag].reqCode = reqCode;
 	reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag = cmdSlotTag;
-	reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = tempLsa;
-	reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.startIndex = nvmeDmaStartIndex;
-	reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset = nvmeBlockOffset;
-	reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock = tempNumOfNvmeBlock;
+	reqPoolPtr->reqColdPool[reqSlotTag].logicalSliceAddr = tempLsa;
+	reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.startIndex = nvmeDmaStartIndex;
+	reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.nvmeBlockOffset = nvmeBlockOffset;
+	reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock = tempNumOfNvmeBlock;
 
 	PutToSliceReqQ(reqSlotTag);
+
+	HotPathProfileEnd(HOT_PATH_PROFILE_STAGE_REQ_TRANS);
 }
 
 
 
 void EvictDataBufEntry(unsigned int originReqSlotTag)
 {
-	unsigned int reqSlotTag, virtualSliceAddr, dataBufEntry;
+	FlushDataBufEntry(reqPoolPtr->reqPool[originReqSlotTag].dataBufInfo.entry, reqPoolPtr->reqPool[originReqSlotTag].nvmeCmdSlotTag);
+}
+
+void FlushDataBufEntry(unsigned int dataBufEntry, unsigned int nvmeCmdSlotTag)
+{
+	unsigned int reqSlotTag, virtualSliceAddr;
 
-	dataBufEntry = reqPoolPtr->reqPool[originReqSlotTag].dataBufInfo.entry;
 	if(dataBufMapPtr->dataBuf[dataBufEntry].dirty == DATA_BUF_DIRTY)
 	{
 		reqSlotTag = GetFromFreeReqQ();
+		HotPathProfileBegin(HOT_PATH_PROFILE_STAGE_ADDR_TRANS_WRITE);
 		virtualSliceAddr =  AddrTransWrite(dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr);
+		HotPathProfileEnd(HOT_PATH_PROFILE_STAGE_ADDR_TRANS_WRITE);
 
 		reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
 		reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_WRITE;
-		reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag = reqPoolPtr->reqPool[originReqSlotTag].nvmeCmdSlotTag;
-		reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr;
+		reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag = nvmeCmdSlotTag;
+		reqPoolPtr->reqColdPool[reqSlotTag].logicalSliceAddr = dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr;
 		reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_ENTRY;
 		reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
 		reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
@@ -191,18 +206,27 @@ void EvictDataBufEntry(unsigned int originReqSlotTag)
 
 void DataReadFromNand(unsigned int originReqSlotTag)
 {
-	unsigned int reqSlotTag, virtualSliceAddr;
+	unsigned int reqSlotTag, virtualSliceAddr, dataBufEntry;
 
-	virtualSliceAddr =  AddrTransRead(reqPoolPtr->reqPool[originReqSlotTag].logicalSliceAddr);
+	virtualSliceAddr =  AddrTransRead(reqPoolPtr->reqColdPool[originReqSlotTag].logicalSliceAddr);
+
+	if(virtualSliceAddr == VSA_ZERO)
+	{
+		//a zeroed slice is filled by the CPU once the entry is no longer used by an eviction
+		dataBufEntry = reqPoolPtr->reqPool[originReqSlotTag].dataBufInfo.entry;
+		if(dataBufMapPtr->dataBuf[dataBufEntry].blockingReqTail != REQ_SLOT_TAG_NONE)
+			SyncAllLowLevelReqDone();
 
-	if(virtualSliceAddr != VSA_FAIL)
+		memset((void*)(DATA_BUFFER_BASE_ADDR + dataBufEntry * BYTES_PER_DATA_REGION_OF_SLICE), 0, BYTES_PER_DATA_REGION_OF_SLICE);
+	}
+	else if(virtualSliceAddr != VSA_FAIL)
 	{
 		reqSlotTag = GetFromFreeReqQ();
 
 		reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
 		reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
 		reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag = reqPoolPtr->reqPool[originReqSlotTag].nvmeCmdSlotTag;
-		reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr = reqPoolPtr->reqPool[originReqSlotTag].logicalSliceAddr;
+		reqPoolPtr->reqColdPool[reqSlotTag].logicalSliceAddr = reqPoolPtr->reqColdPool[originReqSlotTag].logicalSliceAddr;
 		reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_ENTRY;
 		reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_VSA;
 		reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
@@ -221,16 +245,21 @@ void DataReadFromNand(unsigned int originReqSlotTag)
 
 void ReqTransSliceToLowLevel()
 {
-	unsigned int reqSlotTag, dataBufEntry;
+	unsigned int reqSlotTag, dataBufEntry, logicalSliceAddr, nvmeCmdSlotTag, write;
 
-	while(sliceReqQ.headReq != REQ_SLOT_TAG_NONE)
+	while(ReqRingCnt(sliceReqQ))
 	{
 		reqSlotTag = GetFromSliceReqQ();
 		if(reqSlotTag == REQ_SLOT_TAG_FAIL)
-			return ;
+			break;
+
+		//GC run while the slice is transformed is charged to its command
+		CmdLatencyTraceSetCurrent(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag);
 
 		//allocate a data buffer entry for this request
+		HotPathProfileBegin(HOT_PATH_PROFILE_STAGE_BUF_LOOKUP);
 		dataBufEntry = CheckDataBufHit(reqSlotTag);
+		HotPathProfileEnd(HOT_PATH_PROFILE_STAGE_BUF_LOOKUP);
 		if(dataBufEntry != DATA_BUF_FAIL)
 		{
 			//data buffer hit
@@ -246,13 +275,13 @@ void ReqTransSliceToLowLevel()
 			EvictDataBufEntry(reqSlotTag);
 
 			//update meta-data of the allocated data buffer entry
-			dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr = reqPoolPtr->reqPool[reqSlotTag].logicalSliceAddr;
+			dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr = reqPoolPtr->reqColdPool[reqSlotTag].logicalSliceAddr;
 			PutToDataBufHashList(dataBufEntry);
 
 			if(reqPoolPtr->reqPool[reqSlotTag].reqCode  == REQ_CODE_READ)
 				DataReadFromNand(reqSlotTag);
 			else if(reqPoolPtr->reqPool[reqSlotTag].reqCode  == REQ_CODE_WRITE)
-				if(reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock != NVME_BLOCKS_PER_SLICE) //for read modify write
+				if(reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock != NVME_BLOCKS_PER_SLICE) //for read modify write
 					DataReadFromNand(reqSlotTag);
 		}
 
@@ -271,10 +300,189 @@ void ReqTransSliceToLowLevel()
 		reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_ENTRY;
 
 		UpdateDataBufEntryInfoBlockingReq(dataBufEntry, reqSlotTag);
+
+		logicalSliceAddr = reqPoolPtr->reqColdPool[reqSlotTag].logicalSliceAddr;
+		nvmeCmdSlotTag = reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag;
+		write = (reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_RxDMA);
+
 		SelectLowLevelReqQ(reqSlotTag);
+
+		//zone slices are programmed in order as soon as the host fills them
+		if(write && IsZoneSlice(logicalSliceAddr) && !IsZoneWritePointerSlice(logicalSliceAddr))
+			FlushDataBufEntry(dataBufEntry, nvmeCmdSlotTag);
+	}
+
+	CmdLatencyTraceSetCurrent(NVME_CMD_SLOT_TAG_NONE);
+}
+
+void ReqTransPhyToLowLevel(unsigned int cmdSlotTag, unsigned int reqCode, unsigned int chNo, unsigned int wayNo, unsigned int blockNo, unsigned int pageNo, unsigned int dataBufAddr)
+{
+	unsigned int reqSlotTag;
+
+	reqSlotTag = GetFromFreeReqQ();
+
+	reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_NAND;
+	reqPoolPtr->reqPool[reqSlotTag].reqCode = reqCode;
+	reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag = cmdSlotTag;
+	reqPoolPtr->reqColdPool[reqSlotTag].logicalSliceAddr = LSA_NONE;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandAddr = REQ_OPT_NAND_ADDR_PHY_ORG;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEcc = REQ_OPT_NAND_ECC_ON;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.nandEccWarning = REQ_OPT_NAND_ECC_WARNING_ON;
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.blockSpace = REQ_OPT_BLOCK_SPACE_PHY_IO;
+
+	//the host orders accesses to its own blocks, the dependency table only tracks blocks of the FTL
+	reqPoolPtr->reqPool[reqSlotTag].reqOpt.rowAddrDependencyCheck = REQ_OPT_ROW_ADDR_DEPENDENCY_NONE;
+
+	if(reqCode == REQ_CODE_ERASE)
+		reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_NONE;
+	else
+	{
+		reqPoolPtr->reqPool[reqSlotTag].reqOpt.dataBufFormat = REQ_OPT_DATA_BUF_ADDR;
+		reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.addr = dataBufAddr;
+	}
+
+	reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalCh = chNo;
+	reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalWay = wayNo;
+	reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalBlock = blockNo;
+	//the host addresses the SLC pages of a block, they are the LSB pages of the MLC block
+	reqPoolPtr->reqPool[reqSlotTag].nandInfo.physicalPage = Vpage2PlsbPageTranslation(pageNo);
+
+	SelectLowLevelReqQ(reqSlotTag);
+}
+
+unsigned int ReqTransSliceToDataBuf(unsigned int cmdSlotTag, unsigned int logicalSliceAddr)
+{
+	unsigned int reqSlotTag, dataBufEntry;
+
+	//a slice request without NVMe DMA only stages the slice in the data buffer
+	reqSlotTag = GetFromFreeReqQ();
+
+	reqPoolPtr->reqPool[reqSlotTag].reqType = REQ_TYPE_SLICE;
+	reqPoolPtr->reqPool[reqSlotTag].reqCode = REQ_CODE_READ;
+	reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag = cmdSlotTag;
+	reqPoolPtr->reqColdPool[reqSlotTag].logicalSliceAddr = logicalSliceAddr;
+
+	HotPathProfileBegin(HOT_PATH_PROFILE_STAGE_BUF_LOOKUP);
+	dataBufEntry = CheckDataBufHit(reqSlotTag);
+	HotPathProfileEnd(HOT_PATH_PROFILE_STAGE_BUF_LOOKUP);
+	if((dataBufEntry == DATA_BUF_FAIL) && (AddrTransRead(logicalSliceAddr) != VSA_FAIL))
+	{
+		dataBufEntry = AllocateDataBuf();
+		reqPoolPtr->reqPool[reqSlotTag].dataBufInfo.entry = dataBufEntry;
+
+		EvictDataBufEntry(reqSlotTag);
+
+		dataBufMapPtr->dataBuf[dataBufEntry].logicalSliceAddr = logicalSliceAddr;
+		PutToDataBufHashList(dataBufEntry);
+
+		DataReadFromNand(reqSlotTag);
+	}
+
+	PutToFreeReqQ(reqSlotTag);
+
+	//unwritten slices are not staged
+	return dataBufEntry;
+}
+
+void ZeroNvmeBlocks(unsigned int cmdSlotTag, unsigned int startLba, unsigned int numOfNvmeBlock)
+{
+	unsigned int lba, endLba, logicalSliceAddr, nvmeBlockOffset, tempNumOfNvmeBlock, dataBufEntry, virtualSliceAddr;
+
+	//buffer entries are modified by the CPU, earlier requests on them must be done
+	SyncAllLowLevelReqDone();
+
+	lba = startLba;
+	endLba = startLba + numOfNvmeBlock;
+	while(lba < endLba)
+	{
+		logicalSliceAddr = lba / NVME_BLOCKS_PER_SLICE;
+		nvmeBlockOffset = lba % NVME_BLOCKS_PER_SLICE;
+		tempNumOfNvmeBlock = NVME_BLOCKS_PER_SLICE - nvmeBlockOffset;
+		if(tempNumOfNvmeBlock > endLba - lba)
+			tempNumOfNvmeBlock = endLba - lba;
+
+		dataBufEntry = FindDataBufEntry(logicalSliceAddr);
+		virtualSliceAddr = AddrTransRead(logicalSliceAddr);
+
+		if(tempNumOfNvmeBlock == NVME_BLOCKS_PER_SLICE)
+		{
+			//a whole slice is zeroed in the map only, a buffered copy must not be written back
+			if(dataBufEntry != DATA_BUF_NONE)
+			{
+				memset((void*)(DATA_BUFFER_BASE_ADDR + dataBufEntry * BYTES_PER_DATA_REGION_OF_SLICE), 0, BYTES_PER_DATA_REGION_OF_SLICE);
+				dataBufMapPtr->dataBuf[dataBufEntry].dirty = DATA_BUF_CLEAN;
+			}
+
+			AddrTransZero(logicalSliceAddr);
+		}
+		else if((dataBufEntry == DATA_BUF_NONE) && ((virtualSliceAddr == VSA_FAIL) || (virtualSliceAddr == VSA_ZERO)))
+		{
+			//the rest of an unwritten slice is undefined, so zeroes are a valid content
+			AddrTransZero(logicalSliceAddr);
+		}
+		else
+		{
+			//part of a slice holding data is zeroed in the data buffer
+			dataBufEntry = ReqTransSliceToDataBuf(cmdSlotTag, logicalSliceAddr);
+			SyncAllLowLevelReqDone();
+
+			memset((void*)(DATA_BUFFER_BASE_ADDR + dataBufEntry * BYTES_PER_DATA_REGION_OF_SLICE + nvmeBlockOffset * BYTES_PER_NVME_BLOCK), 0, tempNumOfNvmeBlock * BYTES_PER_NVME_BLOCK);
+			dataBufMapPtr->dataBuf[dataBufEntry].dirty = DATA_BUF_DIRTY;
+		}
+
+		lba += tempNumOfNvmeBlock;
 	}
 }
 
+unsigned int CompareNvmeBlocks(unsigned int cmdSlotTag, unsigned int startLba, unsigned int numOfNvmeBlock, unsigned int bufAddr)
+{
+	unsigned int dataBufEntry[COMPARE_SLICES_PER_PASS];
+	unsigned int lba, endLba, passEndLba, startLsa, sliceCnt, sliceIdx, nvmeBlockAddr, hostBlockAddr;
+
+	SyncAllLowLevelReqDone();
+
+	endLba = startLba + numOfNvmeBlock;
+	lba = startLba;
+	while(lba < endLba)
+	{
+		//the slices of a pass are read in parallel
+		startLsa = lba / NVME_BLOCKS_PER_SLICE;
+		sliceCnt = (endLba - 1) / NVME_BLOCKS_PER_SLICE - startLsa + 1;
+		if(sliceCnt > COMPARE_SLICES_PER_PASS)
+			sliceCnt = COMPARE_SLICES_PER_PASS;
+		passEndLba = (startLsa + sliceCnt) * NVME_BLOCKS_PER_SLICE;
+		if(passEndLba > endLba)
+			passEndLba = endLba;
+
+		for(sliceIdx = 0; sliceIdx < sliceCnt; sliceIdx++)
+			dataBufEntry[sliceIdx] = ReqTransSliceToDataBuf(cmdSlotTag, startLsa + sliceIdx);
+
+		SyncAllLowLevelReqDone();
+
+		for(; lba < passEndLba; lba++)
+		{
+			sliceIdx = lba / NVME_BLOCKS_PER_SLICE - startLsa;
+			hostBlockAddr = bufAddr + (lba - startLba) * BYTES_PER_NVME_BLOCK;
+
+			//unwritten blocks compare as zeroes
+			if(dataBufEntry[sliceIdx] == DATA_BUF_NONE)
+			{
+				for(nvmeBlockAddr = 0; nvmeBlockAddr < BYTES_PER_NVME_BLOCK; nvmeBlockAddr += sizeof(unsigned int))
+					if(*(unsigned int*)(hostBlockAddr + nvmeBlockAddr))
+						return SC_COMPARE_FAILURE;
+			}
+			else
+			{
+				nvmeBlockAddr = DATA_BUFFER_BASE_ADDR + dataBufEntry[sliceIdx] * BYTES_PER_DATA_REGION_OF_SLICE + (lba % NVME_BLOCKS_PER_SLICE) * BYTES_PER_NVME_BLOCK;
+				if(memcmp((void*)nvmeBlockAddr, (void*)hostBlockAddr, BYTES_PER_NVME_BLOCK))
+					return SC_COMPARE_FAILURE;
+			}
+		}
+	}
+
+	return SC_SUCCESSFUL_COMPLETION;
+}
+
 unsigned int CheckBufDep(unsigned int reqSlotTag)
 {
 	if(reqPoolPtr->reqPool[reqSlotTag].prevBlockingReq == REQ_SLOT_TAG_NONE)
@@ -474,6 +682,30 @@ void SelectLowLevelReqQ(unsigned int reqSlotTag)
 		assert(!"[WARNING] Not supported report [WARNING]");
 }
 
+unsigned int ReissueFailedProgram(unsigned int reqSlotTag)
+{
+	unsigned int logicalSliceAddr, virtualSliceAddr, newVirtualSliceAddr;
+
+	logicalSliceAddr = reqPoolPtr->reqColdPool[reqSlotTag].logicalSliceAddr;
+	virtualSliceAddr = reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr;
+
+	//the slice has been overwritten in the meantime, nothing to rescue
+	if((logicalSliceAddr >= SLICES_PER_SSD) || (logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr != virtualSliceAddr))
+		return 0;
+
+	InvalidateOldVsa(logicalSliceAddr);
+	newVirtualSliceAddr = FindFreeVirtualSliceForGc(Vsa2VdieTranslation(virtualSliceAddr), Vsa2VblockTranslation(virtualSliceAddr));
+
+	logicalSliceMapPtr->logicalSlice[logicalSliceAddr].virtualSliceAddr = newVirtualSliceAddr;
+	virtualSliceMapPtr->virtualSlice[newVirtualSliceAddr].logicalSliceAddr = logicalSliceAddr;
+
+	//the data is still in the buffer entry of the request, program it again at the new address
+	reqPoolPtr->reqPool[reqSlotTag].nandInfo.virtualSliceAddr = newVirtualSliceAddr;
+	SelectLowLevelReqQ(reqSlotTag);
+
+	return 1;
+}
+
 
 void ReleaseBlockedByBufDepReq(unsigned int reqSlotTag)
 {
@@ -574,37 +806,33 @@ void ReleaseBlockedByRowAddrDepReq(unsigned int chNo, unsigned int wayNo)
 
 void IssueNvmeDmaReq(unsigned int reqSlotTag)
 {
-	unsigned int devAddr, dmaIndex, numOfNvmeBlock;
+	unsigned int devAddr, dmaIndex, numOfNvmeBlock, autoCompletion;
 
-	dmaIndex = reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.startIndex;
+	dmaIndex = reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.startIndex;
 	devAddr = GenerateDataBufAddr(reqSlotTag);
-	numOfNvmeBlock = 0;
+
+	//a command returning command specific completion data is completed by firmware
+	if(deferredNvmeCplTable.cmdSlot[reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag].remainingNvmeBlock)
+		autoCompletion = NVME_COMMAND_AUTO_COMPLETION_OFF;
+	else
+		autoCompletion = NVME_COMMAND_AUTO_COMPLETION_ON;
+
+	//the blocks of a slice are pushed to the DMA FIFO in one pass
+	numOfNvmeBlock = reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock;
 
 	if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_RxDMA)
 	{
-		while(numOfNvmeBlock < reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock)
-		{
-			set_auto_rx_dma(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag, dmaIndex, devAddr, NVME_COMMAND_AUTO_COMPLETION_ON);
-
-			numOfNvmeBlock++;
-			dmaIndex++;
-			devAddr += BYTES_PER_NVME_BLOCK;
-		}
-		reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.reqTail = g_hostDmaStatus.fifoTail.autoDmaRx;
-		reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.overFlowCnt = g_hostDmaAssistStatus.autoDmaRxOverFlowCnt;
+		InvalidateDataBuf(devAddr, numOfNvmeBlock * BYTES_PER_NVME_BLOCK);
+		set_auto_rx_dma_range(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag, dmaIndex, devAddr, numOfNvmeBlock, autoCompletion);
+		reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.reqTail = g_hostDmaStatus.fifoTail.autoDmaRx;
+		reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.overFlowCnt = g_hostDmaAssistStatus.autoDmaRxOverFlowCnt;
 	}
 	else if(reqPoolPtr->reqPool[reqSlotTag].reqCode == REQ_CODE_TxDMA)
 	{
-		while(numOfNvmeBlock < reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock)
-		{
-			set_auto_tx_dma(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag, dmaIndex, devAddr, NVME_COMMAND_AUTO_COMPLETION_ON);
-
-			numOfNvmeBlock++;
-			dmaIndex++;
-			devAddr += BYTES_PER_NVME_BLOCK;
-		}
-		reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.reqTail =  g_hostDmaStatus.fifoTail.autoDmaTx;
-		reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.overFlowCnt = g_hostDmaAssistStatus.autoDmaTxOverFlowCnt;
+		FlushDataBuf(devAddr, numOfNvmeBlock * BYTES_PER_NVME_BLOCK);
+		set_auto_tx_dma_range(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag, dmaIndex, devAddr, numOfNvmeBlock, autoCompletion);
+		reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.reqTail =  g_hostDmaStatus.fifoTail.autoDmaTx;
+		reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.overFlowCnt = g_hostDmaAssistStatus.autoDmaTxOverFlowCnt;
 	}
 	else
 		assert(!"[WARNING] Not supported reqCode [WARNING]");
@@ -615,6 +843,8 @@ void CheckDoneNvmeDmaReq()
 	unsigned int reqSlotTag, prevReq;
 	unsigned int rxDone, txDone;
 
+	HotPathProfileBegin(HOT_PATH_PROFILE_STAGE_DMA_COMPLETION);
+
 	reqSlotTag = nvmeDmaReqQ.tailReq;
 	rxDone = 0;
 	txDone = 0;
@@ -626,23 +856,57 @@ void CheckDoneNvmeDmaReq()
 		if(reqPoolPtr->reqPool[reqSlotTag].reqCode  == REQ_CODE_RxDMA)
 		{
 			if(!rxDone)
-				rxDone = check_auto_rx_dma_partial_done(reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.reqTail , reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.overFlowCnt);
+				rxDone = check_auto_rx_dma_partial_done(reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.reqTail , reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.overFlowCnt);
 
 			if(rxDone)
+			{
+				InvalidateDataBuf(GenerateDataBufAddr(reqSlotTag), reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock * BYTES_PER_NVME_BLOCK);
+				UpdateDeferredNvmeCpl(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag, reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock);
+				CmdLatencyTraceDmaDone(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag, reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock);
 				SelectiveGetFromNvmeDmaReqQ(reqSlotTag);
+			}
 		}
 		else
 		{
 			if(!txDone)
-				txDone = check_auto_tx_dma_partial_done(reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.reqTail , reqPoolPtr->reqPool[reqSlotTag].nvmeDmaInfo.overFlowCnt);
+				txDone = check_auto_tx_dma_partial_done(reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.reqTail , reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.overFlowCnt);
 
 			if(txDone)
+			{
+				UpdateDeferredNvmeCpl(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag, reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock);
+				CmdLatencyTraceDmaDone(reqPoolPtr->reqPool[reqSlotTag].nvmeCmdSlotTag, reqPoolPtr->reqColdPool[reqSlotTag].nvmeDmaInfo.numOfNvmeBlock);
 				SelectiveGetFromNvmeDmaReqQ(reqSlotTag);
+			}
 		}
 
 		reqSlotTag = prevReq;
 	}
+
+	HotPathProfileEnd(HOT_PATH_PROFILE_STAGE_DMA_COMPLETION);
 }
 
+void InitDeferredNvmeCpl()
+{
+	unsigned int cmdSlotTag;
 
+	for(cmdSlotTag = 0; cmdSlotTag < (1 << P_SLOT_TAG_WIDTH); cmdSlotTag++)
+		deferredNvmeCplTable.cmdSlot[cmdSlotTag].remainingNvmeBlock = 0;
+}
+
+void SetDeferredNvmeCpl(unsigned int cmdSlotTag, unsigned int specific, unsigned int numOfNvmeBlock)
+{
+	deferredNvmeCplTable.cmdSlot[cmdSlotTag].specific = specific;
+	deferredNvmeCplTable.cmdSlot[cmdSlotTag].remainingNvmeBlock = numOfNvmeBlock;
+}
 
+void UpdateDeferredNvmeCpl(unsigned int cmdSlotTag, unsigned int numOfNvmeBlock)
+{
+	if(!deferredNvmeCplTable.cmdSlot[cmdSlotTag].remainingNvmeBlock)
+		return;
+
+	deferredNvmeCplTable.cmdSlot[cmdSlotTag].remainingNvmeBlock -= numOfNvmeBlock;
+
+	//all data of the command is transferred
+	if(!deferredNvmeCplTable.cmdSlot[cmdSlotTag].remainingNvmeBlock)
+		set_auto_nvme_cpl(cmdSlotTag, deferredNvmeCplTable.cmdSlot[cmdSlotTag].specific, 0);
+}
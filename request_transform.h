@@ -48,6 +48,7 @@
 
 #include "ftl_config.h"
 #include "nvme/nvme.h"
+#include "nvme/host_lld.h"
 
 #define NVME_COMMAND_AUTO_COMPLETION_OFF	0
 #define NVME_COMMAND_AUTO_COMPLETION_ON		1
@@ -58,6 +59,12 @@
 #define BUF_DEPENDENCY_REPORT_BLOCKED		0
 #define BUF_DEPENDENCY_REPORT_PASS			1
 
+//the spare region follows the data region of a buffer given by REQ_OPT_DATA_BUF_ADDR
+#define BYTES_PER_PHY_IO_DATA_BUFFER_ENTRY	(BYTES_PER_DATA_REGION_OF_SLICE + BYTES_PER_SPARE_REGION_OF_SLICE)
+
+#define COMPARE_BUFFER_SIZE					(MAX_NUM_OF_NLB * BYTES_PER_NVME_BLOCK)
+#define COMPARE_SLICES_PER_PASS				(8 * USER_DIES)	//half of the data buffer, staged slices of a pass are not evicted by each other
+
 #define ROW_ADDR_DEPENDENCY_REPORT_BLOCKED	0
 #define ROW_ADDR_DEPENDENCY_REPORT_PASS		1
 
@@ -76,16 +83,37 @@ typedef struct _ROW_ADDR_DEPENDENCY_TABLE {
 	ROW_ADDR_DEPENDENCY_ENTRY block[USER_CHANNELS][USER_WAYS][MAIN_BLOCKS_PER_DIE];
 } ROW_ADDR_DEPENDENCY_TABLE, *P_ROW_ADDR_DEPENDENCY_TABLE;
 
+//completion posted by firmware after the data transfer, for commands returning a value in DW0
+typedef struct _DEFERRED_NVME_CPL_ENTRY {
+	unsigned int specific;
+	unsigned int remainingNvmeBlock;
+} DEFERRED_NVME_CPL_ENTRY;
+
+typedef struct _DEFERRED_NVME_CPL_TABLE {
+	DEFERRED_NVME_CPL_ENTRY cmdSlot[1 << P_SLOT_TAG_WIDTH];
+} DEFERRED_NVME_CPL_TABLE;
+
 void InitDependencyTable();
 void ReqTransNvmeToSlice(unsigned int cmdSlotTag, unsigned int startLba, unsigned int nlb, unsigned int cmdCode);
 void ReqTransSliceToLowLevel();
+void ReqTransPhyToLowLevel(unsigned int cmdSlotTag, unsigned int reqCode, unsigned int chNo, unsigned int wayNo, unsigned int blockNo, unsigned int pageNo, unsigned int dataBufAddr);
+unsigned int ReqTransSliceToDataBuf(unsigned int cmdSlotTag, unsigned int logicalSliceAddr);
+void ZeroNvmeBlocks(unsigned int cmdSlotTag, unsigned int startLba, unsigned int numOfNvmeBlock);
+unsigned int CompareNvmeBlocks(unsigned int cmdSlotTag, unsigned int startLba, unsigned int numOfNvmeBlock, unsigned int bufAddr);
+void FlushDataBufEntry(unsigned int dataBufEntry, unsigned int nvmeCmdSlotTag);
 void IssueNvmeDmaReq(unsigned int reqSlotTag);
 void CheckDoneNvmeDmaReq();
 
 void SelectLowLevelReqQ(unsigned int reqSlotTag);
+unsigned int ReissueFailedProgram(unsigned int reqSlotTag);
 void ReleaseBlockedByBufDepReq(unsigned int reqSlotTag);
 void ReleaseBlockedByRowAddrDepReq(unsigned int chNo, unsigned int wayNo);
 
+void InitDeferredNvmeCpl();
+void SetDeferredNvmeCpl(unsigned int cmdSlotTag, unsigned int specific, unsigned int numOfNvmeBlock);
+void UpdateDeferredNvmeCpl(unsigned int cmdSlotTag, unsigned int numOfNvmeBlock);
+
 extern P_ROW_ADDR_DEPENDENCY_TABLE rowAddrDependencyTablePtr;
+extern DEFERRED_NVME_CPL_TABLE deferredNvmeCplTable;
 
 #endif /* REQUEST_TRANSFORM_H_ */
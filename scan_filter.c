@@ -0,0 +1,158 @@
+//////////////////////////////////////////////////////////////////////////////////
+// scan_filter.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Scan Filter
+// File Name: scan_filter.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - filter fixed size records of a logical block range in the data buffer
+//   - only matching records are transferred to the host
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "xil_printf.h"
+#include <assert.h>
+#include <string.h>
+#include "memory_map.h"
+
+unsigned int CheckScanPredicate(P_SCAN_PREDICATE predicate)
+{
+	//records do not straddle NVMe blocks, so a scan can resume at any block
+	if(!predicate->recordSize || (predicate->recordSize > BYTES_PER_NVME_BLOCK) || (BYTES_PER_NVME_BLOCK % predicate->recordSize))
+		return SC_INVALID_FIELD_IN_COMMAND;
+	if(!predicate->fieldSize || (predicate->fieldSize > SCAN_MAX_FIELD_SIZE))
+		return SC_INVALID_FIELD_IN_COMMAND;
+	if(predicate->fieldOffset + predicate->fieldSize > predicate->recordSize)
+		return SC_INVALID_FIELD_IN_COMMAND;
+	if(predicate->compareOp > SCAN_OP_GE)
+		return SC_INVALID_FIELD_IN_COMMAND;
+
+	return SC_SUCCESSFUL_COMPLETION;
+}
+
+unsigned int ScanFilter(unsigned int cmdSlotTag, unsigned int startLba, unsigned int numOfNvmeBlock, P_SCAN_PREDICATE predicate, unsigned int bufAddr, unsigned int bufSize)
+{
+	P_SCAN_RESULT_HEADER resultHeader;
+	unsigned int dataBufEntry[SCAN_SLICES_PER_ROUND];
+	unsigned int lba, endLba, startLsa, sliceCnt, sliceIdx, nvmeBlockAddr, recordOffset, resultOffset, blockResultOffset, blockMatchedCnt, bufferFull;
+
+	resultHeader = (P_SCAN_RESULT_HEADER) bufAddr;
+	resultHeader->matchedRecordCnt = 0;
+	resultHeader->scannedNvmeBlockCnt = 0;
+	resultOffset = sizeof(SCAN_RESULT_HEADER);
+	bufferFull = 0;
+
+	//writes of previous commands must have reached the data buffer
+	SyncAllLowLevelReqDone();
+
+	lba = startLba;
+	endLba = startLba + numOfNvmeBlock;
+	while((lba < endLba) && !bufferFull)
+	{
+		//a round of slices is read in parallel across the dies
+		startLsa = lba / NVME_BLOCKS_PER_SLICE;
+		sliceCnt = (endLba - 1) / NVME_BLOCKS_PER_SLICE - startLsa + 1;
+		if(sliceCnt > SCAN_SLICES_PER_ROUND)
+			sliceCnt = SCAN_SLICES_PER_ROUND;
+
+		for(sliceIdx = 0; sliceIdx < sliceCnt; sliceIdx++)
+			dataBufEntry[sliceIdx] = ReqTransSliceToDataBuf(cmdSlotTag, startLsa + sliceIdx);
+
+		SyncAllLowLevelReqDone();
+
+		for(sliceIdx = 0; (sliceIdx < sliceCnt) && !bufferFull; sliceIdx++)
+			while((lba < endLba) && (lba / NVME_BLOCKS_PER_SLICE == startLsa + sliceIdx))
+			{
+				//unwritten slices hold no records
+				if(dataBufEntry[sliceIdx] != DATA_BUF_NONE)
+				{
+					nvmeBlockAddr = DATA_BUFFER_BASE_ADDR + dataBufEntry[sliceIdx] * BYTES_PER_DATA_REGION_OF_SLICE + (lba % NVME_BLOCKS_PER_SLICE) * BYTES_PER_NVME_BLOCK;
+					blockResultOffset = resultOffset;
+					blockMatchedCnt = 0;
+
+					for(recordOffset = 0; recordOffset < BYTES_PER_NVME_BLOCK; recordOffset += predicate->recordSize)
+						if(MatchScanPredicate((unsigned char*)(nvmeBlockAddr + recordOffset), predicate))
+						{
+							//a block is reported as a whole or not at all
+							if(resultOffset + predicate->recordSize > bufSize)
+							{
+								resultOffset = blockResultOffset;
+								bufferFull = 1;
+								break;
+							}
+
+							memcpy((void*)(bufAddr + resultOffset), (void*)(nvmeBlockAddr + recordOffset), predicate->recordSize);
+							resultOffset += predicate->recordSize;
+							blockMatchedCnt++;
+						}
+
+					if(bufferFull)
+						break;
+
+					resultHeader->matchedRecordCnt += blockMatchedCnt;
+				}
+
+				resultHeader->scannedNvmeBlockCnt++;
+				lba++;
+			}
+	}
+
+	return resultOffset;
+}
+
+unsigned int MatchScanPredicate(unsigned char* record, P_SCAN_PREDICATE predicate)
+{
+	unsigned int fieldValue, byteIdx;
+
+	fieldValue = 0;
+	for(byteIdx = 0; byteIdx < predicate->fieldSize; byteIdx++)
+		fieldValue |= (unsigned int)record[predicate->fieldOffset + byteIdx] << (byteIdx * 8);
+
+	switch(predicate->compareOp)
+	{
+		case SCAN_OP_EQ:
+			return (fieldValue == predicate->value);
+		case SCAN_OP_NE:
+			return (fieldValue != predicate->value);
+		case SCAN_OP_LT:
+			return (fieldValue < predicate->value);
+		case SCAN_OP_LE:
+			return (fieldValue <= predicate->value);
+		case SCAN_OP_GT:
+			return (fieldValue > predicate->value);
+		case SCAN_OP_GE:
+			return (fieldValue >= predicate->value);
+		default:
+			assert(!"[WARNING] Not supported compare operator [WARNING]");
+	}
+
+	return 0;
+}
@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////////////////////
+// scan_filter.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Scan Filter
+// File Name: scan_filter.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - define parameters, data structure and functions of scan filter
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SCAN_FILTER_H_
+#define SCAN_FILTER_H_
+
+#include "ftl_config.h"
+#include "data_buffer.h"
+#include "nvme/nvme.h"
+
+#define SCAN_OP_EQ						0x0
+#define SCAN_OP_NE						0x1
+#define SCAN_OP_LT						0x2
+#define SCAN_OP_LE						0x3
+#define SCAN_OP_GT						0x4
+#define SCAN_OP_GE						0x5
+
+#define SCAN_MAX_FIELD_SIZE				4
+#define SCAN_SLICES_PER_ROUND			(AVAILABLE_DATA_BUFFER_ENTRY_COUNT / 4)	//slices staged in the data buffer at once
+
+#define SCAN_RESULT_BUFFER_SIZE			(MAX_NUM_OF_NLB * BYTES_PER_NVME_BLOCK)
+
+typedef struct _SCAN_PREDICATE {
+	unsigned int recordSize;
+	unsigned int fieldOffset;
+	unsigned int fieldSize;
+	unsigned int compareOp;
+	unsigned int value;
+} SCAN_PREDICATE, *P_SCAN_PREDICATE;
+
+//the result buffer starts with this header, matching records follow back to back
+typedef struct _SCAN_RESULT_HEADER {
+	unsigned int matchedRecordCnt;
+	unsigned int scannedNvmeBlockCnt;	//the scan resumes from here when the result buffer is full
+	unsigned int reserved0[2];
+} SCAN_RESULT_HEADER, *P_SCAN_RESULT_HEADER;
+
+unsigned int CheckScanPredicate(P_SCAN_PREDICATE predicate);
+unsigned int ScanFilter(unsigned int cmdSlotTag, unsigned int startLba, unsigned int numOfNvmeBlock, P_SCAN_PREDICATE predicate, unsigned int bufAddr, unsigned int bufSize);
+unsigned int MatchScanPredicate(unsigned char* record, P_SCAN_PREDICATE predicate);
+
+#endif /* SCAN_FILTER_H_ */
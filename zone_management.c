@@ -0,0 +1,450 @@
+//////////////////////////////////////////////////////////////////////////////////
+// zone_management.c for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Zone Manager
+// File Name: zone_management.c
+//
+// Version: v1.0.0
+//
+// Description:
+//   - expose a namespace as sequential write required zones, each backed by one virtual block
+//   - track write pointers and zone states, and translate zone slices without the logical slice map
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "xil_printf.h"
+#include <assert.h>
+#include <string.h>
+#include "memory_map.h"
+
+P_ZONE_MAP zoneMapPtr;
+
+void InitZoneMap()
+{
+	unsigned int zoneNo;
+
+	zoneMapPtr = (P_ZONE_MAP) ZONE_MAP_ADDR;
+
+	//the tail of the namespace smaller than a zone is not exposed
+	if(ZONED_NAMESPACE_ID)
+		zoneMapPtr->zoneCnt = (storageCapacity_L / USER_NAMESPACES) / NVME_BLOCKS_PER_ZONE;
+	else
+		zoneMapPtr->zoneCnt = 0;
+	zoneMapPtr->activeZoneCnt = 0;
+
+	for(zoneNo = 0; zoneNo < MAX_ZONES_PER_NAMESPACE; zoneNo++)
+	{
+		zoneMapPtr->zone[zoneNo].state = ZONE_STATE_EMPTY;
+		zoneMapPtr->zone[zoneNo].dieNo = DIE_NONE;
+		zoneMapPtr->zone[zoneNo].blockNo = BLOCK_NONE;
+		zoneMapPtr->zone[zoneNo].writePointer = 0;
+	}
+
+	if(zoneMapPtr->zoneCnt)
+		xil_printf("[ namespace %d is zoned: %d zones of %d MB ]\r\n", ZONED_NAMESPACE_ID, zoneMapPtr->zoneCnt, MB_PER_BLOCK);
+}
+
+unsigned int IsZoneSlice(unsigned int logicalSliceAddr)
+{
+	if(!zoneMapPtr->zoneCnt || (logicalSliceAddr < ZONED_NAMESPACE_START_LSA))
+		return 0;
+
+	return (Lsa2ZoneTranslation(logicalSliceAddr) < zoneMapPtr->zoneCnt);
+}
+
+unsigned int IsZoneWritePointerSlice(unsigned int logicalSliceAddr)
+{
+	P_ZONE_ENTRY zone;
+
+	if(!IsZoneSlice(logicalSliceAddr))
+		return 0;
+
+	zone = &zoneMapPtr->zone[Lsa2ZoneTranslation(logicalSliceAddr)];
+	if((zone->state != ZONE_STATE_IMPLICIT_OPEN) && (zone->state != ZONE_STATE_EXPLICIT_OPEN) && (zone->state != ZONE_STATE_CLOSED))
+		return 0;
+
+	//a slice partially filled by the host, the rest of it comes with the next write to the zone
+	return (Lsa2ZoneSliceTranslation(logicalSliceAddr) == (zone->writePointer / NVME_BLOCKS_PER_SLICE)) && (zone->writePointer % NVME_BLOCKS_PER_SLICE);
+}
+
+unsigned int ZoneAddrTransRead(unsigned int logicalSliceAddr)
+{
+	P_ZONE_ENTRY zone;
+	unsigned int virtualSliceAddr;
+
+	zone = &zoneMapPtr->zone[Lsa2ZoneTranslation(logicalSliceAddr)];
+	if(zone->blockNo == BLOCK_NONE)
+		return VSA_FAIL;
+
+	//slices of a zone sit at the same offset in its block, only programmed ones are mapped back
+	virtualSliceAddr = Vorg2VsaTranslation(zone->dieNo, zone->blockNo, Lsa2ZoneSliceTranslation(logicalSliceAddr));
+	if(virtualSliceMapPtr->virtualSlice[virtualSliceAddr].logicalSliceAddr != logicalSliceAddr)
+		return VSA_FAIL;
+
+	return virtualSliceAddr;
+}
+
+unsigned int ZoneAddrTransWrite(unsigned int logicalSliceAddr)
+{
+	P_ZONE_ENTRY zone;
+	unsigned int virtualSliceAddr, pageNo;
+
+	zone = &zoneMapPtr->zone[Lsa2ZoneTranslation(logicalSliceAddr)];
+	if(zone->blockNo == BLOCK_NONE)
+		assert(!"[WARNING] Zone has no block [WARNING]");
+
+	pageNo = Lsa2ZoneSliceTranslation(logicalSliceAddr);
+	if(pageNo != virtualBlockMapPtr->block[zone->dieNo][zone->blockNo].currentPage)
+		assert(!"[WARNING] Zone is not programmed in order [WARNING]");
+
+	virtualSliceAddr = Vorg2VsaTranslation(zone->dieNo, zone->blockNo, pageNo);
+	virtualSliceMapPtr->virtualSlice[virtualSliceAddr].logicalSliceAddr = logicalSliceAddr;
+	virtualBlockMapPtr->block[zone->dieNo][zone->blockNo].currentPage++;
+
+	return virtualSliceAddr;
+}
+
+unsigned int CheckZoneWrite(unsigned int startLba, unsigned int nlb, unsigned int append, unsigned int* writeLba)
+{
+	P_ZONE_ENTRY zone;
+	unsigned int zoneNo, requestedNvmeBlock, statusCode;
+
+	requestedNvmeBlock = nlb + 1;
+	zoneNo = startLba / NVME_BLOCKS_PER_ZONE;
+
+	if(zoneNo >= zoneMapPtr->zoneCnt)
+		return SC_LBA_OUT_OF_RANGE;
+	if(append && (startLba % NVME_BLOCKS_PER_ZONE))
+		return SC_INVALID_FIELD_IN_COMMAND;
+
+	zone = &zoneMapPtr->zone[zoneNo];
+	if(zone->state == ZONE_STATE_FULL)
+		return SC_ZONE_IS_FULL;
+	if(zone->state == ZONE_STATE_READ_ONLY)
+		return SC_ZONE_IS_READ_ONLY;
+	if(zone->state == ZONE_STATE_OFFLINE)
+		return SC_ZONE_IS_OFFLINE;
+
+	if(!append && ((startLba % NVME_BLOCKS_PER_ZONE) != zone->writePointer))
+		return SC_ZONE_INVALID_WRITE;
+	if(zone->writePointer + requestedNvmeBlock > NVME_BLOCKS_PER_ZONE)
+		return SC_ZONE_BOUNDARY_ERROR;
+
+	if(zone->state == ZONE_STATE_EMPTY)
+	{
+		statusCode = AllocateZoneBlock(zoneNo);
+		if(statusCode != SC_SUCCESSFUL_COMPLETION)
+			return statusCode;
+	}
+	if(zone->state != ZONE_STATE_EXPLICIT_OPEN)
+		zone->state = ZONE_STATE_IMPLICIT_OPEN;
+
+	*writeLba = zoneNo * NVME_BLOCKS_PER_ZONE + zone->writePointer;
+	zone->writePointer += requestedNvmeBlock;
+
+	if(zone->writePointer == NVME_BLOCKS_PER_ZONE)
+	{
+		zone->state = ZONE_STATE_FULL;
+		zoneMapPtr->activeZoneCnt--;
+	}
+
+	return SC_SUCCESSFUL_COMPLETION;
+}
+
+unsigned int ZoneManagementSend(unsigned int cmdSlotTag, unsigned int startLba, unsigned int action, unsigned int selectAll)
+{
+	unsigned int zoneNo, state, selected;
+
+	if((action < ZONE_SEND_ACTION_CLOSE) || (action > ZONE_SEND_ACTION_OFFLINE))
+		return SC_INVALID_FIELD_IN_COMMAND;
+
+	if(selectAll)
+	{
+		//zones in states the action does not apply to are skipped without an error
+		for(zoneNo = 0; zoneNo < zoneMapPtr->zoneCnt; zoneNo++)
+		{
+			state = zoneMapPtr->zone[zoneNo].state;
+
+			if(action == ZONE_SEND_ACTION_CLOSE)
+				selected = (state == ZONE_STATE_IMPLICIT_OPEN) || (state == ZONE_STATE_EXPLICIT_OPEN);
+			else if((action == ZONE_SEND_ACTION_FINISH) || (action == ZONE_SEND_ACTION_RESET))
+				selected = (state == ZONE_STATE_IMPLICIT_OPEN) || (state == ZONE_STATE_EXPLICIT_OPEN) || (state == ZONE_STATE_CLOSED) || ((action == ZONE_SEND_ACTION_RESET) && (state == ZONE_STATE_FULL));
+			else if(action == ZONE_SEND_ACTION_OPEN)
+				selected = (state == ZONE_STATE_CLOSED);
+			else
+				selected = (state == ZONE_STATE_READ_ONLY);
+
+			if(selected)
+				ChangeZoneState(cmdSlotTag, zoneNo, action);
+		}
+
+		return SC_SUCCESSFUL_COMPLETION;
+	}
+
+	zoneNo = startLba / NVME_BLOCKS_PER_ZONE;
+	if(zoneNo >= zoneMapPtr->zoneCnt)
+		return SC_LBA_OUT_OF_RANGE;
+	if(startLba % NVME_BLOCKS_PER_ZONE)
+		return SC_INVALID_FIELD_IN_COMMAND;
+
+	return ChangeZoneState(cmdSlotTag, zoneNo, action);
+}
+
+unsigned int ChangeZoneState(unsigned int cmdSlotTag, unsigned int zoneNo, unsigned int action)
+{
+	P_ZONE_ENTRY zone;
+	unsigned int statusCode, active;
+
+	zone = &zoneMapPtr->zone[zoneNo];
+	active = (zone->state == ZONE_STATE_IMPLICIT_OPEN) || (zone->state == ZONE_STATE_EXPLICIT_OPEN) || (zone->state == ZONE_STATE_CLOSED);
+
+	if(action == ZONE_SEND_ACTION_CLOSE)
+	{
+		if(!active)
+			return SC_INVALID_ZONE_STATE_TRANSITION;
+
+		zone->state = ZONE_STATE_CLOSED;
+	}
+	else if(action == ZONE_SEND_ACTION_FINISH)
+	{
+		if(active)
+		{
+			//the partial slice is programmed as it is, the rest of the zone is left unwritten
+			FlushZoneWritePointerSlice(cmdSlotTag, zoneNo);
+			zoneMapPtr->activeZoneCnt--;
+		}
+		else if((zone->state != ZONE_STATE_EMPTY) && (zone->state != ZONE_STATE_FULL))
+			return SC_INVALID_ZONE_STATE_TRANSITION;
+
+		zone->state = ZONE_STATE_FULL;
+		zone->writePointer = NVME_BLOCKS_PER_ZONE;
+	}
+	else if(action == ZONE_SEND_ACTION_OPEN)
+	{
+		if(zone->state == ZONE_STATE_EMPTY)
+		{
+			statusCode = AllocateZoneBlock(zoneNo);
+			if(statusCode != SC_SUCCESSFUL_COMPLETION)
+				return statusCode;
+		}
+		else if(!active)
+			return SC_INVALID_ZONE_STATE_TRANSITION;
+
+		zone->state = ZONE_STATE_EXPLICIT_OPEN;
+	}
+	else if(action == ZONE_SEND_ACTION_RESET)
+	{
+		if(zone->state == ZONE_STATE_EMPTY)
+			return SC_SUCCESSFUL_COMPLETION;
+		if((zone->state == ZONE_STATE_READ_ONLY) || (zone->state == ZONE_STATE_OFFLINE))
+			return SC_INVALID_ZONE_STATE_TRANSITION;
+
+		if(active)
+			zoneMapPtr->activeZoneCnt--;
+
+		DropZoneDataBufEntries(zoneNo);
+
+		//the block goes back to the free block pool shared with conventional namespaces
+		if(zone->blockNo != BLOCK_NONE)
+		{
+			virtualBlockMapPtr->block[zone->dieNo][zone->blockNo].zone = 0;
+			EraseBlock(zone->dieNo, zone->blockNo);
+		}
+
+		zone->state = ZONE_STATE_EMPTY;
+		zone->dieNo = DIE_NONE;
+		zone->blockNo = BLOCK_NONE;
+		zone->writePointer = 0;
+	}
+	else if(action == ZONE_SEND_ACTION_OFFLINE)
+	{
+		if(zone->state == ZONE_STATE_OFFLINE)
+			return SC_SUCCESSFUL_COMPLETION;
+		if(zone->state != ZONE_STATE_READ_ONLY)
+			return SC_INVALID_ZONE_STATE_TRANSITION;
+
+		DropZoneDataBufEntries(zoneNo);
+
+		//erasing the failed block swaps it with a spare block or retires it
+		virtualBlockMapPtr->block[zone->dieNo][zone->blockNo].zone = 0;
+		EraseBlock(zone->dieNo, zone->blockNo);
+
+		zone->state = ZONE_STATE_OFFLINE;
+		zone->dieNo = DIE_NONE;
+		zone->blockNo = BLOCK_NONE;
+		zone->writePointer = 0;
+	}
+	else
+		return SC_INVALID_FIELD_IN_COMMAND;
+
+	return SC_SUCCESSFUL_COMPLETION;
+}
+
+unsigned int AllocateZoneBlock(unsigned int zoneNo)
+{
+	P_ZONE_ENTRY zone;
+	unsigned int dieNo, blockNo;
+
+	if(zoneMapPtr->activeZoneCnt >= MAX_ACTIVE_ZONES)
+		return SC_TOO_MANY_ACTIVE_ZONES;
+
+	dieNo = FindDieForFreeSliceAllocation(ZONED_NAMESPACE_ID - 1);
+	blockNo = GetFromFbList(dieNo, GET_FREE_BLOCK_NORMAL);
+	if(blockNo == BLOCK_FAIL)
+		return SC_CAPACITY_EXCEEDED;
+
+	virtualBlockMapPtr->block[dieNo][blockNo].zone = 1;
+
+	zone = &zoneMapPtr->zone[zoneNo];
+	zone->dieNo = dieNo;
+	zone->blockNo = blockNo;
+	zone->writePointer = 0;
+	zoneMapPtr->activeZoneCnt++;
+
+	return SC_SUCCESSFUL_COMPLETION;
+}
+
+void FlushZoneWritePointerSlice(unsigned int cmdSlotTag, unsigned int zoneNo)
+{
+	unsigned int bufEntry, logicalSliceAddr;
+
+	if(!(zoneMapPtr->zone[zoneNo].writePointer % NVME_BLOCKS_PER_SLICE))
+		return;
+
+	logicalSliceAddr = ZONED_NAMESPACE_START_LSA + zoneNo * SLICES_PER_ZONE + zoneMapPtr->zone[zoneNo].writePointer / NVME_BLOCKS_PER_SLICE;
+
+	for(bufEntry = 0; bufEntry < AVAILABLE_DATA_BUFFER_ENTRY_COUNT; bufEntry++)
+		if(dataBufMapPtr->dataBuf[bufEntry].logicalSliceAddr == logicalSliceAddr)
+		{
+			FlushDataBufEntry(bufEntry, cmdSlotTag);
+			return;
+		}
+}
+
+void DropZoneDataBufEntries(unsigned int zoneNo)
+{
+	unsigned int bufEntry, startLsa, logicalSliceAddr;
+
+	//no request may still move data in or out of the entries
+	SyncAllLowLevelReqDone();
+
+	startLsa = ZONED_NAMESPACE_START_LSA + zoneNo * SLICES_PER_ZONE;
+	for(bufEntry = 0; bufEntry < AVAILABLE_DATA_BUFFER_ENTRY_COUNT; bufEntry++)
+	{
+		logicalSliceAddr = dataBufMapPtr->dataBuf[bufEntry].logicalSliceAddr;
+
+		if((logicalSliceAddr != LSA_NONE) && (logicalSliceAddr >= startLsa) && (logicalSliceAddr < startLsa + SLICES_PER_ZONE))
+		{
+			SelectiveGetFromDataBufHashList(bufEntry);
+			dataBufMapPtr->dataBuf[bufEntry].logicalSliceAddr = LSA_NONE;
+			dataBufMapPtr->dataBuf[bufEntry].dirty = DATA_BUF_CLEAN;
+		}
+	}
+}
+
+unsigned int MakeZoneReport(unsigned int startLba, unsigned int reportOption, unsigned int partial, unsigned int bufAddr, unsigned int bufSize)
+{
+	ZONE_REPORT_HEADER* reportHeader;
+	ZONE_DESCRIPTOR* zoneDesc;
+	P_ZONE_ENTRY zone;
+	unsigned int zoneNo, matchedZoneCnt, descCnt, maxDescCnt, zoneStartLba;
+	unsigned char reportState[ZONE_REPORT_OFFLINE + 1] = {0, ZONE_STATE_EMPTY, ZONE_STATE_IMPLICIT_OPEN, ZONE_STATE_EXPLICIT_OPEN,
+			ZONE_STATE_CLOSED, ZONE_STATE_FULL, ZONE_STATE_READ_ONLY, ZONE_STATE_OFFLINE};
+
+	zoneNo = startLba / NVME_BLOCKS_PER_ZONE;
+	if(zoneNo >= zoneMapPtr->zoneCnt)
+		return SC_LBA_OUT_OF_RANGE;
+	if(reportOption > ZONE_REPORT_OFFLINE)
+		return SC_INVALID_FIELD_IN_COMMAND;
+
+	memset((void*)bufAddr, 0, bufSize);
+	reportHeader = (ZONE_REPORT_HEADER*)bufAddr;
+
+	if(bufSize > sizeof(ZONE_REPORT_HEADER))
+		maxDescCnt = (bufSize - sizeof(ZONE_REPORT_HEADER)) / sizeof(ZONE_DESCRIPTOR);
+	else
+		maxDescCnt = 0;
+
+	matchedZoneCnt = 0;
+	descCnt = 0;
+	for( ; zoneNo < zoneMapPtr->zoneCnt; zoneNo++)
+	{
+		zone = &zoneMapPtr->zone[zoneNo];
+		if((reportOption != ZONE_REPORT_ALL) && (zone->state != reportState[reportOption]))
+			continue;
+
+		matchedZoneCnt++;
+
+		if(descCnt < maxDescCnt)
+		{
+			zoneStartLba = zoneNo * NVME_BLOCKS_PER_ZONE;
+			zoneDesc = (ZONE_DESCRIPTOR*)(bufAddr + sizeof(ZONE_REPORT_HEADER) + descCnt * sizeof(ZONE_DESCRIPTOR));
+
+			zoneDesc->ZT = ZONE_TYPE_SEQUENTIAL_WRITE_REQUIRED;
+			zoneDesc->ZS = zone->state << 4;
+			zoneDesc->ZCAP[0] = NVME_BLOCKS_PER_ZONE;
+			zoneDesc->ZSLBA[0] = zoneStartLba;
+			zoneDesc->WP[0] = zoneStartLba + zone->writePointer;
+			descCnt++;
+		}
+		else if(partial)
+			break;
+	}
+
+	//the partial report counts only the zones described in the data
+	if(partial)
+		reportHeader->NZ[0] = descCnt;
+	else
+		reportHeader->NZ[0] = matchedZoneCnt;
+
+	return SC_SUCCESSFUL_COMPLETION;
+}
+
+void RetireZoneBlock(unsigned int dieNo, unsigned int blockNo)
+{
+	P_ZONE_ENTRY zone;
+	unsigned int zoneNo;
+
+	for(zoneNo = 0; zoneNo < zoneMapPtr->zoneCnt; zoneNo++)
+	{
+		zone = &zoneMapPtr->zone[zoneNo];
+
+		if((zone->dieNo == dieNo) && (zone->blockNo == blockNo))
+		{
+			if((zone->state == ZONE_STATE_IMPLICIT_OPEN) || (zone->state == ZONE_STATE_EXPLICIT_OPEN) || (zone->state == ZONE_STATE_CLOSED))
+				zoneMapPtr->activeZoneCnt--;
+
+			//written data stays readable, the host moves it out and takes the zone offline
+			zone->state = ZONE_STATE_READ_ONLY;
+
+			xil_printf("Zone %d on Ch %d Way %d virtualBlock %d is read only \r\n", zoneNo, Vdie2PchTranslation(dieNo), Vdie2PwayTranslation(dieNo), blockNo);
+			return;
+		}
+	}
+}
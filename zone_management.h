@@ -0,0 +1,122 @@
+//////////////////////////////////////////////////////////////////////////////////
+// zone_management.h for Cosmos+ OpenSSD
+//
+// This file is part of Cosmos+ OpenSSD.
+//
+// Cosmos+ OpenSSD is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// Cosmos+ OpenSSD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Cosmos+ OpenSSD; see the file COPYING.
+// If not, see <http://www.gnu.org/licenses/>.
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Project Name: Cosmos+ OpenSSD
+// Design Name: Cosmos+ Firmware
+// Module Name: Zone Manager
+// File Name: zone_management.h
+//
+// Version: v1.0.0
+//
+// Description:
+//   - define parameters, data structure and functions of zone manager
+//////////////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////////////
+// Revision History:
+//
+// * v1.0.0
+//   - First draft
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ZONE_MANAGEMENT_H_
+#define ZONE_MANAGEMENT_H_
+
+#include "ftl_config.h"
+#include "data_buffer.h"
+#include "nvme/nvme.h"
+#include "nvme/host_lld.h"
+
+#define ZONE_STATE_EMPTY				0x1
+#define ZONE_STATE_IMPLICIT_OPEN		0x2
+#define ZONE_STATE_EXPLICIT_OPEN		0x3
+#define ZONE_STATE_CLOSED				0x4
+#define ZONE_STATE_READ_ONLY			0xD
+#define ZONE_STATE_FULL					0xE
+#define ZONE_STATE_OFFLINE				0xF
+
+#define ZONE_TYPE_SEQUENTIAL_WRITE_REQUIRED		0x2
+
+#define ZONE_SEND_ACTION_CLOSE			0x1
+#define ZONE_SEND_ACTION_FINISH			0x2
+#define ZONE_SEND_ACTION_OPEN			0x3
+#define ZONE_SEND_ACTION_RESET			0x4
+#define ZONE_SEND_ACTION_OFFLINE		0x5
+
+#define ZONE_RECV_ACTION_REPORT_ZONES	0x0
+
+#define ZONE_REPORT_ALL					0x0
+#define ZONE_REPORT_EMPTY				0x1
+#define ZONE_REPORT_IMPLICIT_OPEN		0x2
+#define ZONE_REPORT_EXPLICIT_OPEN		0x3
+#define ZONE_REPORT_CLOSED				0x4
+#define ZONE_REPORT_FULL				0x5
+#define ZONE_REPORT_READ_ONLY			0x6
+#define ZONE_REPORT_OFFLINE				0x7
+
+#define SLICES_PER_ZONE					(SLICES_PER_BLOCK)		//a zone is backed by one virtual block
+#define NVME_BLOCKS_PER_ZONE			(SLICES_PER_ZONE * NVME_BLOCKS_PER_SLICE)
+#define MAX_ZONES_PER_NAMESPACE			(SLICES_PER_SSD / USER_NAMESPACES / SLICES_PER_ZONE)
+#define MAX_ACTIVE_ZONES				(AVAILABLE_DATA_BUFFER_ENTRY_COUNT / 2)	//an active zone may pin its write pointer slice in the data buffer
+#define MAX_OPEN_ZONES					(MAX_ACTIVE_ZONES)
+
+#define ZONE_REPORT_BUFFER_SIZE			(MAX_NUM_OF_NLB * BYTES_PER_NVME_BLOCK)
+
+// logical slice address to zone translation
+#define ZONED_NAMESPACE_START_LSA		((ZONED_NAMESPACE_ID - 1) * (SLICES_PER_NAMESPACE))
+#define Lsa2ZoneTranslation(logicalSliceAddr) (((logicalSliceAddr) - (ZONED_NAMESPACE_START_LSA)) / (SLICES_PER_ZONE))
+#define Lsa2ZoneSliceTranslation(logicalSliceAddr) (((logicalSliceAddr) - (ZONED_NAMESPACE_START_LSA)) % (SLICES_PER_ZONE))
+
+typedef struct _ZONE_ENTRY {
+	unsigned int state : 4;
+	unsigned int dieNo : 8;
+	unsigned int blockNo : 16;
+	unsigned int reserved0 : 4;
+	unsigned int writePointer;		//NVMe blocks written from the start of the zone
+} ZONE_ENTRY, *P_ZONE_ENTRY;
+
+typedef struct _ZONE_MAP {
+	ZONE_ENTRY zone[MAX_ZONES_PER_NAMESPACE];
+	unsigned int zoneCnt;
+	unsigned int activeZoneCnt;		//open and closed zones
+} ZONE_MAP, *P_ZONE_MAP;
+
+void InitZoneMap();
+unsigned int IsZoneSlice(unsigned int logicalSliceAddr);
+unsigned int IsZoneWritePointerSlice(unsigned int logicalSliceAddr);
+
+unsigned int ZoneAddrTransRead(unsigned int logicalSliceAddr);
+unsigned int ZoneAddrTransWrite(unsigned int logicalSliceAddr);
+
+unsigned int CheckZoneWrite(unsigned int startLba, unsigned int nlb, unsigned int append, unsigned int* writeLba);
+unsigned int ZoneManagementSend(unsigned int cmdSlotTag, unsigned int startLba, unsigned int action, unsigned int selectAll);
+unsigned int ChangeZoneState(unsigned int cmdSlotTag, unsigned int zoneNo, unsigned int action);
+unsigned int AllocateZoneBlock(unsigned int zoneNo);
+void FlushZoneWritePointerSlice(unsigned int cmdSlotTag, unsigned int zoneNo);
+void DropZoneDataBufEntries(unsigned int zoneNo);
+unsigned int MakeZoneReport(unsigned int startLba, unsigned int reportOption, unsigned int partial, unsigned int bufAddr, unsigned int bufSize);
+
+void RetireZoneBlock(unsigned int dieNo, unsigned int blockNo);
+
+extern P_ZONE_MAP zoneMapPtr;
+
+#endif /* ZONE_MANAGEMENT_H_ */